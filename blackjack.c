@@ -4,11 +4,20 @@
  * Statistics: Press Right on result screen to view win/loss stats.
  */
 #include <furi.h>
+#include <furi_hal.h>
 #include <gui/gui.h>
 #include <gui/view.h>
 #include <gui/view_dispatcher.h>
 #include <storage/storage.h>
 #include <notification/notification.h>
+#include "blackjack_game.h"
+#include "blackjack_strategy.h"
+#include "blackjack_ev.h"
+#include "blackjack_practice.h"
+#include "blackjack_store.h"
+#include "blackjack_sprites.h"
+#include "blackjack_lock_stats.h"
+#include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -88,218 +97,37 @@ static void blackjack_notify_sound_stand(bool sound_on) {
     }
 }
 
-#define TAG "blackjack"
-#define MAX_HAND 6
-#define MAX_SPLIT_HANDS 2  /* Maximum number of hands after split */
-#define DECKS 3
-#define DECK_SIZE (52 * DECKS)  /* 3 deck shoe = 156 cards */
-#define BURN_TOP 1  /* Burn top card */
-#define BURN_BOTTOM 20  /* Burn bottom 20 cards */
-#define CARD_VALUE(c) ((c) % 13)   /* 0=2, 1=3, ..., 9=10, 10=J, 11=Q, 12=K, (12 or 0 for A in rank) */
-#define CARD_SUIT(c) ((c) / 13)    /* 0=S, 1=H, 2=D, 3=C */
-#define CARD_RANK(c) ((c) % 13)    /* Get card rank (0-12) for pair detection */
+/* Play GameEvent feedback taken from the model by blackjack_take_events */
+static void blackjack_play_feedback(uint8_t feedback) {
+    blackjack_notify_sound_hit(feedback & GameEventHit);
+    blackjack_notify_sound_stand(feedback & GameEventStand);
+    blackjack_notify_vibro(feedback & GameEventBlackjack);
+}
 
-typedef enum {
-    PhaseSplash,
-    PhaseProfileMenu,
-    PhaseBetting,
-    PhaseDeal,
-    PhasePlayerTurn,
-    PhaseSplitPrompt,
-    PhaseInsurancePrompt,  /* Dealer Ace up: Insurance? Yes/No */
-    PhaseDealerTurn,
-    PhaseShowFinalCards,
-    PhaseResult,
-    PhaseStatistics,
-    PhaseHelp,
-    PhaseReshuffle,
-    PhaseGuestSavePrompt,  /* Guest: Save to profile? Yes/No */
-    PhaseGuestPickProfile, /* Guest: pick slot to save to */
-    PhaseSettings,         /* Sound, Vibro, Dealer S17, Erase all */
-    PhaseConfirmErase     /* Confirm erase all profiles */
-} GamePhase;
-
-#define STARTING_BALANCE 3125
-#define MIN_BET 5
-#define MAX_BET 500
-#define BET_INCREMENT 5
-#define MAX_PROFILES 4
-#define PROFILE_NAME_LEN 17
-#define BLACKJACK_PROFILES_PATH EXT_PATH("apps_data/blackjack/profiles.dat")
-#define BLACKJACK_LAST_USED_PATH EXT_PATH("apps_data/blackjack/last_used")
-#define BLACKJACK_SETTINGS_PATH EXT_PATH("apps_data/blackjack/settings.dat")
-#define PROFILES_FILE_MAGIC "BJ1"
+#define TAG "blackjack"
 #define SPLASH_OPTIONS 6  /* Continue, New profile, Guest, Practice, Help, Settings */
-
-typedef struct BlackjackState BlackjackState;
-
-struct BlackjackState {
-    uint8_t deck[DECK_SIZE];
-    uint8_t deck_top;
-    uint8_t deck_bottom; /* Track position for burning bottom cards */
-    bool reshuffle_announced; /* Track if reshuffle was announced */
-    uint8_t player_hand[MAX_HAND];
-    uint8_t player_count;
-    uint8_t player_hand2[MAX_HAND]; /* Second hand after split */
-    uint8_t player_count2;
-    uint8_t dealer_hand[MAX_HAND];
-    uint8_t dealer_count;
-    bool dealer_hole; /* first dealer card hidden until stand */
-    GamePhase phase;
-    char result_msg[32];
-    uint16_t balance; /* player balance in dollars */
-    uint16_t current_bet; /* current bet amount */
-    uint16_t bet_hand2; /* bet for second hand after split */
-    uint16_t base_bet;   /* original bet for session; reset to this before next hand */
-    uint16_t insurance_bet; /* 0 = none; half of base bet (rounded down) if taken */
-    bool is_blackjack; /* true if player got dealt blackjack (Ace + 10, two cards only) */
-    bool can_double_down; /* true if player can double down (first 2 cards, enough balance) */
-    bool can_split; /* true if player can split (first 2 cards are pair, enough balance) */
-    bool is_split; /* true if hands are split */
-    uint8_t active_hand; /* 0 = first hand, 1 = second hand */
-    GamePhase prev_phase; /* Previous phase before help screen */
-    /* Statistics tracking */
-    uint16_t games_played;
-    uint16_t games_won;
-    uint16_t games_lost;
-    uint16_t games_pushed;
-    uint8_t stat_scroll; /* Scroll offset for stats menu (0 = top, loops) */
-    uint8_t help_scroll; /* Scroll offset for help (0 = top) */
-    uint8_t profile_menu_selection;
-    uint8_t current_profile_slot;
-    char profile_names[MAX_PROFILES][PROFILE_NAME_LEN];
-    uint8_t splash_selection;   /* 0=Continue, 1=New, 2=Guest, 3=Practice, 4=Help, 5=Settings */
-    bool is_guest;
-    bool practice_mode;
-    /* Settings (persisted) */
-    bool sound_on;
-    bool vibro_on;
-    bool dealer_hits_soft17;
+#define SETTINGS_OPTIONS 6  /* Sound, Vibro, Dealer S17, Penetration, Deal, Erase all */
+
+/* Delay between cards while dealing and during the dealer's play, by DealSpeed; 0 deals every
+ * card before the key press returns */
+static const uint16_t deal_delay_ms[DealSpeedCount] = {
+    [DealSpeedNormal] = 250,
+    [DealSpeedFast] = 0,
+    [DealSpeedSlow] = 500,
+};
+static const char* const deal_speed_names[DealSpeedCount] = {
+    [DealSpeedNormal] = "Normal",
+    [DealSpeedFast] = "Fast",
+    [DealSpeedSlow] = "Slow",
 };
 
-#define STAT_LINES 5   /* Games, Wins, Losses, Pushes, Win Rate */
+#define STAT_LINES 6   /* Games, Wins, Losses, Pushes, Win Rate, Shoe */
 #define STAT_VISIBLE 3 /* Lines visible at once */
 #define STAT_MAX_SCROLL (STAT_LINES > STAT_VISIBLE ? STAT_LINES - STAT_VISIBLE : 0)
 #define HELP_LINES 10
 #define HELP_VISIBLE 6
 #define HELP_MAX_SCROLL (HELP_LINES > HELP_VISIBLE ? HELP_LINES - HELP_VISIBLE : 0)
 
-/* Best hand value (Ace 1 or 11). Returns 0-31; >21 is bust. */
-static uint8_t hand_value(const uint8_t* hand, uint8_t count) {
-    uint8_t total = 0;
-    uint8_t aces = 0;
-    for(uint8_t i = 0; i < count; i++) {
-        uint8_t v = hand[i] % 13;
-        if(v >= 9) total += 10; /* 10, J, Q, K */
-        else if(v == 12) { total += 11; aces++; } /* A */
-        else total += v + 2; /* 2..9 */
-    }
-    while(total > 21 && aces) {
-        total -= 10;
-        aces--;
-    }
-    return total;
-}
-
-/* Get soft value (with ace as 11) and hard value (with ace as 1) */
-static void hand_values_soft_hard(const uint8_t* hand, uint8_t count, uint8_t* soft, uint8_t* hard) {
-    uint8_t total = 0;
-    uint8_t aces = 0;
-    for(uint8_t i = 0; i < count; i++) {
-        uint8_t v = hand[i] % 13;
-        if(v >= 9) total += 10; /* 10, J, Q, K */
-        else if(v == 12) { total += 11; aces++; } /* A */
-        else total += v + 2; /* 2..9 */
-    }
-    *soft = total;
-    *hard = total;
-    if(aces > 0 && total <= 21) {
-        *hard = total - 10; /* Hard value (ace as 1) */
-    }
-    /* If soft > 21, adjust */
-    while(*soft > 21 && aces) {
-        *soft -= 10;
-        aces--;
-    }
-}
-
-/* True if hand value is 17 and it's a soft 17 (Ace counted as 11) */
-static bool hand_is_soft_17(const uint8_t* hand, uint8_t count) {
-    uint8_t soft = 0, hard = 0;
-    hand_values_soft_hard(hand, count, &soft, &hard);
-    return (soft == 17 && soft != hard);
-}
-
-/* Wizard of Odds basic strategy hint (simplified). Returns recommended action. */
-static const char* wizard_strategy_hint(const uint8_t* hand, uint8_t count, uint8_t dealer_card, bool can_double, bool can_split) {
-    uint8_t total = hand_value(hand, count);
-    uint8_t soft = 0, hard = 0;
-    hand_values_soft_hard(hand, count, &soft, &hard);
-    bool is_soft = (soft != hard && soft <= 21);
-    bool is_pair = (count == 2 && CARD_RANK(hand[0]) == CARD_RANK(hand[1]));
-    uint8_t r = dealer_card % 13;
-    int d = (r >= 8 && r <= 11) ? 10 : (r == 12) ? 11 : (r + 2);
-    if(is_pair && can_split) {
-        if(CARD_RANK(hand[0]) == 12) return "Split";   /* A,A */
-        if(CARD_RANK(hand[0]) == 9) return "Split";    /* 10,10 - no, stand. 9,9 vs 2-9,7: split */
-        if(CARD_RANK(hand[0]) == 8) return "Split";   /* 8,8 */
-        if(CARD_RANK(hand[0]) == 7 && d <= 7) return "Split";
-        if(CARD_RANK(hand[0]) == 6 && d <= 6) return "Split";
-        if(CARD_RANK(hand[0]) == 3 && d <= 7) return "Split";
-        if(CARD_RANK(hand[0]) == 2 && d <= 7) return "Split";
-    }
-    if(is_soft) {
-        if(soft >= 19) return "Stand";
-        if(soft == 18 && d >= 9) return "Hit";
-        if(soft == 18 && d <= 8) return "Stand";
-        if(soft == 17 && d >= 3 && can_double) return "Double";
-        if(soft >= 15 && soft <= 17 && d >= 4 && d <= 6 && can_double) return "Double";
-        if(soft >= 13 && soft <= 17) return "Hit";
-        return "Hit";
-    }
-    if(total >= 17) return "Stand";
-    if(total >= 13 && total <= 16 && d <= 6) return "Stand";
-    if(total == 12 && d >= 4 && d <= 6) return "Stand";
-    if(total == 11 && can_double) return "Double";
-    if(total == 10 && d <= 9 && can_double) return "Double";
-    if(total == 9 && d >= 3 && d <= 6 && can_double) return "Double";
-    if(total <= 11) return "Hit";
-    if(total >= 12 && d >= 7) return "Hit";
-    return "Stand";
-}
-
-static void shuffle_deck(uint8_t* deck) {
-    /* Create 3 decks */
-    for(int i = 0; i < DECK_SIZE; i++) {
-        deck[i] = (uint8_t)(i % 52);
-    }
-    /* Fisher-Yates shuffle */
-    for(int i = DECK_SIZE - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
-        uint8_t t = deck[i];
-        deck[i] = deck[j];
-        deck[j] = t;
-    }
-}
-
-static uint8_t draw_card(BlackjackState* s) {
-    /* Check if we've reached the burn zone (bottom 20 cards) */
-    if(s->deck_top >= (DECK_SIZE - BURN_BOTTOM)) {
-        /* Reshuffle when reaching burn zone */
-        shuffle_deck(s->deck);
-        s->deck_top = BURN_TOP; /* Burn top card */
-        s->deck_bottom = DECK_SIZE - BURN_BOTTOM;
-        s->reshuffle_announced = false; /* Need to announce */
-    }
-    if(s->deck_top >= DECK_SIZE) {
-        shuffle_deck(s->deck);
-        s->deck_top = BURN_TOP; /* Burn top card */
-        s->deck_bottom = DECK_SIZE - BURN_BOTTOM;
-        s->reshuffle_announced = false; /* Need to announce */
-    }
-    return s->deck[s->deck_top++];
-}
-
 static const char* card_rank_str(uint8_t card) {
     static const char* r[] = { "2","3","4","5","6","7","8","9","10","J","Q","K","A" };
     return r[card % 13];
@@ -310,254 +138,141 @@ static char card_suit_char(uint8_t card) {
     return suits[card / 13];
 }
 
-/* Draw a card graphic (16x22px) - cards overlap, black with white text */
-static void draw_card_graphic(Canvas* canvas, int x, int y, uint8_t card, bool hidden) {
-    if(hidden) {
-        /* Draw card back (filled rectangle) */
-        canvas_draw_box(canvas, x, y, 16, 22);
-        canvas_set_color(canvas, ColorWhite);
-        canvas_draw_dot(canvas, x + 3, y + 5);
-        canvas_draw_dot(canvas, x + 12, y + 16);
-        canvas_set_color(canvas, ColorBlack);
+/* "17 or 7" while an Ace can still count as 11, otherwise the single best total */
+static void format_hand_total(char* buf, size_t len, const HandTotals* t) {
+    if(t->soft) {
+        snprintf(buf, len, "%u or %u", hand_totals_value(t), t->hard);
     } else {
-        /* Draw card front (filled black rectangle) */
-        canvas_draw_box(canvas, x, y, 16, 22);
-        /* Draw rank and suit together in white */
+        snprintf(buf, len, "%u", hand_totals_value(t));
+    }
+}
+
+/* Draw a card (16x22px) from the sprite atlas; a card that overlaps another clears its area first */
+static void draw_card_graphic(Canvas* canvas, int x, int y, uint8_t card, bool hidden, bool overlaps) {
+    if(overlaps) {
         canvas_set_color(canvas, ColorWhite);
-        canvas_set_font(canvas, FontPrimary);
-        char card_str[4];
-        snprintf(card_str, sizeof(card_str), "%s%c", card_rank_str(card), card_suit_char(card));
-        canvas_draw_str(canvas, x + 2, y + 14, card_str);
+        canvas_draw_box(canvas, x, y, SPRITE_CARD_W, SPRITE_CARD_H);
         canvas_set_color(canvas, ColorBlack);
     }
+    canvas_draw_xbm(canvas, x, y, SPRITE_CARD_W, SPRITE_CARD_H, hidden ? sprite_card_back : sprite_card_faces[card % 52]);
 }
 
-/* Draw chip stack that grows with bet amount (1 chip per $25) */
-static void draw_chip_stack(Canvas* canvas, int x, int y, uint16_t bet_amount) {
-    uint8_t chip_count = (bet_amount / 25) + 1; /* At least 1 chip, +1 per $25 */
-    if(chip_count > 8) chip_count = 8; /* Max 8 chips visible */
-    
-    for(uint8_t i = 0; i < chip_count; i++) {
-        int chip_x = x + (i * 6); /* Space chips 6px apart */
-        /* Draw overlapping circles to show stack */
-        canvas_draw_circle(canvas, chip_x, y, 4);
-        canvas_draw_circle(canvas, chip_x, y + 1, 4);
-        canvas_draw_circle(canvas, chip_x, y + 2, 4);
-        /* Add center dot */
-        canvas_draw_dot(canvas, chip_x, y + 1);
+/* Practice mode: EV of each allowed action in percent of the bet, e.g. "EV S-54 H-29 D-108";
+ * NULL while it is being computed */
+static void format_practice_ev(char* buf, size_t size, const float* ev) {
+    static const char letters[] = "SHDP"; /* By StrategyAction */
+    size_t len = (size_t)snprintf(buf, size, "%s", ev ? "EV" : "EV ...");
+    for(int a = 0; ev && a < 4 && len < size; a++) {
+        if(isnan(ev[a])) continue;
+        int pct = (int)(ev[a] * 100.0f + (ev[a] < 0 ? -0.5f : 0.5f));
+        len += snprintf(buf + len, size - len, " %c%+d", letters[a], pct);
     }
 }
 
-/* Forward declarations */
-static void game_deal_cards(BlackjackState* s);
-static void game_player_stand(BlackjackState* s);
-static void game_player_split(BlackjackState* s);
-
-#pragma pack(push, 1)
-typedef struct {
-    char name[PROFILE_NAME_LEN];
-    uint16_t balance;
-    uint16_t games_played;
-    uint16_t games_won;
-    uint16_t games_lost;
-    uint16_t games_pushed;
-} ProfileRecord;
-#pragma pack(pop)
-
-static void profile_ensure_dir(Storage* storage) {
-    storage_simply_mkdir(storage, EXT_PATH("apps_data"));
-    storage_simply_mkdir(storage, EXT_PATH("apps_data/blackjack"));
-}
-
-static void profile_load_list(Storage* storage, BlackjackState* s) {
-    for(uint8_t i = 0; i < MAX_PROFILES; i++) {
-        snprintf(s->profile_names[i], PROFILE_NAME_LEN, "Slot %u", (unsigned)(i + 1));
-    }
-    File* file = storage_file_alloc(storage);
-    if(!storage_file_open(file, BLACKJACK_PROFILES_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        storage_file_free(file);
-        return;
-    }
-    char magic[4];
-    if(storage_file_read(file, magic, 4) != 4 || memcmp(magic, PROFILES_FILE_MAGIC, 4) != 0) {
-        storage_file_close(file);
-        storage_file_free(file);
-        return;
+/* Practice mode: chance the dealer busts from this upcard against the unseen cards */
+static void format_practice_dealer_bust(char* buf, size_t size, int8_t bust) {
+    if(bust >= 0) {
+        snprintf(buf, size, "Bust %d%%", bust);
+    } else {
+        buf[0] = '\0';
     }
-    ProfileRecord rec;
-    for(uint8_t i = 0; i < MAX_PROFILES; i++) {
-        if(storage_file_read(file, &rec, sizeof(rec)) != sizeof(rec)) break;
-        rec.name[PROFILE_NAME_LEN - 1] = '\0';
-        if(rec.name[0] != '\0') {
-            strncpy(s->profile_names[i], rec.name, PROFILE_NAME_LEN - 1);
-            s->profile_names[i][PROFILE_NAME_LEN - 1] = '\0';
+}
+
+/* Cards of a split hand as text, e.g. "10H 4S " */
+static void format_split_hand(char* buf, size_t size, const uint8_t* hand, uint8_t count) {
+    int len = 0;
+    buf[0] = '\0';
+    for(uint8_t i = 0; i < count && len < (int)size - 4; i++) {
+        char card_buf[8];
+        int n = snprintf(card_buf, sizeof(card_buf), "%s%c ", card_rank_str(hand[i]), card_suit_char(hand[i]));
+        if(len + n < (int)size) {
+            strncpy(buf + len, card_buf, size - len);
+            len += n;
         }
     }
-    storage_file_close(file);
-    storage_file_free(file);
 }
 
-static void profile_load_slot(Storage* storage, BlackjackState* s, uint8_t slot) {
-    if(slot >= MAX_PROFILES) return;
-    s->current_profile_slot = slot;
-    File* file = storage_file_alloc(storage);
-    if(!storage_file_open(file, BLACKJACK_PROFILES_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        storage_file_free(file);
-        s->balance = STARTING_BALANCE;
-        s->games_played = s->games_won = s->games_lost = s->games_pushed = 0;
-        return;
-    }
-    storage_file_seek(file, 4 + (uint32_t)slot * sizeof(ProfileRecord), true);
-    ProfileRecord rec;
-    if(storage_file_read(file, &rec, sizeof(rec)) != sizeof(rec)) {
-        storage_file_close(file);
-        storage_file_free(file);
-        s->balance = STARTING_BALANCE;
-        s->games_played = s->games_won = s->games_lost = s->games_pushed = 0;
-        return;
-    }
-    storage_file_close(file);
-    storage_file_free(file);
-    s->balance = rec.balance;
-    s->games_played = rec.games_played;
-    s->games_won = rec.games_won;
-    s->games_lost = rec.games_lost;
-    s->games_pushed = rec.games_pushed;
-    if(s->balance == 0) s->balance = STARTING_BALANCE;
-}
-
-static uint8_t profile_load_last_used(Storage* storage) {
-    File* file = storage_file_alloc(storage);
-    uint8_t slot = 0;
-    if(storage_file_open(file, BLACKJACK_LAST_USED_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        if(storage_file_read(file, &slot, 1) == 1 && slot < MAX_PROFILES) { /* valid */ }
-        else slot = 0;
-        storage_file_close(file);
-    }
-    storage_file_free(file);
-    return slot;
+/* Draw chip stack that grows with bet amount (1 chip per $25); (x, y) is the first chip's centre */
+static void draw_chip_stack(Canvas* canvas, int x, int y, uint16_t bet_amount) {
+    uint16_t chip_count = (bet_amount / 25) + 1; /* At least 1 chip, +1 per $25 */
+    if(chip_count > SPRITE_CHIP_STACK_MAX) chip_count = SPRITE_CHIP_STACK_MAX;
+    canvas_draw_xbm(
+        canvas,
+        x - SPRITE_CHIP_W / 2,
+        y - SPRITE_CHIP_W / 2,
+        SPRITE_CHIP_STACK_W(chip_count),
+        SPRITE_CHIP_H,
+        sprite_chip_stacks[chip_count - 1]);
 }
 
-static void profile_save_last_used(Storage* storage, uint8_t slot) {
-    if(slot >= MAX_PROFILES) return;
-    profile_ensure_dir(storage);
-    File* file = storage_file_alloc(storage);
-    if(storage_file_open(file, BLACKJACK_LAST_USED_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        storage_file_write(file, &slot, 1);
-        storage_file_sync(file);
-        storage_file_close(file);
-    }
-    storage_file_free(file);
+/* Work a key press leaves for after the model is unlocked, so the GUI thread never waits
+ * on the store worker's queue or the notification service */
+typedef struct {
+    uint8_t feedback; /* GameEvent sounds and vibration to play, already filtered by the settings */
+    bool save; /* Post the store to the worker */
+    bool flush_log; /* Write out the whole history ring */
+    uint8_t session_size; /* Bytes of log holding the session record; 0 after the first round */
+    uint8_t log_size; /* The settled round's records, 0 if none */
+    uint8_t log[2 * HISTORY_RECORD_MAX];
+    uint16_t deal_delay_ms; /* Start the deal timer at this period; 0 = leave it */
+} BlackjackDeferred;
+
+/* Custom events to the view dispatcher thread */
+typedef enum {
+    BlackjackEventDealStep, /* From the deal timer: deal the next card */
+    BlackjackEventPracticeReady, /* From the practice worker: its numbers are ready */
+} BlackjackEvent;
+
+typedef struct {
+    View* view;
+    ViewDispatcher* view_dispatcher;
+    uint32_t drawn_hash; /* view_hash of the last model committed with a redraw */
+    uint32_t redraws_skipped; /* Commits that left the screen as it was */
+    BlackjackStore store; /* Profiles and settings, loaded once at startup */
+    StoreWorker* store_worker; /* Writes the store and the hand history off the input thread */
+    PracticeWorker* practice_worker; /* Searches the practice-mode EV off the input thread */
+    bool history_session_logged; /* This run's session record is in the history */
+    BlackjackDeferred deferred; /* Left by the key press being handled */
+    LockStats lock_stats; /* How long each key press and dealing step held the model */
+    FuriTimer* deal_timer; /* Deals a card every deal_delay_ms while game_is_dealing */
+} BlackjackApp;
+
+/* Queue a write of whatever changed in the store once the model is unlocked; the SD card is
+ * written on the worker thread */
+static void profile_store_flush(BlackjackApp* app) {
+    app->deferred.save = true;
 }
 
-static void profile_save_current(Storage* storage, BlackjackState* s) {
-    profile_ensure_dir(storage);
-    File* file = storage_file_alloc(storage);
-    if(!storage_file_open(file, BLACKJACK_PROFILES_PATH, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
-        storage_file_free(file);
-        return;
-    }
-    uint64_t size = storage_file_size(file);
-    if(size < 4) {
-        storage_file_seek(file, 0, true);
-        storage_file_write(file, PROFILES_FILE_MAGIC, 4);
-        for(uint8_t i = 0; i < MAX_PROFILES; i++) {
-            ProfileRecord rec = { .name = {0}, .balance = 0, .games_played = 0, .games_won = 0, .games_lost = 0, .games_pushed = 0 };
-            storage_file_write(file, &rec, sizeof(rec));
-        }
-        storage_file_sync(file);
-    }
-    ProfileRecord rec;
-    memset(rec.name, 0, sizeof(rec.name));
-    strncpy(rec.name, s->profile_names[s->current_profile_slot], PROFILE_NAME_LEN - 1);
-    rec.balance = s->balance;
-    rec.games_played = s->games_played;
-    rec.games_won = s->games_won;
-    rec.games_lost = s->games_lost;
-    rec.games_pushed = s->games_pushed;
-    storage_file_seek(file, 4 + (uint32_t)s->current_profile_slot * sizeof(ProfileRecord), true);
-    storage_file_write(file, &rec, sizeof(rec));
-    storage_file_sync(file);
-    storage_file_close(file);
-    storage_file_free(file);
-    profile_save_last_used(storage, s->current_profile_slot);
-}
-
-static void profile_save_guest_to_slot(Storage* storage, BlackjackState* s, uint8_t slot) {
+/* Take the feedback raised by the rules engine since the last key press, to play once the
+ * model is unlocked */
+static void blackjack_take_events(BlackjackApp* app, BlackjackState* s) {
+    if(s->sound_on) app->deferred.feedback |= s->events & (GameEventHit | GameEventStand);
+    if(s->vibro_on) app->deferred.feedback |= s->events & GameEventBlackjack;
+    s->events &= GameEventRoundOver; /* Logged by blackjack_commit */
+}
+
+/* Save the current profile and make it the one "Continue" loads */
+static void profile_save_current(BlackjackApp* app, BlackjackState* s) {
+    store_put_profile(&app->store, s);
+    store_set_last_used(&app->store, s->current_profile_slot);
+    profile_store_flush(app);
+}
+
+static void profile_save_guest_to_slot(BlackjackApp* app, BlackjackState* s, uint8_t slot) {
     if(slot >= MAX_PROFILES) return;
-    profile_ensure_dir(storage);
-    profile_load_list(storage, s);
+    store_get_names(&app->store, s);
     if(s->profile_names[slot][0] == '\0') {
         snprintf(s->profile_names[slot], PROFILE_NAME_LEN, "Player %u", (unsigned)(slot + 1));
     }
     s->current_profile_slot = slot;
-    profile_save_current(storage, s);
-}
-
-#define SETTINGS_MAGIC_LEN 4
-static const char SETTINGS_MAGIC[SETTINGS_MAGIC_LEN] = "BJS\0";
-
-static void settings_load(Storage* storage, BlackjackState* s) {
-    s->sound_on = true;
-    s->vibro_on = true;
-    s->dealer_hits_soft17 = false;
-    File* file = storage_file_alloc(storage);
-    if(!storage_file_open(file, BLACKJACK_SETTINGS_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        storage_file_free(file);
-        return;
-    }
-    char magic[SETTINGS_MAGIC_LEN];
-    if(storage_file_read(file, magic, SETTINGS_MAGIC_LEN) != SETTINGS_MAGIC_LEN ||
-       memcmp(magic, SETTINGS_MAGIC, SETTINGS_MAGIC_LEN) != 0) {
-        storage_file_close(file);
-        storage_file_free(file);
-        return;
-    }
-    uint8_t flags;
-    if(storage_file_read(file, &flags, 1) == 1) {
-        s->sound_on = (flags & 1) != 0;
-        s->vibro_on = (flags & 2) != 0;
-        s->dealer_hits_soft17 = (flags & 4) != 0;
-    }
-    storage_file_close(file);
-    storage_file_free(file);
+    profile_save_current(app, s);
 }
 
-static void settings_save(Storage* storage, BlackjackState* s) {
-    profile_ensure_dir(storage);
-    File* file = storage_file_alloc(storage);
-    if(!storage_file_open(file, BLACKJACK_SETTINGS_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        storage_file_free(file);
-        return;
-    }
-    storage_file_write(file, SETTINGS_MAGIC, SETTINGS_MAGIC_LEN);
-    uint8_t flags = (s->sound_on ? 1 : 0) | (s->vibro_on ? 2 : 0) | (s->dealer_hits_soft17 ? 4 : 0);
-    storage_file_write(file, &flags, 1);
-    storage_file_sync(file);
-    storage_file_close(file);
-    storage_file_free(file);
-}
-
-static void profile_erase_all(Storage* storage, BlackjackState* s) {
-    profile_ensure_dir(storage);
-    File* file = storage_file_alloc(storage);
-    if(!storage_file_open(file, BLACKJACK_PROFILES_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        storage_file_free(file);
-        return;
-    }
-    storage_file_write(file, PROFILES_FILE_MAGIC, 4);
-    ProfileRecord rec;
-    memset(rec.name, 0, sizeof(rec.name));
-    rec.balance = STARTING_BALANCE;
-    rec.games_played = rec.games_won = rec.games_lost = rec.games_pushed = 0;
-    for(uint8_t i = 0; i < MAX_PROFILES; i++) {
-        storage_file_write(file, &rec, sizeof(rec));
-    }
-    storage_file_sync(file);
-    storage_file_close(file);
-    storage_file_free(file);
-    profile_save_last_used(storage, 0);
-    profile_load_list(storage, s);
+static void profile_erase_all(BlackjackApp* app, BlackjackState* s) {
+    BlackjackStore* store = &app->store;
+    store_erase_profiles(store);
+    profile_store_flush(app);
+    store_get_names(store, s);
     s->current_profile_slot = 0;
     s->balance = STARTING_BALANCE;
     s->games_played = s->games_won = s->games_lost = s->games_pushed = 0;
@@ -578,23 +293,6 @@ static void profile_create_new(BlackjackState* s) {
     s->games_played = s->games_won = s->games_lost = s->games_pushed = 0;
 }
 
-static void game_start_betting(BlackjackState* s) {
-    s->phase = PhaseBetting;
-    s->current_bet = MIN_BET;
-    if(s->current_bet > s->balance) {
-        s->current_bet = (s->balance < MIN_BET) ? 0 : s->balance;
-    }
-    s->base_bet = s->current_bet;  /* default; overwritten when they place bet */
-    s->result_msg[0] = '\0';
-    s->is_blackjack = false;
-    s->can_double_down = false;
-    s->can_split = false;
-    s->is_split = false;
-    s->active_hand = 0;
-    s->bet_hand2 = 0;
-    s->player_count2 = 0;
-}
-
 static void game_show_statistics(BlackjackState* s) {
     s->phase = PhaseStatistics;
     s->stat_scroll = 0;
@@ -606,384 +304,119 @@ static void game_show_help(BlackjackState* s) {
     s->help_scroll = 0;
 }
 
-/* Resolve insurance choice: peek dealer; if dealer blackjack settle (main + insurance), else continue to player turn/split */
-static void resolve_insurance(BlackjackState* s, bool took_insurance) {
-    if(took_insurance) {
-        s->insurance_bet = s->current_bet / 2;  /* half, rounded down */
-        s->balance -= s->insurance_bet;
+/* Strings and widths draw_callback would otherwise format and measure on every frame.
+ * Rebuilt from the GameDirty bits the engine and input handler raise, so a frame where
+ * nothing changed only blits. */
+typedef struct {
+    char balance[8];
+    char bet[12]; /* "Bet:$25", FontSecondary, right-aligned during a hand */
+    char bet_big[16]; /* "Bet: $25", FontPrimary, betting screen */
+    uint8_t bet_w;
+    uint8_t bet_big_w;
+    char dealer_total[12];
+    char player_total[2][12];
+    char split_hand[2][32];
+    char result[32];
+    uint8_t result_w;
+    uint8_t msg_w;
+    /* Practice mode */
+    char hint[24];
+    char ev[32];
+    char bust[16];
+    uint8_t bust_w;
+    uint8_t hint_key; /* Phase and settings the hint was built for */
+    uint32_t practice_key; /* PracticeNumbers.key the EV line was built from */
+} RenderCache;
+
+/* The view model: the game plus its render cache. The host harness reads the model as a
+ * BlackjackState, so the game stays first. */
+typedef struct {
+    BlackjackState game;
+    RenderCache render;
+    PracticeNumbers practice;
+} BlackjackModel;
+
+static void render_cache_update(Canvas* canvas, BlackjackState* s, RenderCache* rc, const PracticeNumbers* pn) {
+    uint8_t hint_key = (uint8_t)(s->phase | s->practice_mode << 5 | s->dealer_hits_soft17 << 6);
+    if(s->dirty & GameDirtyBank) {
+        snprintf(rc->balance, sizeof(rc->balance), "$%u", s->balance);
+        snprintf(rc->bet, sizeof(rc->bet), "Bet:$%u", s->current_bet);
+        snprintf(rc->bet_big, sizeof(rc->bet_big), "Bet: $%u", s->current_bet);
+        canvas_set_font(canvas, FontSecondary);
+        rc->bet_w = (uint8_t)canvas_string_width(canvas, rc->bet);
+        canvas_set_font(canvas, FontPrimary);
+        rc->bet_big_w = (uint8_t)canvas_string_width(canvas, rc->bet_big);
     }
-    s->dealer_hole = false;
-    uint8_t dv = hand_value(s->dealer_hand, s->dealer_count);
-    if(dv == 21) {
-        s->games_played++;
-        if(took_insurance) {
-            s->balance += s->current_bet;  /* main bet back (push) */
-            s->balance += s->insurance_bet * 2;  /* insurance pays 2:1 */
-            s->games_pushed++;
-            snprintf(s->result_msg, sizeof(s->result_msg), "Dealer BJ. Ins +$%u", s->insurance_bet);
-        } else {
-            s->games_lost++;
-            snprintf(s->result_msg, sizeof(s->result_msg), "Dealer blackjack. -$%u", s->current_bet);
+    if(s->dirty & GameDirtyHands) {
+        format_hand_total(rc->dealer_total, sizeof(rc->dealer_total), &s->dealer_totals);
+        format_hand_total(rc->player_total[0], sizeof(rc->player_total[0]), &s->player_totals);
+        format_hand_total(rc->player_total[1], sizeof(rc->player_total[1]), &s->player_totals2);
+        if(s->is_split) {
+            format_split_hand(rc->split_hand[0], sizeof(rc->split_hand[0]), s->player_hand, s->player_count);
+            format_split_hand(rc->split_hand[1], sizeof(rc->split_hand[1]), s->player_hand2, s->player_count2);
         }
-        s->result_msg[sizeof(s->result_msg) - 1] = '\0';
-        s->phase = PhaseResult;
-        blackjack_notify_vibro(s->vibro_on); /* vibration: dealer blackjack */
-        return;
-    }
-    bool is_pair = (s->player_count == 2 && CARD_RANK(s->player_hand[0]) == CARD_RANK(s->player_hand[1]));
-    s->can_split = (is_pair && (s->balance >= s->current_bet));
-    if(s->can_split) {
-        s->phase = PhaseSplitPrompt;
-    } else {
-        s->phase = PhasePlayerTurn;
-        s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
-    }
-}
-
-static void game_place_bet(BlackjackState* s) {
-    if(s->current_bet == 0 || s->current_bet > s->balance) return;
-    s->base_bet = s->current_bet;  /* remember for reset after double/split/insurance */
-    s->balance -= s->current_bet;
-    s->insurance_bet = 0;
-    game_deal_cards(s);
-}
-
-static void game_deal_cards(BlackjackState* s) {
-    shuffle_deck(s->deck);
-    s->deck_top = BURN_TOP; /* Burn top card */
-    s->deck_bottom = DECK_SIZE - BURN_BOTTOM;
-    s->reshuffle_announced = true; /* Already shuffled, no need to announce */
-    s->player_count = 0;
-    s->dealer_count = 0;
-    s->dealer_hole = true;
-    s->phase = PhaseDeal;
-
-    s->player_hand[s->player_count++] = draw_card(s);
-    s->dealer_hand[s->dealer_count++] = draw_card(s);
-    s->player_hand[s->player_count++] = draw_card(s);
-    s->dealer_hand[s->dealer_count++] = draw_card(s);
-    
-    /* Check if reshuffle happened during deal */
-    if(!s->reshuffle_announced) {
-        s->phase = PhaseReshuffle;
-        return;
     }
-
-    /* Player blackjack only on initial two-card 21 (Ace + 10-value) */
-    uint8_t pv = hand_value(s->player_hand, s->player_count);
-    bool player_has_blackjack = (s->player_count == 2 && pv == 21);
-    if(player_has_blackjack) {
-        s->is_blackjack = true;
-        s->dealer_hole = false;
-        s->phase = PhaseShowFinalCards;
-        uint8_t dv = hand_value(s->dealer_hand, s->dealer_count);
-        if(dv == 21) {
-            s->balance += s->current_bet; /* push */
-            snprintf(s->result_msg, sizeof(s->result_msg), "Push. +$%u", s->current_bet);
+    if(s->dirty & (GameDirtyHands | GameDirtyResult)) {
+        uint8_t pv_final = hand_totals_value(&s->player_totals);
+        uint8_t dv_final = hand_totals_value(&s->dealer_totals);
+        if(s->is_split) {
+            uint8_t pv2_final = hand_totals_value(&s->player_totals2);
+            snprintf(rc->result, sizeof(rc->result), "P1:%u P2:%u D:%u", pv_final, pv2_final, dv_final);
         } else {
-            uint16_t payout = s->current_bet + (s->current_bet * 3 / 2);
-            s->balance += payout;
-            snprintf(s->result_msg, sizeof(s->result_msg), "Blackjack! +$%u", payout);
+            snprintf(rc->result, sizeof(rc->result), "P:%u D:%u", pv_final, dv_final);
         }
-        s->result_msg[sizeof(s->result_msg) - 1] = '\0';
-        blackjack_notify_vibro(s->vibro_on); /* vibration: blackjack (player or push) */
-        return;
-    }
-    /* Dealer up card: second card (index 1) */
-    uint8_t dealer_up_rank = s->dealer_hand[1] % 13; /* 0-12: 2..9, 8-11=10/J/Q/K, 12=Ace */
-    bool dealer_up_is_ace = (dealer_up_rank == 12);
-    bool dealer_up_is_10 = (dealer_up_rank >= 8 && dealer_up_rank <= 11);
-    if(dealer_up_is_ace) {
-        /* Offer insurance before peeking (pop-up like result screen) */
-        s->phase = PhaseInsurancePrompt;
-        s->profile_menu_selection = 0; /* 0=No, 1=Yes */
-        return;
-    }
-    if(dealer_up_is_10) {
-        /* Peek: if dealer has blackjack, hand ends immediately */
-        uint8_t dv = hand_value(s->dealer_hand, s->dealer_count);
-        if(dv == 21) {
-            s->dealer_hole = false;
-            s->games_played++;
-            s->games_lost++;
-            snprintf(s->result_msg, sizeof(s->result_msg), "Dealer blackjack. -$%u", s->current_bet);
-            s->result_msg[sizeof(s->result_msg) - 1] = '\0';
-            s->phase = PhaseResult;
-            blackjack_notify_vibro(s->vibro_on); /* vibration: dealer blackjack */
-            return;
-        }
-    }
-    /* No dealer blackjack - player turn or split prompt */
-    bool is_pair = (s->player_count == 2 && CARD_RANK(s->player_hand[0]) == CARD_RANK(s->player_hand[1]));
-    s->can_split = (is_pair && (s->balance >= s->current_bet));
-    if(s->can_split) {
-        s->phase = PhaseSplitPrompt;
-    } else {
-        s->phase = PhasePlayerTurn;
-        s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
+        canvas_set_font(canvas, FontPrimary);
+        rc->result_w = (uint8_t)canvas_string_width(canvas, rc->result);
+        rc->msg_w = (uint8_t)canvas_string_width(canvas, s->result_msg);
     }
-}
-
-static void game_player_hit(BlackjackState* s) {
-    if(s->phase != PhasePlayerTurn) return;
-    blackjack_notify_sound_hit(s->sound_on); /* audio: hit */
-    uint8_t* hand = (s->is_split && s->active_hand == 1) ? s->player_hand2 : s->player_hand;
-    uint8_t* count = (s->is_split && s->active_hand == 1) ? &s->player_count2 : &s->player_count;
-    
-    if(*count >= MAX_HAND) return;
-    
-    hand[(*count)++] = draw_card(s);
-    s->can_double_down = false; /* Can't double after hitting */
-    s->can_split = false; /* Can't split after hitting */
-    
-    uint8_t pv = hand_value(hand, *count);
-        if(pv > 21) {
-            /* Hand busted - if split, move to next hand or show results */
-            if(s->is_split && s->active_hand == 0) {
-                /* Move to second hand */
-                s->active_hand = 1;
-                s->can_double_down = (s->player_count2 == 2 && (s->balance >= s->bet_hand2));
-                s->can_split = false; /* Can't split second hand */
+    bool hint_changed = (s->dirty & GameDirtyHands) || hint_key != rc->hint_key;
+    if(hint_changed) {
+        rc->hint_key = hint_key;
+        rc->hint[0] = '\0';
+        if(s->practice_mode && (s->phase == PhasePlayerTurn || s->phase == PhaseSplitPrompt)) {
+            StrategyAction hint;
+            if(s->phase == PhaseSplitPrompt) {
+                hint = strategy_lookup(&s->player_totals, 2, s->dealer_hand[1], true, false, true, s->dealer_hits_soft17);
             } else {
-            /* Both hands done or single hand busted */
-            s->dealer_hole = false; /* Show dealer cards */
-            s->phase = PhaseShowFinalCards;
-        }
-    } else if(*count == MAX_HAND) {
-        /* Player wins with 6 cards without busting */
-        if(s->is_split && s->active_hand == 0) {
-            /* Move to second hand */
-            s->active_hand = 1;
-            s->can_double_down = (s->player_count2 == 2 && (s->balance >= s->bet_hand2));
-            s->can_split = false;
-        } else {
-            s->dealer_hole = false; /* Show dealer cards */
-            s->phase = PhaseShowFinalCards;
+                bool second = s->is_split && s->active_hand == 1;
+                const uint8_t* ph = second ? s->player_hand2 : s->player_hand;
+                uint8_t pc = second ? s->player_count2 : s->player_count;
+                bool is_pair = (pc == 2 && CARD_RANK(ph[0]) == CARD_RANK(ph[1]));
+                hint = strategy_lookup(
+                    second ? &s->player_totals2 : &s->player_totals,
+                    pc,
+                    s->dealer_hand[1],
+                    is_pair,
+                    s->can_double_down,
+                    s->can_split,
+                    s->dealer_hits_soft17);
+            }
+            snprintf(rc->hint, sizeof(rc->hint), "Strategy: %s", strategy_action_name(hint));
         }
     }
-}
-
-static void game_player_double_down(BlackjackState* s) {
-    if(s->phase != PhasePlayerTurn || !s->can_double_down) return;
-    
-    uint8_t* hand = (s->is_split && s->active_hand == 1) ? s->player_hand2 : s->player_hand;
-    uint8_t* count = (s->is_split && s->active_hand == 1) ? &s->player_count2 : &s->player_count;
-    uint16_t* bet = (s->is_split && s->active_hand == 1) ? &s->bet_hand2 : &s->current_bet;
-    
-    if(*count != 2) return;
-    if(s->balance >= *bet) {
-        s->balance -= *bet;
-        *bet *= 2;
-    } else {
-        /* Not enough balance to double */
-        return;
+    if(rc->hint[0] && (hint_changed || pn->key != rc->practice_key)) {
+        rc->practice_key = pn->key;
+        bool ready = pn->key == hand_ev_key(s);
+        format_practice_ev(rc->ev, sizeof(rc->ev), ready ? pn->ev : NULL);
+        format_practice_dealer_bust(rc->bust, sizeof(rc->bust), ready ? pn->bust : -1);
+        canvas_set_font(canvas, FontSecondary);
+        rc->bust_w = (uint8_t)canvas_string_width(canvas, rc->bust);
     }
-    /* Draw exactly one card */
-    hand[(*count)++] = draw_card(s);
-    s->can_double_down = false;
-    s->can_split = false;
-    /* Automatically stand after double down */
-    game_player_stand(s);
+    s->dirty = 0;
 }
 
-static void game_player_split(BlackjackState* s) {
-    if(s->phase != PhasePlayerTurn || !s->can_split) return;
-    
-    /* Check if we have enough balance for second bet */
-    if(s->balance < s->current_bet) return;
-    
-    /* Place bet for second hand */
-    s->balance -= s->current_bet;
-    s->bet_hand2 = s->current_bet;
-    
-    /* Split the pair: second card goes to second hand */
-    s->player_hand2[0] = s->player_hand[1];
-    s->player_count2 = 1;
-    s->player_count = 1; /* First hand now has one card */
-    
-    /* Deal one card to each hand */
-    s->player_hand[s->player_count++] = draw_card(s);
-    s->player_hand2[s->player_count2++] = draw_card(s);
-    
-    s->is_split = true;
-    s->active_hand = 0; /* Start with first hand */
-    s->can_split = false; /* Can't split again */
-    s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
-}
-
-static void game_player_stand(BlackjackState* s) {
-    if(s->phase != PhasePlayerTurn) return;
-    /* If split and on first hand, move to second hand (no stand sound) */
-    if(s->is_split && s->active_hand == 0) {
-        s->active_hand = 1;
-        s->can_double_down = (s->player_count2 == 2 && (s->balance >= s->bet_hand2));
-        s->can_split = false;
-        return;
-    }
-    blackjack_notify_sound_stand(s->sound_on); /* audio: stand (both hands done) */
-    /* Both hands done, dealer's turn */
-    s->phase = PhaseDealerTurn;
-    s->dealer_hole = false;
-
-    uint8_t dv = hand_value(s->dealer_hand, s->dealer_count);
-    bool hit_soft17 = s->dealer_hits_soft17 && hand_is_soft_17(s->dealer_hand, s->dealer_count);
-    while((dv < 17 || (dv == 17 && hit_soft17)) && s->dealer_count < MAX_HAND) {
-        s->dealer_hand[s->dealer_count++] = draw_card(s);
-        dv = hand_value(s->dealer_hand, s->dealer_count);
-        hit_soft17 = s->dealer_hits_soft17 && hand_is_soft_17(s->dealer_hand, s->dealer_count);
-        /* Dealer busts if they draw 6 cards without winning */
-        if(s->dealer_count == MAX_HAND && dv <= 21) {
-            /* Dealer has 6 cards but didn't win - they bust */
-            dv = 22; /* Force bust condition */
-            break;
-        }
-    }
-
-    /* Show final cards before result */
-    s->phase = PhaseShowFinalCards;
-}
-
-static void game_show_result(BlackjackState* s) {
-    /* If blackjack was already handled in game_deal_cards, just track stats */
-    if(s->is_blackjack && s->result_msg[0] != '\0') {
-        s->games_played++;
-        uint8_t dv = hand_value(s->dealer_hand, s->dealer_count);
-        if(dv == 21) {
-            s->games_pushed++;
-        } else {
-            s->games_won++;
-        }
-        s->phase = PhaseResult;
-        return;
-    }
-    
-    uint8_t dv = hand_value(s->dealer_hand, s->dealer_count);
-    uint16_t total_winnings = 0;
-    uint16_t total_losses = 0;
-    char result_buf[64] = "";
-    
-    if(s->is_split) {
-        /* Calculate results for both hands */
-        uint8_t pv1 = hand_value(s->player_hand, s->player_count);
-        uint8_t pv2 = hand_value(s->player_hand2, s->player_count2);
-        uint16_t winnings1 = 0, winnings2 = 0;
-        bool won1 = false, won2 = false, lost1 = false, lost2 = false;
-        
-        /* Hand 1 result */
-        if(pv1 > 21) {
-            lost1 = true;
-            total_losses += s->current_bet;
-        } else if(s->player_count == MAX_HAND) {
-            won1 = true;
-            winnings1 = s->current_bet * 2;
-            total_winnings += winnings1;
-        } else if(dv > 21) {
-            won1 = true;
-            winnings1 = s->current_bet * 2;
-            total_winnings += winnings1;
-        } else if(pv1 > dv) {
-            won1 = true;
-            winnings1 = s->current_bet * 2;
-            total_winnings += winnings1;
-        } else if(pv1 < dv) {
-            lost1 = true;
-            total_losses += s->current_bet;
-        } else {
-            /* Push - return bet */
-            total_winnings += s->current_bet;
-        }
-        
-        /* Hand 2 result */
-        if(pv2 > 21) {
-            lost2 = true;
-            total_losses += s->bet_hand2;
-        } else if(s->player_count2 == MAX_HAND) {
-            won2 = true;
-            winnings2 = s->bet_hand2 * 2;
-            total_winnings += winnings2;
-        } else if(dv > 21) {
-            won2 = true;
-            winnings2 = s->bet_hand2 * 2;
-            total_winnings += winnings2;
-        } else if(pv2 > dv) {
-            won2 = true;
-            winnings2 = s->bet_hand2 * 2;
-            total_winnings += winnings2;
-        } else if(pv2 < dv) {
-            lost2 = true;
-            total_losses += s->bet_hand2;
-        } else {
-            /* Push - return bet */
-            total_winnings += s->bet_hand2;
-        }
-        
-        s->balance += total_winnings;
-        
-        /* Format result message */
-        if(total_winnings > total_losses) {
-            uint16_t net = total_winnings - total_losses;
-            snprintf(result_buf, sizeof(result_buf), "Split: +$%u", net);
-        } else if(total_losses > total_winnings) {
-            uint16_t net = total_losses - total_winnings;
-            snprintf(result_buf, sizeof(result_buf), "Split: -$%u", net);
-        } else {
-            snprintf(result_buf, sizeof(result_buf), "Split: Push");
-        }
-        
-        /* Track statistics */
-        if(won1 && won2) {
-            s->games_won++;
-        } else if(lost1 && lost2) {
-            s->games_lost++;
-        } else {
-            s->games_pushed++;
-        }
-    } else {
-        /* Single hand result */
-        uint8_t pv = hand_value(s->player_hand, s->player_count);
-        
-        if(pv > 21) {
-            /* Player busted */
-            s->games_lost++;
-            snprintf(result_buf, sizeof(result_buf), "Bust! -$%u", s->current_bet);
-        } else if(s->player_count == MAX_HAND) {
-            /* Player wins with 6 cards */
-            s->games_won++;
-            uint16_t payout = s->current_bet * 2;
-            s->balance += payout;
-            snprintf(result_buf, sizeof(result_buf), "6 cards! +$%u", payout);
-        } else if(dv > 21) {
-            s->games_won++;
-            uint16_t payout = s->current_bet * 2;
-            s->balance += payout;
-            if(s->dealer_count == MAX_HAND) {
-                snprintf(result_buf, sizeof(result_buf), "Dealer 6 cards! +$%u", payout);
-            } else {
-                snprintf(result_buf, sizeof(result_buf), "Dealer bust! +$%u", payout);
-            }
-        } else if(pv > dv) {
-            s->games_won++;
-            uint16_t payout = s->current_bet * 2;
-            s->balance += payout;
-            snprintf(result_buf, sizeof(result_buf), "You win! +$%u", payout);
-        } else if(pv < dv) {
-            s->games_lost++;
-            snprintf(result_buf, sizeof(result_buf), "Dealer wins. -$%u", s->current_bet);
-        } else {
-            s->games_pushed++;
-            s->balance += s->current_bet; /* return bet on push */
-            snprintf(result_buf, sizeof(result_buf), "Push. +$%u", s->current_bet);
-        }
-    }
-    
-    strncpy(s->result_msg, result_buf, sizeof(s->result_msg) - 1);
-    s->result_msg[sizeof(s->result_msg) - 1] = '\0';
-    s->games_played++;
-    s->phase = PhaseResult;
+/* Practice mode: strategy hint, EV line and dealer bust chance, from the render cache */
+static void draw_practice(Canvas* canvas, const RenderCache* rc) {
+    if(rc->hint[0] == '\0') return;
+    canvas_draw_str(canvas, 0, 52, rc->hint);
+    canvas_draw_str(canvas, 0, 61, rc->ev);
+    if(rc->bust[0]) canvas_draw_str(canvas, 128 - rc->bust_w, 52, rc->bust);
 }
 
 static void draw_callback(Canvas* canvas, void* model) {
-    BlackjackState* s = (BlackjackState*)model;
+    BlackjackModel* m = model;
+    BlackjackState* s = &m->game;
+    const RenderCache* rc = &m->render;
     canvas_clear(canvas);
     canvas_set_font(canvas, FontPrimary);
 
@@ -1065,8 +498,8 @@ static void draw_callback(Canvas* canvas, void* model) {
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str(canvas, 0, 10, "Settings");
         canvas_set_font(canvas, FontSecondary);
-        const int line_h = 10;
-        int y = 20;
+        const int line_h = 9;
+        int y = 18;
         canvas_draw_str(canvas, 0, y, s->profile_menu_selection == 0 ? ">" : " ");
         canvas_draw_str(canvas, 8, y, s->sound_on ? "Sound: On " : "Sound: Off");
         y += line_h;
@@ -1076,7 +509,17 @@ static void draw_callback(Canvas* canvas, void* model) {
         canvas_draw_str(canvas, 0, y, s->profile_menu_selection == 2 ? ">" : " ");
         canvas_draw_str(canvas, 8, y, s->dealer_hits_soft17 ? "Dealer S17: Hit" : "Dealer S17: Stand");
         y += line_h;
+        char pen[24];
+        snprintf(pen, sizeof(pen), "Penetration: %u%%", (unsigned)cut_card_percent(s->cut_card));
         canvas_draw_str(canvas, 0, y, s->profile_menu_selection == 3 ? ">" : " ");
+        canvas_draw_str(canvas, 8, y, pen);
+        y += line_h;
+        char deal[16];
+        snprintf(deal, sizeof(deal), "Deal: %s", deal_speed_names[s->deal_speed]);
+        canvas_draw_str(canvas, 0, y, s->profile_menu_selection == 4 ? ">" : " ");
+        canvas_draw_str(canvas, 8, y, deal);
+        y += line_h;
+        canvas_draw_str(canvas, 0, y, s->profile_menu_selection == 5 ? ">" : " ");
         canvas_draw_str(canvas, 8, y, "Erase all profiles");
         return;
     }
@@ -1090,18 +533,16 @@ static void draw_callback(Canvas* canvas, void* model) {
         return;
     }
 
-    char bal_buf[16];
-    snprintf(bal_buf, sizeof(bal_buf), "$%u", s->balance);
-    canvas_draw_str(canvas, 0, 10, bal_buf);
+    render_cache_update(canvas, s, &m->render, &m->practice);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 0, 10, rc->balance);
 
     if(s->phase == PhaseBetting) {
         /* Betting phase - more space for bet amount and chips */
         canvas_set_font(canvas, FontPrimary);
-        char bet_buf[20];
-        snprintf(bet_buf, sizeof(bet_buf), "Bet: $%u", s->current_bet);
-        canvas_draw_str(canvas, 0, 28, bet_buf);
+        canvas_draw_str(canvas, 0, 28, rc->bet_big);
         /* Draw chip stack that grows with bet amount - positioned after bet text */
-        int chip_x = canvas_string_width(canvas, bet_buf) + 8;
+        int chip_x = rc->bet_big_w + 8;
         draw_chip_stack(canvas, chip_x, 24, s->current_bet);
         canvas_set_font(canvas, FontSecondary);
     } else if(s->phase == PhaseStatistics) {
@@ -1139,6 +580,10 @@ static void draw_callback(Canvas* canvas, void* model) {
                 }
                 break;
             }
+            case 5:
+                /* Seed and shoe number: enough to replay this shoe with the host tools */
+                snprintf(stat_buf, sizeof(stat_buf), "Shoe: %08lX #%lu", (unsigned long)s->rng_seed, (unsigned long)s->shoe_number);
+                break;
             default:
                 stat_buf[0] = '\0';
                 break;
@@ -1213,12 +658,7 @@ static void draw_callback(Canvas* canvas, void* model) {
         const char* split_controls = "Down=Yes  Back=No";
         int ctrl_x = box_x + (box_w - canvas_string_width(canvas, split_controls)) / 2;
         canvas_draw_str(canvas, ctrl_x, box_y + 22, split_controls);
-        if(s->practice_mode) {
-            const char* hint = wizard_strategy_hint(s->player_hand, 2, s->dealer_hand[1], false, true);
-            char buf[24];
-            snprintf(buf, sizeof(buf), "Strategy: %s", hint);
-            canvas_draw_str(canvas, 0, 52, buf);
-        }
+        draw_practice(canvas, rc);
         canvas_set_font(canvas, FontSecondary);
     } else if(s->phase == PhaseInsurancePrompt) {
         int box_x = 10;
@@ -1237,10 +677,7 @@ static void draw_callback(Canvas* canvas, void* model) {
     } else if(s->phase == PhaseDeal || s->phase == PhasePlayerTurn || s->phase == PhaseDealerTurn || s->phase == PhaseShowFinalCards || s->phase == PhaseResult) {
         /* Show bet amount on right side */
         canvas_set_font(canvas, FontSecondary);
-        char bet_buf[20];
-        snprintf(bet_buf, sizeof(bet_buf), "Bet:$%u", s->current_bet);
-        int bet_width = canvas_string_width(canvas, bet_buf);
-        canvas_draw_str(canvas, 128 - bet_width, 10, bet_buf);
+        canvas_draw_str(canvas, 128 - rc->bet_w, 10, rc->bet);
 
         /* Draw dealer cards - left side, overlay cards 3+ on bottom half (moved up to avoid footer) */
         canvas_set_font(canvas, FontPrimary);
@@ -1261,7 +698,7 @@ static void draw_callback(Canvas* canvas, void* model) {
                 int base_y = card_y + (base_row * 24);
                 y = base_y + 11; /* Overlay on bottom half (card is 22px, so +11px) */
             }
-            draw_card_graphic(canvas, x, y, s->dealer_hand[i], (i == 0 && s->dealer_hole));
+            draw_card_graphic(canvas, x, y, s->dealer_hand[i], (i == 0 && s->dealer_hole), i >= 2);
         }
 
         /* Draw player cards - right side, overlay cards 3+ on bottom half (moved up to avoid footer) */
@@ -1271,50 +708,15 @@ static void draw_callback(Canvas* canvas, void* model) {
             /* Hand 1 */
             canvas_draw_str(canvas, 54, 24, s->active_hand == 0 ? "P1:*" : "P1:"); /* * indicates active */
             canvas_set_font(canvas, FontSecondary);
-            char hand1_buf[32] = "";
-            int hand1_len = 0;
-            for(uint8_t i = 0; i < s->player_count && hand1_len < (int)sizeof(hand1_buf) - 4; i++) {
-                char card_buf[8];
-                int len = snprintf(card_buf, sizeof(card_buf), "%s%c ", card_rank_str(s->player_hand[i]), card_suit_char(s->player_hand[i]));
-                if(hand1_len + len < (int)sizeof(hand1_buf)) {
-                    strncpy(hand1_buf + hand1_len, card_buf, sizeof(hand1_buf) - hand1_len);
-                    hand1_len += len;
-                }
-            }
-            canvas_draw_str(canvas, 70, 24, hand1_buf);
-            uint8_t pv1_soft, pv1_hard;
-            hand_values_soft_hard(s->player_hand, s->player_count, &pv1_soft, &pv1_hard);
-            char vbuf[16];
-            if(pv1_soft != pv1_hard && pv1_soft <= 21) {
-                snprintf(vbuf, sizeof(vbuf), "%u or %u", pv1_soft, pv1_hard);
-            } else {
-                snprintf(vbuf, sizeof(vbuf), "%u", pv1_soft);
-            }
-            canvas_draw_str(canvas, 54, 32, vbuf);
+            canvas_draw_str(canvas, 70, 24, rc->split_hand[0]);
+            canvas_draw_str(canvas, 54, 32, rc->player_total[0]);
             
             /* Hand 2 */
             canvas_set_font(canvas, FontPrimary);
             canvas_draw_str(canvas, 54, 40, s->active_hand == 1 ? "P2:*" : "P2:");
             canvas_set_font(canvas, FontSecondary);
-            char hand2_buf[32] = "";
-            int hand2_len = 0;
-            for(uint8_t i = 0; i < s->player_count2 && hand2_len < (int)sizeof(hand2_buf) - 4; i++) {
-                char card_buf[8];
-                int len = snprintf(card_buf, sizeof(card_buf), "%s%c ", card_rank_str(s->player_hand2[i]), card_suit_char(s->player_hand2[i]));
-                if(hand2_len + len < (int)sizeof(hand2_buf)) {
-                    strncpy(hand2_buf + hand2_len, card_buf, sizeof(hand2_buf) - hand2_len);
-                    hand2_len += len;
-                }
-            }
-            canvas_draw_str(canvas, 70, 40, hand2_buf);
-            uint8_t pv2_soft, pv2_hard;
-            hand_values_soft_hard(s->player_hand2, s->player_count2, &pv2_soft, &pv2_hard);
-            if(pv2_soft != pv2_hard && pv2_soft <= 21) {
-                snprintf(vbuf, sizeof(vbuf), "%u or %u", pv2_soft, pv2_hard);
-            } else {
-                snprintf(vbuf, sizeof(vbuf), "%u", pv2_soft);
-            }
-            canvas_draw_str(canvas, 54, 48, vbuf);
+            canvas_draw_str(canvas, 70, 40, rc->split_hand[1]);
+            canvas_draw_str(canvas, 54, 48, rc->player_total[1]);
         } else {
             /* Single hand */
             canvas_draw_str(canvas, 54, 24, "P:"); /* Moved left to avoid covering first card */
@@ -1334,43 +736,20 @@ static void draw_callback(Canvas* canvas, void* model) {
                     int base_y = card_y + (base_row * 24);
                     y = base_y + 11; /* Overlay on bottom half (card is 22px, so +11px) */
                 }
-                draw_card_graphic(canvas, x, y, s->player_hand[i], false);
+                draw_card_graphic(canvas, x, y, s->player_hand[i], false, i >= 2);
             }
             /* Draw player hand value directly underneath "P:" label - show soft/hard for aces */
-            uint8_t pv_soft, pv_hard;
-            hand_values_soft_hard(s->player_hand, s->player_count, &pv_soft, &pv_hard);
-            char vbuf[16];
-            if(pv_soft != pv_hard && pv_soft <= 21) {
-                snprintf(vbuf, sizeof(vbuf), "%u or %u", pv_soft, pv_hard);
-            } else {
-                snprintf(vbuf, sizeof(vbuf), "%u", pv_soft);
-            }
             canvas_set_font(canvas, FontSecondary);
-            canvas_draw_str(canvas, 54, 32, vbuf);
+            if(s->player_count > 0) canvas_draw_str(canvas, 54, 32, rc->player_total[0]);
         }
         /* Draw dealer hand value with soft/hard for aces */
         if(!s->dealer_hole && s->dealer_count > 0) {
-            uint8_t dv_soft, dv_hard;
-            hand_values_soft_hard(s->dealer_hand, s->dealer_count, &dv_soft, &dv_hard);
-            char dvbuf[16];
-            if(dv_soft != dv_hard && dv_soft <= 21) {
-                snprintf(dvbuf, sizeof(dvbuf), "%u or %u", dv_soft, dv_hard);
-            } else {
-                snprintf(dvbuf, sizeof(dvbuf), "%u", dv_soft);
-            }
             canvas_set_font(canvas, FontSecondary);
-            canvas_draw_str(canvas, 0, 32, dvbuf);
+            canvas_draw_str(canvas, 0, 32, rc->dealer_total);
         }
 
         canvas_set_font(canvas, FontSecondary);
-        if(s->phase == PhasePlayerTurn && s->practice_mode) {
-            const uint8_t* ph = (s->is_split && s->active_hand == 1) ? s->player_hand2 : s->player_hand;
-            uint8_t pc = (s->is_split && s->active_hand == 1) ? s->player_count2 : s->player_count;
-            const char* hint = wizard_strategy_hint(ph, pc, s->dealer_hand[1], s->can_double_down, s->can_split);
-            char buf[24];
-            snprintf(buf, sizeof(buf), "Strategy: %s", hint);
-            canvas_draw_str(canvas, 0, 52, buf);
-        }
+        if(s->phase == PhasePlayerTurn) draw_practice(canvas, rc);
         if(s->phase == PhaseResult) {
             /* Draw result box overlay - white box with black outline (larger) */
             int box_x = 10;
@@ -1385,513 +764,610 @@ static void draw_callback(Canvas* canvas, void* model) {
             canvas_draw_frame(canvas, box_x, box_y, box_w, box_h);
             /* Result text inside box */
             canvas_set_font(canvas, FontPrimary);
-            uint8_t pv_final = hand_value(s->player_hand, s->player_count);
-            uint8_t dv_final = hand_value(s->dealer_hand, s->dealer_count);
-            char result_text[32];
-            if(s->is_split) {
-                uint8_t pv2_final = hand_value(s->player_hand2, s->player_count2);
-                snprintf(result_text, sizeof(result_text), "P1:%u P2:%u D:%u", pv_final, pv2_final, dv_final);
-            } else {
-                snprintf(result_text, sizeof(result_text), "P:%u D:%u", pv_final, dv_final);
-            }
-            int text_x = box_x + (box_w - canvas_string_width(canvas, result_text)) / 2;
-            canvas_draw_str(canvas, text_x, box_y + 12, result_text);
+            canvas_draw_str(canvas, box_x + (box_w - rc->result_w) / 2, box_y + 12, rc->result);
             /* Result message centered */
-            int msg_x = box_x + (box_w - canvas_string_width(canvas, s->result_msg)) / 2;
+            int msg_x = box_x + (box_w - rc->msg_w) / 2;
             canvas_draw_str(canvas, msg_x, box_y + 28, s->result_msg);
         }
     }
 }
 
-typedef struct {
-    View* view;
-    ViewDispatcher* view_dispatcher;
-} BlackjackApp;
+static uint32_t view_hash_bytes(uint32_t h, const void* data, size_t len) {
+    const uint8_t* p = data;
+    for(size_t i = 0; i < len; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
 
-static bool input_callback(InputEvent* event, void* context) {
-    BlackjackApp* app = (BlackjackApp*)context;
-    if(event->type != InputTypePress) return false;
+/* FNV-1a over every field draw_callback reads (totals, hints and EV follow from the cards) */
+static uint32_t view_hash(const BlackjackState* s) {
+    uint32_t h = 2166136261u;
+#define VIEW_HASH(field) h = view_hash_bytes(h, &s->field, sizeof(s->field))
+    uint8_t flags = s->dealer_hole | s->is_split << 1 | s->can_double_down << 2 | s->can_split << 3 |
+                    s->practice_mode << 4 | s->sound_on << 5 | s->vibro_on << 6 | s->dealer_hits_soft17 << 7;
+    h = view_hash_bytes(h, &flags, 1);
+    VIEW_HASH(phase);
+    VIEW_HASH(splash_selection);
+    VIEW_HASH(profile_menu_selection);
+    VIEW_HASH(stat_scroll);
+    VIEW_HASH(help_scroll);
+    VIEW_HASH(balance);
+    VIEW_HASH(current_bet);
+    VIEW_HASH(deck_top);
+    VIEW_HASH(player_hand);
+    VIEW_HASH(player_count);
+    VIEW_HASH(player_hand2);
+    VIEW_HASH(player_count2);
+    VIEW_HASH(dealer_hand);
+    VIEW_HASH(dealer_count);
+    VIEW_HASH(active_hand);
+    VIEW_HASH(result_msg);
+    VIEW_HASH(games_played);
+    VIEW_HASH(games_won);
+    VIEW_HASH(games_lost);
+    VIEW_HASH(games_pushed);
+    VIEW_HASH(rng_seed);
+    VIEW_HASH(shoe_number);
+    VIEW_HASH(profile_names);
+    VIEW_HASH(cut_card);
+    uint8_t deal_speed = s->deal_speed;
+    h = view_hash_bytes(h, &deal_speed, 1);
+#undef VIEW_HASH
+    return h;
+}
 
-    BlackjackState* s = (BlackjackState*)view_get_model(app->view);
-    if(!s) return false;
+/* Encode a settled round for the hand history; blackjack_run_deferred logs it */
+static void blackjack_log_round(BlackjackApp* app, const BlackjackState* s) {
+    BlackjackDeferred* d = &app->deferred;
+    d->session_size = app->history_session_logged ? 0 : (uint8_t)history_encode_session(d->log, s->rng_seed);
+    d->log_size = d->session_size + (uint8_t)history_encode_hand(d->log + d->session_size, s);
+}
 
-    if(event->key == InputKeyBack) {
-        if(s->phase == PhaseHelp) {
-            /* Return from help to previous phase */
-            s->phase = s->prev_phase;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseInsurancePrompt) {
-            resolve_insurance(s, false);  /* No insurance */
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseSplitPrompt) {
-            /* Decline split - continue with normal play */
-            s->phase = PhasePlayerTurn;
-            s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
-            s->can_split = false;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseStatistics) {
-            /* Return from statistics to result screen */
-            s->phase = PhaseResult;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseSplash) {
-            view_commit_model(app->view, false);
-            view_dispatcher_stop(app->view_dispatcher);
-            return true;
-        }
-        if(s->phase == PhaseSettings) {
-            s->phase = PhaseSplash;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseConfirmErase) {
-            s->phase = PhaseSettings;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseProfileMenu) {
-            view_commit_model(app->view, false);
-            view_dispatcher_stop(app->view_dispatcher);
-            return true;
-        }
-        if(s->phase == PhaseResult || s->phase == PhaseBetting) {
-            if(s->is_guest) {
-                s->phase = PhaseGuestSavePrompt;
-                s->profile_menu_selection = 0;  /* No */
-                view_commit_model(app->view, true);
-                return true;
-            }
-            Storage* storage = furi_record_open(RECORD_STORAGE);
-            profile_save_current(storage, s);
-            furi_record_close(RECORD_STORAGE);
-            s->phase = PhaseProfileMenu;
-            s->profile_menu_selection = 0;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhasePlayerTurn) {
-            game_player_stand(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
-        view_commit_model(app->view, false);
-        return false;
+/* After the model is unlocked: log the round to the history ring (the result screen is idle
+ * time, so a batch is written from there once enough has piled up), queue store and history
+ * writes, and play the feedback */
+static void blackjack_run_deferred(BlackjackApp* app) {
+    BlackjackDeferred* d = &app->deferred;
+    if(d->log_size) {
+        if(d->session_size) {
+            app->history_session_logged = store_worker_log(app->store_worker, d->log, d->session_size);
+        }
+        store_worker_log(app->store_worker, d->log + d->session_size, d->log_size - d->session_size);
+        store_worker_flush_log(app->store_worker, HISTORY_FLUSH_BYTES);
     }
-    if(event->key == InputKeyOk) {
-        if(s->phase == PhaseSplash) {
-            Storage* storage = furi_record_open(RECORD_STORAGE);
-            profile_ensure_dir(storage);
-            profile_load_list(storage, s);
-            switch(s->splash_selection) {
-            case 0: /* Continue */
-                profile_load_slot(storage, s, profile_load_last_used(storage));
-                s->is_guest = false;
-                s->practice_mode = false;
-                furi_record_close(RECORD_STORAGE);
-                game_start_betting(s);
-                break;
-            case 1: /* New profile */
-                profile_create_new(s);
-                s->is_guest = false;
-                s->practice_mode = false;
-                profile_save_last_used(storage, s->current_profile_slot);
-                furi_record_close(RECORD_STORAGE);
-                game_start_betting(s);
-                break;
-            case 2: /* Guest */
-                s->balance = STARTING_BALANCE;
-                s->games_played = s->games_won = s->games_lost = s->games_pushed = 0;
-                s->current_profile_slot = 0;
-                s->is_guest = true;
-                s->practice_mode = false;
-                furi_record_close(RECORD_STORAGE);
-                game_start_betting(s);
-                break;
-            case 3: /* Practice */
-                s->balance = STARTING_BALANCE;
-                s->games_played = s->games_won = s->games_lost = s->games_pushed = 0;
-                s->current_profile_slot = 0;
-                s->is_guest = true;
-                s->practice_mode = true;
-                furi_record_close(RECORD_STORAGE);
-                game_start_betting(s);
-                break;
-            case 4: /* Help */
-                s->prev_phase = PhaseSplash;
-                s->phase = PhaseHelp;
-                furi_record_close(RECORD_STORAGE);
-                break;
-            case 5: /* Settings */
-                s->phase = PhaseSettings;
-                s->profile_menu_selection = 0;
-                furi_record_close(RECORD_STORAGE);
-                break;
-            default:
-                furi_record_close(RECORD_STORAGE);
-                break;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseSettings) {
-            /* 0=Sound, 1=Vibro, 2=Dealer S17, 3=Erase all */
-            if(s->profile_menu_selection < 3) {
-                if(s->profile_menu_selection == 0) s->sound_on = !s->sound_on;
-                else if(s->profile_menu_selection == 1) s->vibro_on = !s->vibro_on;
-                else s->dealer_hits_soft17 = !s->dealer_hits_soft17;
-                Storage* storage = furi_record_open(RECORD_STORAGE);
-                settings_save(storage, s);
-                furi_record_close(RECORD_STORAGE);
-            } else {
-                s->phase = PhaseConfirmErase;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseConfirmErase) {
-            Storage* storage = furi_record_open(RECORD_STORAGE);
-            profile_erase_all(storage, s);
-            furi_record_close(RECORD_STORAGE);
-            s->phase = PhaseSplash;
-            s->splash_selection = 0;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseInsurancePrompt) {
-            bool took = (s->profile_menu_selection == 1);
-            resolve_insurance(s, took);
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseGuestSavePrompt) {
-            if(s->profile_menu_selection == 0) {
-                s->phase = PhaseSplash;
-                s->is_guest = false;
-            } else {
-                s->phase = PhaseGuestPickProfile;
-                s->profile_menu_selection = 0;
-                Storage* storage = furi_record_open(RECORD_STORAGE);
-                profile_load_list(storage, s);
-                furi_record_close(RECORD_STORAGE);
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseGuestPickProfile) {
-            Storage* storage = furi_record_open(RECORD_STORAGE);
-            if(s->profile_menu_selection < MAX_PROFILES) {
-                profile_save_guest_to_slot(storage, s, s->profile_menu_selection);
-            } else {
-                uint8_t slot = 0;
-                for(; slot < MAX_PROFILES && s->profile_names[slot][0] != '\0'; slot++) { }
-                if(slot >= MAX_PROFILES) slot = 0;
-                s->current_profile_slot = slot;
-                snprintf(s->profile_names[slot], PROFILE_NAME_LEN, "Player %u", (unsigned)(slot + 1));
-                profile_save_current(storage, s);
-            }
-            furi_record_close(RECORD_STORAGE);
-            s->is_guest = false;
-            s->phase = PhaseSplash;
-            s->splash_selection = 0;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseProfileMenu) {
-            Storage* storage = furi_record_open(RECORD_STORAGE);
-            profile_ensure_dir(storage);
-            profile_load_list(storage, s);
-            if(s->profile_menu_selection < MAX_PROFILES) {
-                profile_load_slot(storage, s, s->profile_menu_selection);
-            } else {
-                profile_create_new(s);
-            }
-            furi_record_close(RECORD_STORAGE);
-            game_start_betting(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseReshuffle) {
-            /* Continue after reshuffle */
-            s->reshuffle_announced = true;
-            /* If we were dealing, continue */
-            if(s->player_count < 2 || s->dealer_count < 2) {
-                s->phase = PhaseDeal;
-                /* Continue dealing */
-                while(s->player_count < 2) {
-                    s->player_hand[s->player_count++] = draw_card(s);
-                    if(!s->reshuffle_announced) {
-                        s->phase = PhaseReshuffle;
-                        view_commit_model(app->view, true);
-                        return true;
-                    }
-                }
-                while(s->dealer_count < 2) {
-                    s->dealer_hand[s->dealer_count++] = draw_card(s);
-                    if(!s->reshuffle_announced) {
-                        s->phase = PhaseReshuffle;
-                        view_commit_model(app->view, true);
-                        return true;
-                    }
-                }
-                /* Finish dealing - same rules as game_deal_cards */
-                uint8_t pv = hand_value(s->player_hand, s->player_count);
-                bool player_bj = (s->player_count == 2 && pv == 21);
-                if(player_bj) {
-                    s->is_blackjack = true;
-                    s->dealer_hole = false;
-                    s->phase = PhaseShowFinalCards;
-                    uint8_t dv = hand_value(s->dealer_hand, s->dealer_count);
-                    if(dv == 21) {
-                        s->balance += s->current_bet;
-                        snprintf(s->result_msg, sizeof(s->result_msg), "Push. +$%u", s->current_bet);
-                    } else {
-                        uint16_t payout = s->current_bet + (s->current_bet * 3 / 2);
-                        s->balance += payout;
-                        snprintf(s->result_msg, sizeof(s->result_msg), "Blackjack! +$%u", payout);
-                    }
-                    s->result_msg[sizeof(s->result_msg) - 1] = '\0';
-                } else {
-                    uint8_t dealer_up_rank = s->dealer_hand[1] % 13;
-                    bool dealer_up_is_ace = (dealer_up_rank == 12);
-                    bool dealer_up_is_10 = (dealer_up_rank >= 8 && dealer_up_rank <= 11);
-                    if(dealer_up_is_ace) {
-                        s->phase = PhaseInsurancePrompt;
-                        s->profile_menu_selection = 0;
-                        view_commit_model(app->view, true);
-                        return true;
-                    }
-                    if(dealer_up_is_10) {
-                        uint8_t dv = hand_value(s->dealer_hand, s->dealer_count);
-                        if(dv == 21) {
-                            s->dealer_hole = false;
-                            s->games_played++;
-                            s->games_lost++;
-                            snprintf(s->result_msg, sizeof(s->result_msg), "Dealer blackjack. -$%u", s->current_bet);
-                            s->result_msg[sizeof(s->result_msg) - 1] = '\0';
-                            s->phase = PhaseResult;
-                            view_commit_model(app->view, true);
-                            return true;
-                        }
-                    }
-                    bool is_pair = (s->player_count == 2 && CARD_RANK(s->player_hand[0]) == CARD_RANK(s->player_hand[1]));
-                    s->can_split = (is_pair && (s->balance >= s->current_bet));
-                    if(s->can_split) {
-                        s->phase = PhaseSplitPrompt;
-                    } else {
-                        s->phase = PhasePlayerTurn;
-                        s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
-                    }
-                }
-            } else {
-                /* Return to player turn */
-                s->phase = PhasePlayerTurn;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseBetting) {
-            game_place_bet(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseShowFinalCards) {
-            game_show_result(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseResult) {
-            /* Bet Again - restore original bet, deduct, and deal */
-            s->current_bet = s->base_bet;
-            if(s->current_bet > s->balance) s->current_bet = (s->balance < MIN_BET) ? 0 : s->balance;
-            if(s->current_bet > 0 && s->current_bet <= s->balance) {
-                s->balance -= s->current_bet;
-                s->insurance_bet = 0;
-                game_deal_cards(s);
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhasePlayerTurn) {
-            game_player_hit(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
+    if(d->flush_log) store_worker_flush_log(app->store_worker, 0);
+    if(d->save) store_worker_save(app->store_worker, &app->store, NULL, NULL);
+    if(d->deal_delay_ms) furi_timer_start(app->deal_timer, furi_ms_to_ticks(d->deal_delay_ms));
+    blackjack_play_feedback(d->feedback);
+    memset(d, 0, sizeof(*d));
+}
+
+/* Commit the model after input, redrawing only if the screen would change: a key the
+ * phase ignores, or a bet or scroll already at its limit, costs no frame */
+static void blackjack_commit(BlackjackApp* app, BlackjackState* s) {
+    if(s->events & GameEventRoundOver) {
+        blackjack_log_round(app, s);
+        s->events &= ~GameEventRoundOver;
     }
-    if(event->key == InputKeyLeft) {
-        if(s->phase == PhaseBetting) {
-            if(s->current_bet > MIN_BET) {
-                s->current_bet -= BET_INCREMENT;
-                if(s->current_bet < MIN_BET) s->current_bet = MIN_BET;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseResult) {
-            /* Change Bet - go back to betting screen */
-            game_start_betting(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
+    uint32_t h = view_hash(s);
+    bool changed = h != app->drawn_hash;
+    if(changed) {
+        app->drawn_hash = h;
+    } else {
+        app->redraws_skipped++;
     }
-    if(event->key == InputKeyRight) {
-        if(s->phase == PhaseBetting) {
-            uint16_t max_bet = (s->balance < MAX_BET) ? s->balance : MAX_BET;
-            if(s->current_bet < max_bet) {
-                s->current_bet += BET_INCREMENT;
-                if(s->current_bet > max_bet) s->current_bet = max_bet;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseResult) {
-            /* Open statistics window */
-            game_show_statistics(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhasePlayerTurn || s->phase == PhaseShowFinalCards) {
-            /* Open help screen */
-            game_show_help(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
+    view_commit_model(app->view, changed);
+}
+
+/* What an input handler did with the key */
+typedef enum {
+    InputIgnored, /* Nothing: the model is committed untouched and the event passed on */
+    InputHandled, /* Committed through blackjack_commit */
+    InputExit, /* Leave the app */
+} InputResult;
+
+/* Called with the model locked; one per phase and key in input_handlers */
+typedef InputResult (*InputHandler)(BlackjackApp* app, BlackjackState* s);
+
+static InputResult input_exit(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    UNUSED(s);
+    return InputExit;
+}
+
+/* Splash */
+
+static InputResult input_splash_up(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->splash_selection == 0) s->splash_selection = SPLASH_OPTIONS - 1;
+    else s->splash_selection--;
+    return InputHandled;
+}
+
+static InputResult input_splash_down(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->splash_selection >= SPLASH_OPTIONS - 1) s->splash_selection = 0;
+    else s->splash_selection++;
+    return InputHandled;
+}
+
+static InputResult input_splash_ok(BlackjackApp* app, BlackjackState* s) {
+    store_get_names(&app->store, s);
+    switch(s->splash_selection) {
+    case 0: /* Continue */
+        store_get_profile(&app->store, s, store_last_used(&app->store));
+        s->is_guest = false;
+        s->practice_mode = false;
+        game_start_betting(s);
+        break;
+    case 1: /* New profile */
+        profile_create_new(s);
+        s->is_guest = false;
+        s->practice_mode = false;
+        store_set_last_used(&app->store, s->current_profile_slot);
+        profile_store_flush(app);
+        game_start_betting(s);
+        break;
+    case 2: /* Guest */
+        s->balance = STARTING_BALANCE;
+        s->games_played = s->games_won = s->games_lost = s->games_pushed = 0;
+        s->current_profile_slot = 0;
+        s->is_guest = true;
+        s->practice_mode = false;
+        game_start_betting(s);
+        break;
+    case 3: /* Practice */
+        s->balance = STARTING_BALANCE;
+        s->games_played = s->games_won = s->games_lost = s->games_pushed = 0;
+        s->current_profile_slot = 0;
+        s->is_guest = true;
+        s->practice_mode = true;
+        game_start_betting(s);
+        break;
+    case 4: /* Help */
+        s->prev_phase = PhaseSplash;
+        s->phase = PhaseHelp;
+        break;
+    case 5: /* Settings */
+        s->phase = PhaseSettings;
+        s->profile_menu_selection = 0;
+        break;
+    default:
+        break;
     }
-    if(event->key == InputKeyUp) {
-        if(s->phase == PhaseSplash) {
-            if(s->splash_selection == 0) s->splash_selection = SPLASH_OPTIONS - 1;
-            else s->splash_selection--;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseHelp) {
-            if(s->help_scroll > 0) s->help_scroll--;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseInsurancePrompt) {
-            s->profile_menu_selection = 0;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseGuestSavePrompt) {
-            s->profile_menu_selection = 0;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseGuestPickProfile) {
-            if(s->profile_menu_selection == 0) s->profile_menu_selection = MAX_PROFILES;
-            else s->profile_menu_selection--;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseProfileMenu) {
-            if(s->profile_menu_selection == 0) {
-                s->profile_menu_selection = MAX_PROFILES;
-            } else {
-                s->profile_menu_selection--;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseSettings) {
-            if(s->profile_menu_selection == 0) s->profile_menu_selection = 3;
-            else s->profile_menu_selection--;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseStatistics) {
-            /* Scroll up - at top wrap to bottom */
-            if(s->stat_scroll == 0) {
-                s->stat_scroll = STAT_MAX_SCROLL;
-            } else {
-                s->stat_scroll--;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhasePlayerTurn) {
-            game_player_double_down(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
+    return InputHandled;
+}
+
+/* Profile menu and the guest's pick of a slot: MAX_PROFILES slots, then "New" */
+
+static InputResult input_profile_up(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->profile_menu_selection == 0) s->profile_menu_selection = MAX_PROFILES;
+    else s->profile_menu_selection--;
+    return InputHandled;
+}
+
+static InputResult input_profile_down(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->profile_menu_selection >= MAX_PROFILES) s->profile_menu_selection = 0;
+    else s->profile_menu_selection++;
+    return InputHandled;
+}
+
+static InputResult input_profile_ok(BlackjackApp* app, BlackjackState* s) {
+    store_get_names(&app->store, s);
+    if(s->profile_menu_selection < MAX_PROFILES) {
+        store_get_profile(&app->store, s, s->profile_menu_selection);
+    } else {
+        profile_create_new(s);
     }
-    if(event->key == InputKeyDown) {
-        if(s->phase == PhaseSplash) {
-            if(s->splash_selection >= SPLASH_OPTIONS - 1) s->splash_selection = 0;
-            else s->splash_selection++;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseHelp) {
-            if(s->help_scroll < HELP_MAX_SCROLL) s->help_scroll++;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseInsurancePrompt) {
-            s->profile_menu_selection = 1;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseGuestSavePrompt) {
-            s->profile_menu_selection = 1;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseGuestPickProfile) {
-            if(s->profile_menu_selection >= MAX_PROFILES) s->profile_menu_selection = 0;
-            else s->profile_menu_selection++;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseProfileMenu) {
-            if(s->profile_menu_selection >= MAX_PROFILES) {
-                s->profile_menu_selection = 0;
-            } else {
-                s->profile_menu_selection++;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseSettings) {
-            if(s->profile_menu_selection >= 3) s->profile_menu_selection = 0;
-            else s->profile_menu_selection++;
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseStatistics) {
-            /* Scroll down - at bottom wrap to top */
-            if(s->stat_scroll >= STAT_MAX_SCROLL) {
-                s->stat_scroll = 0;
-            } else {
-                s->stat_scroll++;
-            }
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhaseSplitPrompt) {
-            /* Accept split */
-            game_player_split(s);
-            view_commit_model(app->view, true);
-            return true;
-        }
-        if(s->phase == PhasePlayerTurn) {
-            /* Allow split from player turn if still available */
-            if(s->can_split) {
-                s->phase = PhaseSplitPrompt;
-                view_commit_model(app->view, true);
-                return true;
-            }
-        }
+    game_start_betting(s);
+    return InputHandled;
+}
+
+static InputResult input_guest_pick_ok(BlackjackApp* app, BlackjackState* s) {
+    if(s->profile_menu_selection < MAX_PROFILES) {
+        profile_save_guest_to_slot(app, s, s->profile_menu_selection);
+    } else {
+        uint8_t slot = 0;
+        for(; slot < MAX_PROFILES && s->profile_names[slot][0] != '\0'; slot++) { }
+        if(slot >= MAX_PROFILES) slot = 0;
+        s->current_profile_slot = slot;
+        snprintf(s->profile_names[slot], PROFILE_NAME_LEN, "Player %u", (unsigned)(slot + 1));
+        profile_save_current(app, s);
     }
-    view_commit_model(app->view, false);
-    return false;
+    s->is_guest = false;
+    s->phase = PhaseSplash;
+    s->splash_selection = 0;
+    return InputHandled;
+}
+
+/* Yes/No prompts: Up is No, Down is Yes */
+
+static InputResult input_prompt_up(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    s->profile_menu_selection = 0;
+    return InputHandled;
+}
+
+static InputResult input_prompt_down(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    s->profile_menu_selection = 1;
+    return InputHandled;
+}
+
+static InputResult input_guest_save_ok(BlackjackApp* app, BlackjackState* s) {
+    if(s->profile_menu_selection == 0) {
+        s->phase = PhaseSplash;
+        s->is_guest = false;
+    } else {
+        s->phase = PhaseGuestPickProfile;
+        s->profile_menu_selection = 0;
+        store_get_names(&app->store, s);
+    }
+    return InputHandled;
+}
+
+static InputResult input_insurance_ok(BlackjackApp* app, BlackjackState* s) {
+    resolve_insurance(s, s->profile_menu_selection == 1);
+    blackjack_take_events(app, s);
+    return InputHandled;
+}
+
+static InputResult input_insurance_back(BlackjackApp* app, BlackjackState* s) {
+    resolve_insurance(s, false); /* No insurance */
+    blackjack_take_events(app, s);
+    return InputHandled;
+}
+
+/* Settings */
+
+static InputResult input_settings_up(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->profile_menu_selection == 0) s->profile_menu_selection = SETTINGS_OPTIONS - 1;
+    else s->profile_menu_selection--;
+    return InputHandled;
+}
+
+static InputResult input_settings_down(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->profile_menu_selection >= SETTINGS_OPTIONS - 1) s->profile_menu_selection = 0;
+    else s->profile_menu_selection++;
+    return InputHandled;
+}
+
+static InputResult input_settings_ok(BlackjackApp* app, BlackjackState* s) {
+    /* 0=Sound, 1=Vibro, 2=Dealer S17, 3=Penetration, 4=Deal, 5=Erase all */
+    if(s->profile_menu_selection < SETTINGS_OPTIONS - 1) {
+        if(s->profile_menu_selection == 0) s->sound_on = !s->sound_on;
+        else if(s->profile_menu_selection == 1) s->vibro_on = !s->vibro_on;
+        else if(s->profile_menu_selection == 2) s->dealer_hits_soft17 = !s->dealer_hits_soft17;
+        else if(s->profile_menu_selection == 3) s->cut_card = cut_card_next(s->cut_card);
+        else s->deal_speed = (s->deal_speed + 1) % DealSpeedCount;
+        store_put_settings(&app->store, s);
+        profile_store_flush(app);
+    } else {
+        s->phase = PhaseConfirmErase;
+    }
+    return InputHandled;
+}
+
+static InputResult input_settings_back(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    s->phase = PhaseSplash;
+    return InputHandled;
+}
+
+static InputResult input_erase_ok(BlackjackApp* app, BlackjackState* s) {
+    profile_erase_all(app, s);
+    s->phase = PhaseSplash;
+    s->splash_selection = 0;
+    return InputHandled;
+}
+
+static InputResult input_erase_back(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    s->phase = PhaseSettings;
+    return InputHandled;
+}
+
+/* Betting and the result screen */
+
+static InputResult input_bet_down(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->current_bet > MIN_BET) {
+        s->current_bet -= BET_INCREMENT;
+        if(s->current_bet < MIN_BET) s->current_bet = MIN_BET;
+        s->dirty |= GameDirtyBank;
+    }
+    return InputHandled;
+}
+
+static InputResult input_bet_up(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    uint16_t max_bet = (s->balance < MAX_BET) ? s->balance : MAX_BET;
+    if(s->current_bet < max_bet) {
+        s->current_bet += BET_INCREMENT;
+        if(s->current_bet > max_bet) s->current_bet = max_bet;
+        s->dirty |= GameDirtyBank;
+    }
+    return InputHandled;
+}
+
+static InputResult input_bet_place(BlackjackApp* app, BlackjackState* s) {
+    game_place_bet(s);
+    blackjack_take_events(app, s);
+    return InputHandled;
+}
+
+static InputResult input_bet_again(BlackjackApp* app, BlackjackState* s) {
+    /* Bet Again - restore original bet, deduct, and deal */
+    game_bet_again(s);
+    blackjack_take_events(app, s);
+    return InputHandled;
+}
+
+static InputResult input_bet_change(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    game_start_betting(s);
+    return InputHandled;
+}
+
+static InputResult input_leave_table(BlackjackApp* app, BlackjackState* s) {
+    app->deferred.flush_log = true; /* Leaving the table: write the rest of the history */
+    s->profile_menu_selection = 0;
+    if(s->is_guest) {
+        s->phase = PhaseGuestSavePrompt; /* Selection 0 = No */
+        return InputHandled;
+    }
+    profile_save_current(app, s);
+    s->phase = PhaseProfileMenu;
+    return InputHandled;
+}
+
+static InputResult input_reshuffle_ok(BlackjackApp* app, BlackjackState* s) {
+    game_continue_deal(s);
+    blackjack_take_events(app, s);
+    return InputHandled;
+}
+
+static InputResult input_final_cards_ok(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    game_show_result(s);
+    return InputHandled;
+}
+
+/* Player turn */
+
+static InputResult input_hit(BlackjackApp* app, BlackjackState* s) {
+    game_player_hit(s);
+    blackjack_take_events(app, s);
+    return InputHandled;
+}
+
+static InputResult input_stand(BlackjackApp* app, BlackjackState* s) {
+    game_player_stand(s);
+    blackjack_take_events(app, s);
+    return InputHandled;
+}
+
+static InputResult input_double(BlackjackApp* app, BlackjackState* s) {
+    game_player_double_down(s);
+    blackjack_take_events(app, s);
+    return InputHandled;
+}
+
+static InputResult input_split_offer(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(!s->can_split) return InputIgnored;
+    s->phase = PhaseSplitPrompt;
+    return InputHandled;
+}
+
+static InputResult input_split_accept(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    game_player_split(s);
+    return InputHandled;
+}
+
+static InputResult input_split_decline(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    game_decline_split(s);
+    return InputHandled;
+}
+
+/* Statistics and help */
+
+static InputResult input_stats_show(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    game_show_statistics(s);
+    return InputHandled;
+}
+
+static InputResult input_stats_up(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    /* At the top wrap to the bottom */
+    if(s->stat_scroll == 0) s->stat_scroll = STAT_MAX_SCROLL;
+    else s->stat_scroll--;
+    return InputHandled;
+}
+
+static InputResult input_stats_down(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->stat_scroll >= STAT_MAX_SCROLL) s->stat_scroll = 0;
+    else s->stat_scroll++;
+    return InputHandled;
+}
+
+static InputResult input_stats_back(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    s->phase = PhaseResult;
+    return InputHandled;
+}
+
+static InputResult input_help_show(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    game_show_help(s);
+    return InputHandled;
+}
+
+static InputResult input_help_up(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->help_scroll > 0) s->help_scroll--;
+    return InputHandled;
+}
+
+static InputResult input_help_down(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    if(s->help_scroll < HELP_MAX_SCROLL) s->help_scroll++;
+    return InputHandled;
+}
+
+static InputResult input_help_back(BlackjackApp* app, BlackjackState* s) {
+    UNUSED(app);
+    s->phase = s->prev_phase;
+    return InputHandled;
+}
+
+/* Every key a phase answers; a missing entry ignores the key. A new phase or key gets a row
+ * or entry here, and bj_ui -E presses every pair. */
+static const InputHandler input_handlers[PhaseCount][InputKeyMAX] = {
+    [PhaseSplash] =
+        {[InputKeyUp] = input_splash_up,
+         [InputKeyDown] = input_splash_down,
+         [InputKeyOk] = input_splash_ok,
+         [InputKeyBack] = input_exit},
+    [PhaseProfileMenu] =
+        {[InputKeyUp] = input_profile_up,
+         [InputKeyDown] = input_profile_down,
+         [InputKeyOk] = input_profile_ok,
+         [InputKeyBack] = input_exit},
+    [PhaseBetting] =
+        {[InputKeyLeft] = input_bet_down,
+         [InputKeyRight] = input_bet_up,
+         [InputKeyOk] = input_bet_place,
+         [InputKeyBack] = input_leave_table},
+    [PhasePlayerTurn] =
+        {[InputKeyUp] = input_double,
+         [InputKeyDown] = input_split_offer,
+         [InputKeyRight] = input_help_show,
+         [InputKeyOk] = input_hit,
+         [InputKeyBack] = input_stand},
+    [PhaseSplitPrompt] = {[InputKeyDown] = input_split_accept, [InputKeyBack] = input_split_decline},
+    [PhaseInsurancePrompt] =
+        {[InputKeyUp] = input_prompt_up,
+         [InputKeyDown] = input_prompt_down,
+         [InputKeyOk] = input_insurance_ok,
+         [InputKeyBack] = input_insurance_back},
+    [PhaseShowFinalCards] = {[InputKeyRight] = input_help_show, [InputKeyOk] = input_final_cards_ok},
+    [PhaseResult] =
+        {[InputKeyRight] = input_stats_show,
+         [InputKeyLeft] = input_bet_change,
+         [InputKeyOk] = input_bet_again,
+         [InputKeyBack] = input_leave_table},
+    [PhaseStatistics] =
+        {[InputKeyUp] = input_stats_up, [InputKeyDown] = input_stats_down, [InputKeyBack] = input_stats_back},
+    [PhaseHelp] = {[InputKeyUp] = input_help_up, [InputKeyDown] = input_help_down, [InputKeyBack] = input_help_back},
+    [PhaseReshuffle] = {[InputKeyOk] = input_reshuffle_ok},
+    [PhaseGuestSavePrompt] =
+        {[InputKeyUp] = input_prompt_up, [InputKeyDown] = input_prompt_down, [InputKeyOk] = input_guest_save_ok},
+    [PhaseGuestPickProfile] =
+        {[InputKeyUp] = input_profile_up, [InputKeyDown] = input_profile_down, [InputKeyOk] = input_guest_pick_ok},
+    [PhaseSettings] =
+        {[InputKeyUp] = input_settings_up,
+         [InputKeyDown] = input_settings_down,
+         [InputKeyOk] = input_settings_ok,
+         [InputKeyBack] = input_settings_back},
+    [PhaseConfirmErase] = {[InputKeyOk] = input_erase_ok, [InputKeyBack] = input_erase_back},
+};
+
+/* A key press that started the deal or the dealer's play: deal it all now in fast mode, or
+ * have the deal timer deal a card a tick once the model is unlocked */
+static void blackjack_schedule_deal(BlackjackApp* app, BlackjackState* s) {
+    if(!game_is_dealing(s)) return;
+    app->deferred.deal_delay_ms = deal_delay_ms[s->deal_speed];
+    if(app->deferred.deal_delay_ms) return;
+    game_run(s);
+    blackjack_take_events(app, s);
+}
+
+/* Unlock the model after a key press or a dealing step, redrawing if it was handled; file how
+ * long the model was held under the phase it went from and to, then do the deferred work */
+static void blackjack_release(BlackjackApp* app, BlackjackState* s, uint8_t from, uint32_t locked_at, bool handled) {
+    uint8_t to = s->phase;
+    if(handled && s->practice_mode) {
+        /* The request copies the hand out of the state, so the worker never reads the model */
+        bool decision = s->phase == PhasePlayerTurn || s->phase == PhaseSplitPrompt;
+        practice_worker_request(app->practice_worker, decision ? s : NULL);
+    }
+    if(handled) {
+        blackjack_commit(app, s);
+    } else {
+        view_commit_model(app->view, false);
+    }
+    uint32_t held = (DWT->CYCCNT - locked_at) / furi_hal_cortex_instructions_per_microsecond();
+    lock_stats_add(&app->lock_stats, from, to, held);
+    blackjack_run_deferred(app);
+}
+
+static bool input_callback(InputEvent* event, void* context) {
+    BlackjackApp* app = (BlackjackApp*)context;
+    if(event->type != InputTypePress || event->key >= InputKeyMAX) return false;
+
+    BlackjackModel* model = view_get_model(app->view);
+    if(!model) return false;
+    uint32_t locked_at = DWT->CYCCNT;
+    BlackjackState* s = &model->game;
+    uint8_t from = s->phase;
+
+    InputHandler handler = s->phase < PhaseCount ? input_handlers[s->phase][event->key] : NULL;
+    InputResult result = handler ? handler(app, s) : InputIgnored;
+    if(result == InputHandled) blackjack_schedule_deal(app, s);
+    blackjack_release(app, s, from, locked_at, result == InputHandled);
+    if(result == InputExit) view_dispatcher_stop(app->view_dispatcher);
+    return result != InputIgnored;
+}
+
+/* Runs on the timer thread: hand the step to the view dispatcher thread, where key presses run */
+static void deal_timer_callback(void* context) {
+    BlackjackApp* app = (BlackjackApp*)context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BlackjackEventDealStep);
+}
+
+/* Runs on the practice worker thread */
+static void practice_ready_callback(void* context) {
+    BlackjackApp* app = (BlackjackApp*)context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BlackjackEventPracticeReady);
+}
+
+/* Show the worker's numbers if they are still for the hand on screen */
+static bool blackjack_practice_ready(BlackjackApp* app) {
+    PracticeNumbers numbers;
+    if(!practice_worker_result(app->practice_worker, &numbers)) return true;
+    BlackjackModel* model = view_get_model(app->view);
+    if(!model) return false;
+    bool fresh = numbers.key != model->practice.key && numbers.key == hand_ev_key(&model->game);
+    if(fresh) model->practice = numbers;
+    view_commit_model(app->view, fresh);
+    return true;
+}
+
+static bool custom_event_callback(void* context, uint32_t event) {
+    BlackjackApp* app = (BlackjackApp*)context;
+    if(event == BlackjackEventPracticeReady) return blackjack_practice_ready(app);
+    if(event != BlackjackEventDealStep) return false;
+
+    BlackjackModel* model = view_get_model(app->view);
+    if(!model) return false;
+    uint32_t locked_at = DWT->CYCCNT;
+    BlackjackState* s = &model->game;
+    uint8_t from = s->phase;
+
+    bool stepped = game_step(s);
+    blackjack_take_events(app, s);
+    bool dealing = game_is_dealing(s);
+    blackjack_release(app, s, from, locked_at, stepped);
+    if(!dealing) furi_timer_stop(app->deal_timer);
+    return true;
 }
 
 int32_t blackjack_app(void* p) {
@@ -1903,12 +1379,20 @@ int32_t blackjack_app(void* p) {
     app->view_dispatcher = view_dispatcher_alloc();
     app->view = view_alloc();
 
-    view_allocate_model(app->view, ViewModelTypeLocking, sizeof(BlackjackState));
+    view_allocate_model(app->view, ViewModelTypeLocking, sizeof(BlackjackModel));
     view_set_draw_callback(app->view, draw_callback);
     view_set_context(app->view, app);
     view_set_input_callback(app->view, input_callback);
 
-    BlackjackState* state = (BlackjackState*)view_get_model(app->view);
+    /* Read the SD card before taking the model: the GUI waits on it from here on */
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    store_load(&app->store, storage);
+    furi_record_close(RECORD_STORAGE);
+    app->store_worker = store_worker_alloc();
+    app->practice_worker = practice_worker_alloc(practice_ready_callback, app);
+
+    BlackjackState* state = &((BlackjackModel*)view_get_model(app->view))->game;
+    state->dirty = GameDirtyAll;
     state->balance = STARTING_BALANCE;
     state->current_bet = 0;
     state->bet_hand2 = 0;
@@ -1925,12 +1409,16 @@ int32_t blackjack_app(void* p) {
     state->current_profile_slot = 0;
     state->is_guest = false;
     state->practice_mode = false;
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    profile_load_list(storage, state);
-    settings_load(storage, state);
-    furi_record_close(RECORD_STORAGE);
+    state->rng_seed = furi_hal_random_get(); /* one hardware draw per session; shuffles use the PRNG */
+    state->shoe_number = 0;
+    store_get_names(&app->store, state);
+    store_get_settings(&app->store, state);
+    app->drawn_hash = view_hash(state);
     view_commit_model(app->view, true);
 
+    app->deal_timer = furi_timer_alloc(deal_timer_callback, FuriTimerTypePeriodic, app);
+    view_dispatcher_set_event_callback_context(app->view_dispatcher, app);
+    view_dispatcher_set_custom_event_callback(app->view_dispatcher, custom_event_callback);
     view_dispatcher_add_view(app->view_dispatcher, 0, app->view);
     view_dispatcher_switch_to_view(app->view_dispatcher, 0);
 
@@ -1940,10 +1428,17 @@ int32_t blackjack_app(void* p) {
     view_dispatcher_run(app->view_dispatcher);
 
     furi_record_close(RECORD_GUI);
+    furi_timer_stop(app->deal_timer);
+    furi_timer_free(app->deal_timer);
+    /* Before the dispatcher its callback posts to, and the workspace it searches in */
+    practice_worker_free(app->practice_worker);
     view_dispatcher_remove_view(app->view_dispatcher, 0);
     view_free(app->view);
     view_dispatcher_free(app->view_dispatcher);
+    hand_ev_release();
+    store_worker_free(app->store_worker);
+    lock_stats_log(&app->lock_stats, TAG);
+    FURI_LOG_I(TAG, "Blackjack exit, %lu redraws skipped", (unsigned long)app->redraws_skipped);
     free(app);
-    FURI_LOG_I(TAG, "Blackjack exit");
     return 0;
 }
@@ -0,0 +1,333 @@
+/**
+ * Dealer outcome probabilities (see blackjack_dealer.h).
+ *
+ * The probability of a dealer draw sequence depends only on which cards it holds, not their
+ * order. So the dealer's play from one upcard is kept as the list of card multisets it can end
+ * on, each with its outcome and the number of orders it can be drawn in. That list depends only
+ * on the upcard and the soft 17 rule. A path's probability is its orders times a falling
+ * factorial per card value, over the falling factorial of the shoe size for its length; the
+ * cache keeps the numerators summed by (outcome, length). Removing or returning one card of
+ * value c only changes the paths that hold a c, by their c factor, so those are the only paths
+ * an incremental step visits.
+ *
+ * Building a path list walks the dealer's whole draw tree and costs far more than a pass over
+ * the list, so lists stay in the pool until a newer upcard needs the room.
+ */
+#include "blackjack_dealer.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Hash slots used to merge paths while building the list (power of two, > 2 * DEALER_PATHS_MAX) */
+#define DEALER_INDEX_BITS 11
+#define DEALER_INDEX_SIZE (1 << DEALER_INDEX_BITS)
+
+/* Path: sorted card values one nibble each (bits 0-19), outcome (20-22), draw orders (23-31) */
+#define PATH_CARDS(p) ((p)&0xFFFFF)
+#define PATH_OUTCOME(p) (((p) >> 20) & 7)
+#define PATH_ORDERS(p) ((p) >> 23)
+
+typedef float FallTable[11][DEALER_PATH_LEN + 1];
+
+static uint8_t dealer_value(uint8_t hard, bool ace) {
+    return (ace && hard <= 11) ? hard + 10 : hard;
+}
+
+void shoe_counts_full(ShoeCounts* out) {
+    out->n[0] = 0;
+    for(uint8_t p = 1; p <= 10; p++) {
+        out->n[p] = (p == 10 ? 16 : 4) * DECKS;
+    }
+    out->total = DECK_SIZE;
+}
+
+void shoe_counts_unseen(const BlackjackState* s, ShoeCounts* out) {
+    shoe_counts_full(out);
+    for(uint8_t i = BURN_TOP; i < s->deck_top; i++) {
+        out->n[card_points[shoe_card(s, i)]]--;
+        out->total--;
+    }
+    if(s->dealer_hole && s->dealer_count > 0) {
+        out->n[card_points[s->dealer_hand[0]]]++;
+        out->total++;
+    }
+}
+
+static void fall_row(float* row, uint8_t n) {
+    row[0] = 1;
+    for(uint8_t k = 1; k <= DEALER_PATH_LEN; k++) {
+        row[k] = n >= k ? row[k - 1] * (n - k + 1) : 0;
+    }
+}
+
+static void fall_table(FallTable fall, const ShoeCounts* shoe) {
+    for(uint8_t c = 1; c <= 10; c++) fall_row(fall[c], shoe->n[c]);
+}
+
+static uint32_t cards_key(const uint8_t* cards, uint8_t len) {
+    uint8_t sorted[DEALER_PATH_LEN];
+    memcpy(sorted, cards, len);
+    for(uint8_t i = 1; i < len; i++) {
+        for(uint8_t j = i; j > 0 && sorted[j - 1] < sorted[j]; j--) {
+            uint8_t t = sorted[j];
+            sorted[j] = sorted[j - 1];
+            sorted[j - 1] = t;
+        }
+    }
+    uint32_t key = 0;
+    for(uint8_t i = 0; i < len; i++) key = (key << 4) | sorted[i];
+    return key;
+}
+
+typedef struct {
+    uint32_t* path;
+    uint16_t count;
+    uint16_t room;
+    uint8_t up;
+    bool hits_soft17;
+    uint16_t* index; /* Hash of path -> position, to merge orders of the same multiset */
+} PathBuilder;
+
+static void path_builder_add(PathBuilder* b, const uint8_t* cards, uint8_t len, uint8_t outcome) {
+    uint32_t key = cards_key(cards, len) | ((uint32_t)outcome << 20);
+    uint16_t slot = (uint16_t)((key * 2654435761U) >> (32 - DEALER_INDEX_BITS));
+    while(b->index[slot] != UINT16_MAX) {
+        uint32_t* p = &b->path[b->index[slot]];
+        if((*p & 0x7FFFFF) == key) {
+            *p += 1U << 23;
+            return;
+        }
+        slot = (slot + 1) & (DEALER_INDEX_SIZE - 1);
+    }
+    if(b->count < b->room) {
+        b->index[slot] = b->count;
+        b->path[b->count++] = key | (1U << 23);
+    }
+}
+
+static void path_builder_walk(PathBuilder* b, uint8_t hard, bool ace, uint8_t* cards, uint8_t len) {
+    uint8_t v = dealer_value(hard, ace);
+    if(v > 21 || len + 1 == MAX_HAND) {
+        path_builder_add(b, cards, len, DEALER_BUST); /* A 6th card without busting is still a bust */
+        return;
+    }
+    if(v >= 17 && !(b->hits_soft17 && ace && hard == 7)) {
+        path_builder_add(b, cards, len, v - 17);
+        return;
+    }
+    for(uint8_t c = 1; c <= 10; c++) {
+        /* Peeked: the hole card does not make blackjack */
+        if(len == 0 && ((b->up == 1 && c == 10) || (b->up == 10 && c == 1))) continue;
+        cards[len] = c;
+        path_builder_walk(b, hard + c, ace || c == 1, cards, len + 1);
+    }
+}
+
+/* True if one of the path's card nibbles is v (1..10); unused nibbles are 0 */
+static bool path_has(uint32_t p, uint8_t v) {
+    uint32_t x = PATH_CARDS(p) ^ (0x11111U * v);
+    return ((x - 0x11111U) & ~x & 0x88888U) != 0;
+}
+
+/* Orders times the falling factorial of every card value on the path except skip; *len gets the
+ * path length and *skipped the multiplicity of skip (0 if the path does not hold it) */
+static float path_weight(uint32_t p, const FallTable fall, uint8_t skip, uint8_t* skipped, uint8_t* len) {
+    uint32_t cards = PATH_CARDS(p);
+    float w = PATH_ORDERS(p);
+    *len = 0;
+    *skipped = 0;
+    while(cards) {
+        /* Sorted, so equal values are adjacent */
+        uint8_t c = cards & 0xF;
+        uint8_t run = 0;
+        while((cards & 0xF) == c && cards) {
+            cards >>= 4;
+            run++;
+        }
+        if(c == skip) *skipped = run;
+        else w *= fall[c][run];
+        *len += run;
+    }
+    return w;
+}
+
+static void paths_sum(const uint32_t* path, uint16_t count, const FallTable fall, float sum[DEALER_OUTCOMES][DEALER_PATH_LEN + 1]) {
+    memset(sum, 0, sizeof(float) * DEALER_OUTCOMES * (DEALER_PATH_LEN + 1));
+    for(uint16_t i = 0; i < count; i++) {
+        uint8_t skipped, len;
+        float w = path_weight(path[i], fall, 0, &skipped, &len);
+        sum[PATH_OUTCOME(path[i])][len] += w;
+    }
+}
+
+static void sums_to_outcomes(
+    uint8_t up,
+    const ShoeCounts* shoe,
+    const float sum[DEALER_OUTCOMES][DEALER_PATH_LEN + 1],
+    float* out) {
+    float inv_total[DEALER_PATH_LEN + 1];
+    float denom = 1;
+    inv_total[0] = 1;
+    for(uint8_t k = 1; k <= DEALER_PATH_LEN; k++) {
+        denom *= shoe->total - k + 1;
+        inv_total[k] = denom > 0 ? 1.0f / denom : 0;
+    }
+    for(uint8_t o = 0; o < DEALER_OUTCOMES; o++) {
+        float p = 0;
+        for(uint8_t k = 1; k <= DEALER_PATH_LEN; k++) p += sum[o][k] * inv_total[k];
+        out[o] = p;
+    }
+    /* Condition on the peek: the hole card was not the blackjack card */
+    uint8_t skip = up == 1 ? 10 : up == 10 ? 1 : 0;
+    if(skip && shoe->total) {
+        float no_bj = 1.0f - (float)shoe->n[skip] / shoe->total;
+        if(no_bj > 0) {
+            for(uint8_t o = 0; o < DEALER_OUTCOMES; o++) out[o] /= no_bj;
+        }
+    }
+}
+
+void dealer_paths_outcomes(const DealerPaths* dp, const ShoeCounts* shoe, float out[DEALER_OUTCOMES]) {
+    FallTable fall;
+    float sum[DEALER_OUTCOMES][DEALER_PATH_LEN + 1];
+    fall_table(fall, shoe);
+    paths_sum(dp->path, dp->count, fall, sum);
+    sums_to_outcomes(dp->up, shoe, sum, out);
+}
+
+void dealer_cache_init(DealerCache* c) {
+    memset(c, 0, sizeof(*c));
+    shoe_counts_full(&c->shoe);
+}
+
+void dealer_cache_set_rule(DealerCache* c, bool hits_soft17) {
+    if(c->hits_soft17 == hits_soft17) return;
+    c->hits_soft17 = hits_soft17;
+    c->used = 0;
+    for(uint8_t i = 0; i < 10; i++) {
+        c->slot[i].count = 0;
+        c->slot[i].size = 0;
+        c->slot[i].valid = false;
+    }
+}
+
+void dealer_cache_set_shoe(DealerCache* c, const ShoeCounts* shoe) {
+    c->shoe = *shoe;
+}
+
+static void dealer_cache_evict(DealerCache* c, DealerSlot* victim) {
+    uint16_t end = victim->first + victim->count;
+    memmove(&c->path[victim->first], &c->path[end], sizeof(uint32_t) * (c->used - end));
+    for(uint8_t i = 0; i < 10; i++) {
+        if(c->slot[i].count && c->slot[i].first > victim->first) c->slot[i].first -= victim->count;
+    }
+    c->used -= victim->count;
+    victim->count = 0;
+    victim->valid = false;
+}
+
+/* Slot for an upcard with its paths in the pool, or NULL if the build scratch cannot be allocated */
+static DealerSlot* dealer_cache_slot(DealerCache* c, uint8_t up) {
+    DealerSlot* sl = &c->slot[up - 1];
+    sl->last_used = ++c->clock;
+    if(sl->count) return sl;
+    /* Only needed while merging, so it is not part of the cache's fixed budget */
+    uint16_t* index = malloc(sizeof(uint16_t) * DEALER_INDEX_SIZE);
+    if(!index) return NULL;
+    memset(index, 0xFF, sizeof(uint16_t) * DEALER_INDEX_SIZE);
+    uint16_t need = sl->size ? sl->size : DEALER_PATHS_MAX;
+    while(DEALER_CACHE_PATHS - c->used < need) {
+        DealerSlot* victim = NULL;
+        for(uint8_t i = 0; i < 10; i++) {
+            DealerSlot* v = &c->slot[i];
+            if(v->count && (!victim || v->last_used < victim->last_used)) victim = v;
+        }
+        dealer_cache_evict(c, victim);
+    }
+    PathBuilder b = {
+        .path = &c->path[c->used],
+        .room = DEALER_CACHE_PATHS - c->used,
+        .up = up,
+        .hits_soft17 = c->hits_soft17,
+        .index = index,
+    };
+    uint8_t cards[DEALER_PATH_LEN];
+    path_builder_walk(&b, up, up == 1, cards, 0);
+    free(index);
+    sl->first = c->used;
+    sl->count = b.count;
+    sl->size = b.count;
+    sl->valid = false;
+    c->used += b.count;
+    return sl;
+}
+
+/* Take one card of value v out of the slot's shoe (delta -1) or put one back (+1) */
+static void dealer_slot_step(const DealerCache* c, DealerSlot* sl, FallTable fall, uint8_t v, int delta) {
+    float old_row[DEALER_PATH_LEN + 1];
+    memcpy(old_row, fall[v], sizeof(old_row));
+    sl->shoe.n[v] += delta;
+    sl->shoe.total += delta;
+    fall_row(fall[v], sl->shoe.n[v]);
+    const uint32_t* path = &c->path[sl->first];
+    for(uint16_t i = 0; i < sl->count; i++) {
+        if(!path_has(path[i], v)) continue;
+        uint8_t k, len;
+        float rest = path_weight(path[i], fall, v, &k, &len);
+        sl->sum[PATH_OUTCOME(path[i])][len] += rest * (fall[v][k] - old_row[k]);
+    }
+}
+
+/* Bring a slot's sums to the cache's shoe: card by card when close, else one full pass */
+static void dealer_slot_sync(const DealerCache* c, DealerSlot* sl) {
+    FallTable fall;
+    if(sl->valid) {
+        uint16_t steps = 0;
+        for(uint8_t v = 1; v <= 10; v++) {
+            steps += sl->shoe.n[v] > c->shoe.n[v] ? sl->shoe.n[v] - c->shoe.n[v] : c->shoe.n[v] - sl->shoe.n[v];
+        }
+        if(steps == 0) return;
+        sl->out_valid = false;
+        if(steps <= DEALER_CACHE_MAX_STEPS) {
+            fall_table(fall, &sl->shoe);
+            for(uint8_t v = 1; v <= 10; v++) {
+                while(sl->shoe.n[v] > c->shoe.n[v]) dealer_slot_step(c, sl, fall, v, -1);
+                while(sl->shoe.n[v] < c->shoe.n[v]) dealer_slot_step(c, sl, fall, v, 1);
+            }
+            return;
+        }
+    }
+    fall_table(fall, &c->shoe);
+    paths_sum(&c->path[sl->first], sl->count, fall, sl->sum);
+    sl->shoe = c->shoe;
+    sl->valid = true;
+    sl->out_valid = false;
+}
+
+bool dealer_cache_paths(DealerCache* c, uint8_t up, DealerPaths* out) {
+    DealerSlot* sl = dealer_cache_slot(c, up);
+    if(!sl) return false;
+    out->up = up;
+    out->count = sl->count;
+    out->path = &c->path[sl->first];
+    return true;
+}
+
+const float* dealer_cache_outcomes(DealerCache* c, uint8_t up) {
+    DealerSlot* sl = dealer_cache_slot(c, up);
+    if(!sl) return NULL;
+    dealer_slot_sync(c, sl);
+    if(!sl->out_valid) {
+        sums_to_outcomes(up, &sl->shoe, sl->sum, sl->out);
+        sl->out_valid = true;
+    }
+    return sl->out;
+}
+
+const float* dealer_cache_query(DealerCache* c, const BlackjackState* s) {
+    if(s->dealer_count < 2) return NULL;
+    ShoeCounts shoe;
+    shoe_counts_unseen(s, &shoe);
+    dealer_cache_set_rule(c, s->dealer_hits_soft17);
+    dealer_cache_set_shoe(c, &shoe);
+    return dealer_cache_outcomes(c, card_points[s->dealer_hand[1] % 52]);
+}
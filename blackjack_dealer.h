@@ -0,0 +1,94 @@
+/**
+ * Dealer final-total probabilities against a shoe composition.
+ * P(dealer ends on 17..21 or busts | upcard, unseen cards), under the engine's rules: dealer peeks
+ * for blackjack, stands on 17 (or hits soft 17), and a 6-card dealer hand counts as a bust.
+ *
+ * A DealerCache keeps the dealer paths of recently used upcards in a fixed pool, evicting the
+ * least recently used upcard when a new one does not fit, and per upcard the distribution for
+ * the last shoe it was asked about. Asking again after a few cards left the shoe updates it card
+ * by card instead of redoing the whole pass. The memory is fixed: sizeof(DealerCache).
+ */
+#pragma once
+
+#include "blackjack_game.h"
+
+/* Dealer final totals 17..21, then bust (including a 6th card) */
+#define DEALER_OUTCOMES 6
+#define DEALER_BUST 5
+
+/* Largest multiset list: 981 for a 2 up with the dealer hitting soft 17 */
+#define DEALER_PATHS_MAX 1000
+/* Dealer cards after the upcard: hole card + 4 hits reaches 6 cards */
+#define DEALER_PATH_LEN 5
+/* Path pool, 4 bytes each; all ten upcards together need 5751 (H17), the common ones far fewer */
+#define DEALER_CACHE_PATHS 4096
+/* A step costs a fifth to a half of a full pass, so a slot further behind than this (or across
+ * a reshuffle) redoes the full pass instead */
+#define DEALER_CACHE_MAX_STEPS 4
+
+#if DEALER_CACHE_PATHS < DEALER_PATHS_MAX
+#error "DEALER_CACHE_PATHS must hold the largest upcard's path list"
+#endif
+
+/* Unseen cards by points: [1] = Aces, [2]..[9], [10] = ten-valued; [0] unused */
+typedef struct {
+    uint8_t n[11];
+    uint8_t total;
+} ShoeCounts;
+
+/* Terminal dealer hands for one upcard, as card multisets; valid until the cache builds another */
+typedef struct {
+    uint8_t up;
+    uint16_t count;
+    const uint32_t* path;
+} DealerPaths;
+
+typedef struct {
+    uint16_t first; /* Range in DealerCache.path */
+    uint16_t count; /* 0 = not resident */
+    uint16_t size; /* Path count when last built, 0 = never built */
+    uint32_t last_used;
+    bool valid; /* sum matches shoe */
+    bool out_valid;
+    ShoeCounts shoe;
+    /* Path weights (draw orders x falling factorials of the counts) by outcome and cards drawn */
+    float sum[DEALER_OUTCOMES][DEALER_PATH_LEN + 1];
+    float out[DEALER_OUTCOMES];
+} DealerSlot;
+
+typedef struct {
+    bool hits_soft17;
+    uint32_t clock;
+    uint16_t used; /* Paths in the pool */
+    ShoeCounts shoe; /* Composition the next query is for */
+    DealerSlot slot[10]; /* By upcard points - 1 */
+    uint32_t path[DEALER_CACHE_PATHS];
+} DealerCache;
+
+/* Full DECKS-deck shoe */
+void shoe_counts_full(ShoeCounts* out);
+
+/* Cards the player cannot see: everything but the face-up cards dealt from the current shoe */
+void shoe_counts_unseen(const BlackjackState* s, ShoeCounts* out);
+
+/* Empty cache for a full shoe, dealer stands on soft 17 */
+void dealer_cache_init(DealerCache* c);
+
+/* Switch the soft 17 rule; drops every upcard when it changes */
+void dealer_cache_set_rule(DealerCache* c, bool hits_soft17);
+
+/* Composition for the following queries; upcards catch up lazily when next asked */
+void dealer_cache_set_shoe(DealerCache* c, const ShoeCounts* shoe);
+
+/* Outcome probabilities for an upcard (card points) against the cache's shoe, given no dealer
+ * blackjack. NULL only if building the upcard's paths runs out of memory. */
+const float* dealer_cache_outcomes(DealerCache* c, uint8_t up);
+
+/* Path list of an upcard under the cache's rule, for callers that evaluate other shoes */
+bool dealer_cache_paths(DealerCache* c, uint8_t up, DealerPaths* out);
+
+/* Outcomes for the dealer upcard in s against the cards the player has not seen; NULL before the deal */
+const float* dealer_cache_query(DealerCache* c, const BlackjackState* s);
+
+/* Outcome probabilities for any shoe in one full pass over the paths, given no dealer blackjack */
+void dealer_paths_outcomes(const DealerPaths* dp, const ShoeCounts* shoe, float out[DEALER_OUTCOMES]);
@@ -0,0 +1,305 @@
+/**
+ * Practice-mode EV (see blackjack_ev.h).
+ *
+ * The player tree is searched with exact card removal, memoized by the multiset of extra cards
+ * drawn, since that alone fixes both the hand and the shoe. Each stand total needs the dealer
+ * distribution for that node's shoe: one pass over the upcard's dealer paths (blackjack_dealer.h).
+ */
+#include "blackjack_ev.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Player nodes memoized per call (hash slots, power of two); splitting 2s against a 2 needs ~750 */
+#define EV_MEMO_BITS 10
+#define EV_MEMO_SIZE (1 << EV_MEMO_BITS)
+#define EV_MEMO_LOAD (EV_MEMO_SIZE * 7 / 8) /* Past this, nodes are computed but not stored */
+/* Extra player cards that still need a stand total: split card + 3 hits; the next card makes 6 */
+#define EV_MAX_EXTRA 4
+
+typedef struct {
+    uint16_t key; /* Sorted extra cards, one nibble each; hit-side keys have 0xF in the top nibble */
+    uint16_t generation; /* Slot is live only if it matches EvSearch.generation */
+    float stand;
+    float best; /* NAN until computed */
+} EvMemo;
+
+typedef struct {
+    DealerPaths dealer;
+    ShoeCounts shoe; /* Unseen cards minus the extra cards on the current path */
+    bool split; /* Searching one split hand: base is the pair card alone */
+    uint8_t extra[EV_MAX_EXTRA];
+    uint8_t extra_count;
+    const volatile bool* cancel; /* Set from another thread to abandon the search; may be NULL */
+    uint16_t generation; /* Bumped per call, so the memo never needs clearing */
+    uint16_t memo_used;
+    EvMemo memo[EV_MEMO_SIZE];
+} EvSearch;
+
+/* About 30 KB (18 KB of it the dealer cache): allocated on first use, released by hand_ev_release */
+typedef struct {
+    DealerCache dealer;
+    EvSearch search;
+} EvWorkspace;
+
+static EvWorkspace* ev_workspace;
+
+static uint8_t ev_value(uint8_t hard, bool ace) {
+    return (ace && hard <= 11) ? hard + 10 : hard;
+}
+
+/* Sorted values packed one nibble each, as a memo key */
+static uint16_t extra_key(const uint8_t* cards, uint8_t len) {
+    uint8_t sorted[EV_MAX_EXTRA];
+    memcpy(sorted, cards, len);
+    for(uint8_t i = 1; i < len; i++) {
+        for(uint8_t j = i; j > 0 && sorted[j - 1] < sorted[j]; j--) {
+            uint8_t t = sorted[j];
+            sorted[j] = sorted[j - 1];
+            sorted[j - 1] = t;
+        }
+    }
+    uint16_t key = 0;
+    for(uint8_t i = 0; i < len; i++) key = (uint16_t)((key << 4) | sorted[i]);
+    return key;
+}
+
+static EvWorkspace* ev_workspace_get(void) {
+    if(!ev_workspace) {
+        ev_workspace = malloc(sizeof(EvWorkspace));
+        if(!ev_workspace) return NULL;
+        dealer_cache_init(&ev_workspace->dealer);
+        memset(ev_workspace->search.memo, 0, sizeof(ev_workspace->search.memo));
+        ev_workspace->search.generation = 0;
+    }
+    return ev_workspace;
+}
+
+/* Memo entry for the current node; once the memo is full, the caller's spare is used instead */
+static EvMemo* ev_memo(EvSearch* e, EvMemo* spare) {
+    /* Split hands hold up to 4 extra cards; the unsplit hand needs at most 3, leaving the top nibble free */
+    uint16_t key = extra_key(e->extra, e->extra_count);
+    if(!e->split) key |= 0xF000;
+    uint16_t slot = (uint16_t)((key * 40503U) >> (16 - EV_MEMO_BITS)) & (EV_MEMO_SIZE - 1);
+    EvMemo* m;
+    while(true) {
+        m = &e->memo[slot];
+        if(m->generation != e->generation) break;
+        if(m->key == key) return m;
+        slot = (slot + 1) & (EV_MEMO_SIZE - 1);
+    }
+    if(e->memo_used < EV_MEMO_LOAD) {
+        e->memo_used++;
+        m->generation = e->generation;
+    } else {
+        m = spare;
+    }
+    m->key = key;
+    m->stand = NAN;
+    m->best = NAN;
+    return m;
+}
+
+static float ev_stand_at(EvSearch* e, EvMemo* m, uint8_t v) {
+    /* The dealer pass is most of the work: a cancelled search skips it, and its result is dropped */
+    if(e->cancel && *e->cancel) return 0;
+    if(isnan(m->stand)) {
+        float d[DEALER_OUTCOMES];
+        dealer_paths_outcomes(&e->dealer, &e->shoe, d);
+        float ev = d[DEALER_BUST];
+        for(uint8_t t = 17; t <= 21; t++) {
+            if(v > t) ev += d[t - 17];
+            else if(v < t) ev -= d[t - 17];
+        }
+        m->stand = ev;
+    }
+    return m->stand;
+}
+
+static float ev_stand(EvSearch* e, uint8_t v) {
+    EvMemo spare;
+    return ev_stand_at(e, ev_memo(e, &spare), v);
+}
+
+/* Run body once per unseen card value c, removed from the shoe, with its draw probability pc */
+#define EV_FOR_EACH_CARD(e, c, pc, body)        \
+    do {                                        \
+        ShoeCounts* sh_ = &(e)->shoe;           \
+        float total_ = sh_->total;              \
+        for(uint8_t c = 1; c <= 10; c++) {      \
+            if(!sh_->n[c]) continue;            \
+            float pc = sh_->n[c] / total_;      \
+            sh_->n[c]--;                        \
+            sh_->total--;                       \
+            (e)->extra[(e)->extra_count++] = c; \
+            body;                               \
+            (e)->extra_count--;                 \
+            sh_->n[c]++;                        \
+            sh_->total++;                       \
+        }                                       \
+    } while(0)
+
+static float ev_hit(EvSearch* e, uint8_t hard, bool ace, uint8_t count);
+
+/* Best of stand and hit; a hand that cannot bust on the next card always hits */
+static float ev_best(EvSearch* e, uint8_t hard, bool ace, uint8_t count) {
+    EvMemo spare;
+    EvMemo* m = ev_memo(e, &spare);
+    if(!isnan(m->best)) return m->best;
+    float hit = ev_hit(e, hard, ace, count);
+    m->best = hit;
+    if(hard > 11 || ace) {
+        float stand = ev_stand_at(e, m, ev_value(hard, ace));
+        if(stand > hit) m->best = stand;
+    }
+    return m->best;
+}
+
+static float ev_hit(EvSearch* e, uint8_t hard, bool ace, uint8_t count) {
+    float ev = 0;
+    if(count + 1 == MAX_HAND) {
+        /* The 6th card wins unless it busts; no stand total needed */
+        ShoeCounts* sh = &e->shoe;
+        for(uint8_t c = 1; c <= 10; c++) {
+            float pc = (float)sh->n[c] / sh->total;
+            ev += ev_value(hard + c, ace || c == 1) > 21 ? -pc : pc;
+        }
+        return ev;
+    }
+    EV_FOR_EACH_CARD(e, c, pc, {
+        uint8_t h = hard + c;
+        bool a = ace || c == 1;
+        ev += pc * (ev_value(h, a) > 21 ? -1.0f : ev_best(e, h, a, count + 1));
+    });
+    return ev;
+}
+
+static float ev_double(EvSearch* e, uint8_t hard, bool ace) {
+    float ev = 0;
+    EV_FOR_EACH_CARD(e, c, pc, {
+        uint8_t v = ev_value(hard + c, ace || c == 1);
+        ev += pc * (v > 21 ? -1.0f : ev_stand(e, v));
+    });
+    return 2 * ev;
+}
+
+/* One split hand: the pair card plus a drawn card, then stand / hit / double */
+static float ev_split(EvSearch* e, uint8_t card) {
+    float ev = 0;
+    e->split = true;
+    EV_FOR_EACH_CARD(e, c, pc, {
+        uint8_t h = card + c;
+        bool a = card == 1 || c == 1;
+        float best = ev_best(e, h, a, 2);
+        float dbl = ev_double(e, h, a);
+        ev += pc * (dbl > best ? dbl : best);
+    });
+    e->split = false;
+    return 2 * ev;
+}
+
+/* hand_ev_compute, plus the dealer's bust chance; false if cancelled, leaving ev incomplete */
+static bool ev_compute(
+    const ShoeCounts* shoe,
+    const HandTotals* totals,
+    uint8_t count,
+    uint8_t pair_points,
+    uint8_t dealer_up,
+    bool can_double,
+    bool hits_soft17,
+    const volatile bool* cancel,
+    float ev[4],
+    float* bust) {
+    ev[StrategyStand] = ev[StrategyHit] = ev[StrategyDouble] = ev[StrategySplit] = NAN;
+    if(bust) *bust = NAN;
+    EvWorkspace* w = ev_workspace_get();
+    if(!w) return true;
+    uint8_t up = card_points[dealer_up % 52];
+    dealer_cache_set_rule(&w->dealer, hits_soft17);
+    dealer_cache_set_shoe(&w->dealer, shoe);
+    const float* d = dealer_cache_outcomes(&w->dealer, up);
+    EvSearch* e = &w->search;
+    if(!d || !dealer_cache_paths(&w->dealer, up, &e->dealer)) return true;
+    if(bust) *bust = d[DEALER_BUST];
+    e->cancel = cancel;
+    e->shoe = *shoe;
+    e->split = false;
+    e->extra_count = 0;
+    e->memo_used = 0;
+    if(++e->generation == 0) {
+        memset(e->memo, 0, sizeof(e->memo));
+        e->generation = 1;
+    }
+
+    /* The root's stand total comes straight from the cache */
+    bool ace = totals->aces != 0;
+    uint8_t v = hand_totals_value(totals);
+    float stand = d[DEALER_BUST];
+    for(uint8_t t = 17; t <= 21; t++) {
+        if(v > t) stand += d[t - 17];
+        else if(v < t) stand -= d[t - 17];
+    }
+    ev[StrategyStand] = v > 21 ? -1.0f : stand;
+    if(count < MAX_HAND) ev[StrategyHit] = ev_hit(e, totals->hard, ace, count);
+    if(can_double && count == 2) ev[StrategyDouble] = ev_double(e, totals->hard, ace);
+    if(pair_points) ev[StrategySplit] = ev_split(e, pair_points);
+    e->cancel = NULL;
+    return !(cancel && *cancel);
+}
+
+void hand_ev_compute(
+    const ShoeCounts* shoe,
+    const HandTotals* totals,
+    uint8_t count,
+    uint8_t pair_points,
+    uint8_t dealer_up,
+    bool can_double,
+    bool hits_soft17,
+    float ev[4]) {
+    ev_compute(shoe, totals, count, pair_points, dealer_up, can_double, hits_soft17, NULL, ev, NULL);
+}
+
+void hand_ev_release(void) {
+    free(ev_workspace);
+    ev_workspace = NULL;
+}
+
+/* At the split prompt can_double_down is not set yet; declining the split sets it like this */
+static bool hand_ev_can_double(const BlackjackState* s) {
+    return s->phase == PhaseSplitPrompt ? (s->balance >= s->current_bet) : s->can_double_down;
+}
+
+uint32_t hand_ev_key(const BlackjackState* s) {
+    bool second = s->is_split && s->active_hand == 1;
+    return ((s->shoe_number & 0xFFFF) << 16) | ((uint32_t)s->deck_top << 8) | (second ? 8 : 0) |
+           (s->dealer_hits_soft17 ? 4 : 0) | (hand_ev_can_double(s) ? 2 : 0) | (s->can_split ? 1 : 0);
+}
+
+void hand_ev_request(const BlackjackState* s, HandEvRequest* req) {
+    bool second = s->is_split && s->active_hand == 1;
+    const uint8_t* hand = second ? s->player_hand2 : s->player_hand;
+    uint8_t count = second ? s->player_count2 : s->player_count;
+    bool is_pair = (count == 2 && CARD_RANK(hand[0]) == CARD_RANK(hand[1]));
+    req->key = hand_ev_key(s);
+    shoe_counts_unseen(s, &req->shoe);
+    req->totals = second ? s->player_totals2 : s->player_totals;
+    req->count = count;
+    req->pair_points = (is_pair && s->can_split) ? card_points[hand[0]] : 0;
+    req->dealer_up = s->dealer_hand[1];
+    req->can_double = hand_ev_can_double(s);
+    req->hits_soft17 = s->dealer_hits_soft17;
+}
+
+bool hand_ev_run(const HandEvRequest* req, const volatile bool* cancel, float ev[4], float* bust) {
+    return ev_compute(
+        &req->shoe,
+        &req->totals,
+        req->count,
+        req->pair_points,
+        req->dealer_up,
+        req->can_double,
+        req->hits_soft17,
+        cancel,
+        ev,
+        bust);
+}
@@ -0,0 +1,47 @@
+/**
+ * Exact expected value of each action for the hand being played, against the cards the
+ * player has not seen (rest of the shoe, burn card and dealer hole card) and the dealer upcard.
+ * Follows the engine's rules: dealer peeks, stands on 17 (or hits soft 17), busts on a 6th
+ * card; a 6-card player hand wins. Split is the usual approximation: twice the EV of one
+ * split hand, ignoring the cards the other hand will draw.
+ */
+#pragma once
+
+#include "blackjack_dealer.h"
+#include "blackjack_strategy.h"
+
+/* EV per unit bet, indexed by StrategyAction; NAN for Double/Split when not allowed.
+ * pair_points is the card value of a splittable pair, 0 if the hand cannot split.
+ * Uses one shared workspace, so calls must not overlap. */
+void hand_ev_compute(
+    const ShoeCounts* shoe,
+    const HandTotals* totals,
+    uint8_t count,
+    uint8_t pair_points,
+    uint8_t dealer_up,
+    bool can_double,
+    bool hits_soft17,
+    float ev[4]);
+
+/* hand_ev_compute's inputs for the active hand, copied out of the state so the search can run
+ * without holding it */
+typedef struct {
+    uint32_t key; /* hand_ev_key of the state they came from */
+    ShoeCounts shoe;
+    HandTotals totals;
+    uint8_t count;
+    uint8_t pair_points;
+    uint8_t dealer_up;
+    bool can_double;
+    bool hits_soft17;
+} HandEvRequest;
+
+/* Identifies the active hand's cards and options; never 0 */
+uint32_t hand_ev_key(const BlackjackState* s);
+void hand_ev_request(const BlackjackState* s, HandEvRequest* req);
+/* hand_ev_compute for req, plus the dealer's bust chance (NAN without memory). Returns false,
+ * with ev incomplete, if *cancel (may be NULL) was set from another thread before it finished. */
+bool hand_ev_run(const HandEvRequest* req, const volatile bool* cancel, float ev[4], float* bust);
+
+/* Free the workspace (allocated on the first compute) */
+void hand_ev_release(void);
@@ -0,0 +1,624 @@
+/**
+ * Blackjack rules engine (see blackjack_game.h).
+ * Pure C: no Furi, GUI or storage calls, so the same rules run on the device and on the host.
+ */
+#include "blackjack_game.h"
+#include <stdio.h>
+#include <string.h>
+
+const uint8_t card_points[52] = {
+    2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 10, 10, 1, /* Spades: 2..10, J, Q, K, A */
+    2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 10, 10, 1, /* Hearts */
+    2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 10, 10, 1, /* Diamonds */
+    2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 10, 10, 1, /* Clubs */
+};
+
+static void hand_totals_scan(const uint8_t* hand, uint8_t count, HandTotals* t) {
+    hand_totals_reset(t);
+    for(uint8_t i = 0; i < count; i++) {
+        hand_totals_add(t, hand[i]);
+    }
+}
+
+uint8_t hand_value(const uint8_t* hand, uint8_t count) {
+    HandTotals t;
+    hand_totals_scan(hand, count, &t);
+    return hand_totals_value(&t);
+}
+
+void hand_values_soft_hard(const uint8_t* hand, uint8_t count, uint8_t* soft, uint8_t* hard) {
+    HandTotals t;
+    hand_totals_scan(hand, count, &t);
+    *soft = hand_totals_value(&t);
+    *hard = t.hard;
+}
+
+bool hand_is_soft_17(const uint8_t* hand, uint8_t count) {
+    HandTotals t;
+    hand_totals_scan(hand, count, &t);
+    return hand_totals_is_soft_17(&t);
+}
+
+/* Append a card to a hand and its running totals */
+static void hand_push(uint8_t* hand, uint8_t* count, HandTotals* t, uint8_t card) {
+    hand[(*count)++] = card;
+    hand_totals_add(t, card);
+}
+
+void shuffle_deck(uint8_t* deck, BlackjackRng* rng) {
+    /* Create 3 decks */
+    for(int i = 0; i < DECK_SIZE; i++) {
+        deck[i] = (uint8_t)(i % 52);
+    }
+    /* Fisher-Yates shuffle */
+    for(int i = DECK_SIZE - 1; i > 0; i--) {
+        int j = (int)blackjack_rng_bounded(rng, (uint32_t)(i + 1));
+        uint8_t t = deck[i];
+        deck[i] = deck[j];
+        deck[j] = t;
+    }
+}
+
+void shoe_pack(BlackjackState* s, const uint8_t* deck) {
+    uint8_t* p = s->shoe;
+    uint32_t bits = 0;
+    unsigned nbits = 0;
+    for(int i = 0; i < DECK_SIZE; i++) {
+        bits |= (uint32_t)deck[i] << nbits;
+        nbits += SHOE_CARD_BITS;
+        while(nbits >= 8) {
+            *p++ = (uint8_t)bits;
+            bits >>= 8;
+            nbits -= 8;
+        }
+    }
+    *p++ = (uint8_t)bits;
+    while(p < s->shoe + SHOE_BYTES) *p++ = 0;
+}
+
+/* Shuffle a new shoe from its own stream, so any shoe can be replayed from (rng_seed, shoe_number) */
+static void shoe_shuffle(BlackjackState* s) {
+    uint8_t deck[DECK_SIZE];
+    s->shoe_number++;
+    blackjack_rng_seed(&s->rng, s->rng_seed, s->shoe_number);
+    shuffle_deck(deck, &s->rng);
+    shoe_pack(s, deck);
+    s->deck_top = BURN_TOP; /* Burn top card */
+    s->cut_card_out = false;
+}
+
+uint8_t draw_card(BlackjackState* s) {
+    /* Unreachable with the cut card at most CUT_CARD_MAX; keeps a bad setting from overrunning the shoe */
+    if(s->deck_top >= DECK_SIZE) {
+        shoe_shuffle(s);
+        s->reshuffle_announced = false; /* Need to announce */
+    }
+    uint8_t card = shoe_card(s, s->deck_top++);
+    if(s->deck_top > s->cut_card) s->cut_card_out = true;
+    return card;
+}
+
+static const uint8_t cut_card_presets[] = {CUT_CARD_MIN, (DECK_SIZE * 2) / 3, CUT_CARD_DEFAULT, CUT_CARD_MAX};
+#define CUT_CARD_PRESETS (sizeof(cut_card_presets) / sizeof(cut_card_presets[0]))
+
+uint8_t cut_card_next(uint8_t cut_card) {
+    for(unsigned i = 0; i < CUT_CARD_PRESETS; i++) {
+        if(cut_card_presets[i] > cut_card) return cut_card_presets[i];
+    }
+    return cut_card_presets[0];
+}
+
+uint8_t cut_card_percent(uint8_t cut_card) {
+    return (uint8_t)((cut_card * 100U) / DECK_SIZE);
+}
+
+const char* game_phase_name(uint8_t phase) {
+    static const char* const names[PhaseCount] = {
+        "Splash", "ProfileMenu", "Betting", "Deal", "PlayerTurn", "SplitPrompt",
+        "InsurancePrompt", "DealerTurn", "ShowFinalCards", "Result", "Statistics", "Help",
+        "Reshuffle", "GuestSavePrompt", "GuestPickProfile", "Settings", "ConfirmErase",
+    };
+    return phase < PhaseCount ? names[phase] : "?";
+}
+
+/* Dealer total used for settlement: drawing a 6th card without busting is still a dealer bust */
+static uint8_t dealer_settle_value(const BlackjackState* s) {
+    uint8_t dv = hand_totals_value(&s->dealer_totals);
+    if(s->dealer_count == MAX_HAND && dv <= 21) dv = 22;
+    return dv;
+}
+
+/* Dealer draws below 17, and on soft 17 when the rule says so; a sixth card without busting is
+ * still a dealer bust (settled in game_show_result), so the hand stops there */
+static bool dealer_must_hit(const BlackjackState* s) {
+    if(s->dealer_count >= MAX_HAND) return false;
+    uint8_t dv = hand_totals_value(&s->dealer_totals);
+    return dv < 17 || (dv == 17 && s->dealer_hits_soft17 && hand_totals_is_soft_17(&s->dealer_totals));
+}
+
+void game_start_betting(BlackjackState* s) {
+    s->dirty |= GameDirtyAll;
+    s->phase = PhaseBetting;
+    s->current_bet = MIN_BET;
+    if(s->current_bet > s->balance) {
+        s->current_bet = (s->balance < MIN_BET) ? 0 : s->balance;
+    }
+    s->base_bet = s->current_bet;  /* default; overwritten when they place bet */
+    s->result_msg[0] = '\0';
+    s->is_blackjack = false;
+    s->can_double_down = false;
+    s->can_split = false;
+    s->is_split = false;
+    s->active_hand = 0;
+    s->bet_hand2 = 0;
+    s->player_count2 = 0;
+    hand_totals_reset(&s->player_totals2);
+}
+
+/* After the opening four cards: player blackjack, insurance offer, dealer peek, then split prompt or player turn */
+static void game_finish_deal(BlackjackState* s) {
+    /* Player blackjack only on initial two-card 21 (Ace + 10-value) */
+    uint8_t pv = hand_totals_value(&s->player_totals);
+    bool player_has_blackjack = (s->player_count == 2 && pv == 21);
+    if(player_has_blackjack) {
+        s->is_blackjack = true;
+        s->dealer_hole = false;
+        s->phase = PhaseShowFinalCards;
+        uint8_t dv = hand_totals_value(&s->dealer_totals);
+        if(dv == 21) {
+            s->balance += s->current_bet; /* push */
+            snprintf(s->result_msg, sizeof(s->result_msg), "Push. +$%u", s->current_bet);
+        } else {
+            uint16_t payout = s->current_bet + (s->current_bet * 3 / 2);
+            s->balance += payout;
+            snprintf(s->result_msg, sizeof(s->result_msg), "Blackjack! +$%u", payout);
+        }
+        s->result_msg[sizeof(s->result_msg) - 1] = '\0';
+        s->events |= GameEventBlackjack; /* vibration: blackjack (player or push) */
+        return;
+    }
+    /* Dealer up card: second card (index 1) */
+    uint8_t dealer_up_rank = s->dealer_hand[1] % 13; /* 0-12: 2..9, 8-11=10/J/Q/K, 12=Ace */
+    bool dealer_up_is_ace = (dealer_up_rank == 12);
+    bool dealer_up_is_10 = (dealer_up_rank >= 8 && dealer_up_rank <= 11);
+    if(dealer_up_is_ace) {
+        /* Offer insurance before peeking (pop-up like result screen) */
+        s->phase = PhaseInsurancePrompt;
+        s->profile_menu_selection = 0; /* 0=No, 1=Yes */
+        return;
+    }
+    if(dealer_up_is_10) {
+        /* Peek: if dealer has blackjack, hand ends immediately */
+        uint8_t dv = hand_totals_value(&s->dealer_totals);
+        if(dv == 21) {
+            s->dealer_hole = false;
+            s->games_played++;
+            s->games_lost++;
+            snprintf(s->result_msg, sizeof(s->result_msg), "Dealer blackjack. -$%u", s->current_bet);
+            s->result_msg[sizeof(s->result_msg) - 1] = '\0';
+            s->phase = PhaseResult;
+            s->events |= GameEventBlackjack | GameEventRoundOver; /* vibration: dealer blackjack */
+            return;
+        }
+    }
+    /* No dealer blackjack - player turn or split prompt */
+    bool is_pair = (s->player_count == 2 && CARD_RANK(s->player_hand[0]) == CARD_RANK(s->player_hand[1]));
+    s->can_split = (is_pair && (s->balance >= s->current_bet));
+    if(s->can_split) {
+        s->phase = PhaseSplitPrompt;
+    } else {
+        s->phase = PhasePlayerTurn;
+        s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
+    }
+}
+
+/* Resolve insurance choice: peek dealer; if dealer blackjack settle (main + insurance), else continue to player turn/split */
+void resolve_insurance(BlackjackState* s, bool took_insurance) {
+    s->dirty |= GameDirtyAll;
+    if(took_insurance) {
+        s->insurance_bet = s->current_bet / 2;  /* half, rounded down */
+        s->balance -= s->insurance_bet;
+    }
+    s->dealer_hole = false;
+    uint8_t dv = hand_totals_value(&s->dealer_totals);
+    if(dv == 21) {
+        s->games_played++;
+        if(took_insurance) {
+            s->balance += s->current_bet;  /* main bet back (push) */
+            s->balance += s->insurance_bet * 2;  /* insurance pays 2:1 */
+            s->games_pushed++;
+            snprintf(s->result_msg, sizeof(s->result_msg), "Dealer BJ. Ins +$%u", s->insurance_bet);
+        } else {
+            s->games_lost++;
+            snprintf(s->result_msg, sizeof(s->result_msg), "Dealer blackjack. -$%u", s->current_bet);
+        }
+        s->result_msg[sizeof(s->result_msg) - 1] = '\0';
+        s->phase = PhaseResult;
+        s->events |= GameEventBlackjack | GameEventRoundOver; /* vibration: dealer blackjack */
+        return;
+    }
+    bool is_pair = (s->player_count == 2 && CARD_RANK(s->player_hand[0]) == CARD_RANK(s->player_hand[1]));
+    s->can_split = (is_pair && (s->balance >= s->current_bet));
+    if(s->can_split) {
+        s->phase = PhaseSplitPrompt;
+    } else {
+        s->phase = PhasePlayerTurn;
+        s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
+    }
+}
+
+/* Take the opening bet and deal; the bet and the balance before it are kept for the hand history */
+static void game_take_bet(BlackjackState* s) {
+    s->round_bet = s->current_bet;
+    s->round_balance = s->balance;
+    s->balance -= s->current_bet;
+    s->insurance_bet = 0;
+    game_deal_cards(s);
+}
+
+void game_place_bet(BlackjackState* s) {
+    if(s->current_bet == 0 || s->current_bet > s->balance) return;
+    s->dirty |= GameDirtyBank;
+    s->base_bet = s->current_bet;  /* remember for reset after double/split/insurance */
+    game_take_bet(s);
+}
+
+/* Bet Again from the result screen - restore original bet, deduct, and deal */
+void game_bet_again(BlackjackState* s) {
+    s->dirty |= GameDirtyBank;
+    s->current_bet = s->base_bet;
+    if(s->current_bet > s->balance) s->current_bet = (s->balance < MIN_BET) ? 0 : s->balance;
+    if(s->current_bet > 0 && s->current_bet <= s->balance) game_take_bet(s);
+}
+
+/* The opening four cards are dealt by game_step in casino order: player, dealer (hole card),
+ * player, dealer */
+static void game_deal_opening(BlackjackState* s) {
+    s->phase = PhaseDeal;
+}
+
+static void game_step_deal(BlackjackState* s) {
+    uint8_t dealt = s->player_count + s->dealer_count;
+    if(dealt % 2 == 0) {
+        hand_push(s->player_hand, &s->player_count, &s->player_totals, draw_card(s));
+    } else {
+        hand_push(s->dealer_hand, &s->dealer_count, &s->dealer_totals, draw_card(s));
+    }
+    if(dealt + 1 == 4) game_finish_deal(s);
+}
+
+void game_deal_cards(BlackjackState* s) {
+    s->dirty |= GameDirtyAll;
+    s->player_count = 0;
+    s->dealer_count = 0;
+    hand_totals_reset(&s->player_totals);
+    hand_totals_reset(&s->dealer_totals);
+    s->dealer_hole = true;
+    s->is_blackjack = false;
+    s->is_split = false;
+    s->active_hand = 0;
+    s->player_count2 = 0;
+    hand_totals_reset(&s->player_totals2);
+    s->result_msg[0] = '\0';
+
+    /* The shoe persists across rounds; it is only reshuffled once the cut card came out */
+    if(s->shoe_number == 0) {
+        shoe_shuffle(s); /* First shoe of the session, nothing to announce */
+    } else if(s->cut_card_out) {
+        shoe_shuffle(s);
+        s->reshuffle_announced = false;
+        s->phase = PhaseReshuffle;
+        return;
+    }
+    s->reshuffle_announced = true;
+    game_deal_opening(s);
+}
+
+/* Continue after the reshuffle announcement, which only comes before a deal: deal the round */
+void game_continue_deal(BlackjackState* s) {
+    s->dirty |= GameDirtyAll;
+    s->reshuffle_announced = true;
+    game_deal_opening(s);
+}
+
+/* Decline split - continue with normal play */
+void game_decline_split(BlackjackState* s) {
+    s->dirty |= GameDirtyHands;
+    s->phase = PhasePlayerTurn;
+    s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
+    s->can_split = false;
+}
+
+void game_player_hit(BlackjackState* s) {
+    if(s->phase != PhasePlayerTurn) return;
+    s->dirty |= GameDirtyHands;
+    s->events |= GameEventHit; /* audio: hit */
+    uint8_t* hand = (s->is_split && s->active_hand == 1) ? s->player_hand2 : s->player_hand;
+    uint8_t* count = (s->is_split && s->active_hand == 1) ? &s->player_count2 : &s->player_count;
+    HandTotals* totals = (s->is_split && s->active_hand == 1) ? &s->player_totals2 : &s->player_totals;
+
+    if(*count >= MAX_HAND) return;
+
+    hand_push(hand, count, totals, draw_card(s));
+    s->can_double_down = false; /* Can't double after hitting */
+    s->can_split = false; /* Can't split after hitting */
+
+    uint8_t pv = hand_totals_value(totals);
+        if(pv > 21) {
+            /* Hand busted - if split, move to next hand or show results */
+            if(s->is_split && s->active_hand == 0) {
+                /* Move to second hand */
+                s->active_hand = 1;
+                s->can_double_down = (s->player_count2 == 2 && (s->balance >= s->bet_hand2));
+                s->can_split = false; /* Can't split second hand */
+            } else {
+            /* Both hands done or single hand busted */
+            s->dealer_hole = false; /* Show dealer cards */
+            s->phase = PhaseShowFinalCards;
+        }
+    } else if(*count == MAX_HAND) {
+        /* Player wins with 6 cards without busting */
+        if(s->is_split && s->active_hand == 0) {
+            /* Move to second hand */
+            s->active_hand = 1;
+            s->can_double_down = (s->player_count2 == 2 && (s->balance >= s->bet_hand2));
+            s->can_split = false;
+        } else {
+            s->dealer_hole = false; /* Show dealer cards */
+            s->phase = PhaseShowFinalCards;
+        }
+    }
+}
+
+void game_player_double_down(BlackjackState* s) {
+    if(s->phase != PhasePlayerTurn || !s->can_double_down) return;
+
+    uint8_t* hand = (s->is_split && s->active_hand == 1) ? s->player_hand2 : s->player_hand;
+    uint8_t* count = (s->is_split && s->active_hand == 1) ? &s->player_count2 : &s->player_count;
+    HandTotals* totals = (s->is_split && s->active_hand == 1) ? &s->player_totals2 : &s->player_totals;
+    uint16_t* bet = (s->is_split && s->active_hand == 1) ? &s->bet_hand2 : &s->current_bet;
+
+    if(*count != 2) return;
+    s->dirty |= GameDirtyBank | GameDirtyHands;
+    if(s->balance >= *bet) {
+        s->balance -= *bet;
+        *bet *= 2;
+    } else {
+        /* Not enough balance to double */
+        return;
+    }
+    /* Draw exactly one card */
+    hand_push(hand, count, totals, draw_card(s));
+    s->can_double_down = false;
+    s->can_split = false;
+    /* Automatically stand after double down */
+    game_player_stand(s);
+}
+
+void game_player_split(BlackjackState* s) {
+    /* Reached from the "Split Pair?" prompt (Down=Yes) or from the player turn */
+    if((s->phase != PhasePlayerTurn && s->phase != PhaseSplitPrompt) || !s->can_split) return;
+
+    /* Check if we have enough balance for second bet */
+    if(s->balance < s->current_bet) return;
+    s->dirty |= GameDirtyBank | GameDirtyHands;
+
+    /* Place bet for second hand */
+    s->balance -= s->current_bet;
+    s->bet_hand2 = s->current_bet;
+
+    /* Split the pair: second card goes to second hand */
+    s->player_hand2[0] = s->player_hand[1];
+    s->player_count2 = 1;
+    s->player_count = 1; /* First hand now has one card */
+    hand_totals_reset(&s->player_totals);
+    hand_totals_add(&s->player_totals, s->player_hand[0]);
+    hand_totals_reset(&s->player_totals2);
+    hand_totals_add(&s->player_totals2, s->player_hand2[0]);
+
+    /* Deal one card to each hand */
+    hand_push(s->player_hand, &s->player_count, &s->player_totals, draw_card(s));
+    hand_push(s->player_hand2, &s->player_count2, &s->player_totals2, draw_card(s));
+
+    s->phase = PhasePlayerTurn;
+    s->is_split = true;
+    s->active_hand = 0; /* Start with first hand */
+    s->can_split = false; /* Can't split again */
+    s->can_double_down = (s->player_count == 2 && (s->balance >= s->current_bet));
+}
+
+void game_player_stand(BlackjackState* s) {
+    if(s->phase != PhasePlayerTurn) return;
+    s->dirty |= GameDirtyHands;
+    /* If split and on first hand, move to second hand (no stand sound) */
+    if(s->is_split && s->active_hand == 0) {
+        s->active_hand = 1;
+        s->can_double_down = (s->player_count2 == 2 && (s->balance >= s->bet_hand2));
+        s->can_split = false;
+        return;
+    }
+    s->events |= GameEventStand; /* audio: stand (both hands done) */
+    /* Both hands done: the hole card turns over and the dealer draws, one card per game_step */
+    s->phase = PhaseDealerTurn;
+    s->dealer_hole = false;
+    /* Show final cards before result */
+    if(!dealer_must_hit(s)) s->phase = PhaseShowFinalCards;
+}
+
+static void game_step_dealer(BlackjackState* s) {
+    if(dealer_must_hit(s)) hand_push(s->dealer_hand, &s->dealer_count, &s->dealer_totals, draw_card(s));
+    if(!dealer_must_hit(s)) s->phase = PhaseShowFinalCards;
+}
+
+bool game_step(BlackjackState* s) {
+    if(s->phase == PhaseDeal) {
+        game_step_deal(s);
+    } else if(s->phase == PhaseDealerTurn) {
+        game_step_dealer(s);
+    } else {
+        return false;
+    }
+    s->dirty |= GameDirtyHands;
+    return true;
+}
+
+void game_run(BlackjackState* s) {
+    while(game_step(s)) {
+        /* The same steps the app's deal timer takes, without the wait */
+    }
+}
+
+void game_show_result(BlackjackState* s) {
+    s->dirty |= GameDirtyBank | GameDirtyResult;
+    /* If blackjack was already handled in game_deal_cards, just track stats */
+    if(s->is_blackjack && s->result_msg[0] != '\0') {
+        s->games_played++;
+        uint8_t dv = hand_totals_value(&s->dealer_totals);
+        if(dv == 21) {
+            s->games_pushed++;
+        } else {
+            s->games_won++;
+        }
+        s->phase = PhaseResult;
+        s->events |= GameEventRoundOver;
+        return;
+    }
+
+    uint8_t dv = dealer_settle_value(s);
+    uint16_t total_winnings = 0;
+    uint16_t total_losses = 0;
+    char result_buf[64] = "";
+
+    if(s->is_split) {
+        /* Calculate results for both hands */
+        uint8_t pv1 = hand_totals_value(&s->player_totals);
+        uint8_t pv2 = hand_totals_value(&s->player_totals2);
+        uint16_t winnings1 = 0, winnings2 = 0;
+        bool won1 = false, won2 = false, lost1 = false, lost2 = false;
+
+        /* Hand 1 result */
+        if(pv1 > 21) {
+            lost1 = true;
+            total_losses += s->current_bet;
+        } else if(s->player_count == MAX_HAND) {
+            won1 = true;
+            winnings1 = s->current_bet * 2;
+            total_winnings += winnings1;
+        } else if(dv > 21) {
+            won1 = true;
+            winnings1 = s->current_bet * 2;
+            total_winnings += winnings1;
+        } else if(pv1 > dv) {
+            won1 = true;
+            winnings1 = s->current_bet * 2;
+            total_winnings += winnings1;
+        } else if(pv1 < dv) {
+            lost1 = true;
+            total_losses += s->current_bet;
+        } else {
+            /* Push - return bet */
+            total_winnings += s->current_bet;
+        }
+
+        /* Hand 2 result */
+        if(pv2 > 21) {
+            lost2 = true;
+            total_losses += s->bet_hand2;
+        } else if(s->player_count2 == MAX_HAND) {
+            won2 = true;
+            winnings2 = s->bet_hand2 * 2;
+            total_winnings += winnings2;
+        } else if(dv > 21) {
+            won2 = true;
+            winnings2 = s->bet_hand2 * 2;
+            total_winnings += winnings2;
+        } else if(pv2 > dv) {
+            won2 = true;
+            winnings2 = s->bet_hand2 * 2;
+            total_winnings += winnings2;
+        } else if(pv2 < dv) {
+            lost2 = true;
+            total_losses += s->bet_hand2;
+        } else {
+            /* Push - return bet */
+            total_winnings += s->bet_hand2;
+        }
+
+        s->balance += total_winnings;
+
+        /* Format result message */
+        if(total_winnings > total_losses) {
+            uint16_t net = total_winnings - total_losses;
+            snprintf(result_buf, sizeof(result_buf), "Split: +$%u", net);
+        } else if(total_losses > total_winnings) {
+            uint16_t net = total_losses - total_winnings;
+            snprintf(result_buf, sizeof(result_buf), "Split: -$%u", net);
+        } else {
+            snprintf(result_buf, sizeof(result_buf), "Split: Push");
+        }
+
+        /* Track statistics */
+        if(won1 && won2) {
+            s->games_won++;
+        } else if(lost1 && lost2) {
+            s->games_lost++;
+        } else {
+            s->games_pushed++;
+        }
+    } else {
+        /* Single hand result */
+        uint8_t pv = hand_totals_value(&s->player_totals);
+
+        if(pv > 21) {
+            /* Player busted */
+            s->games_lost++;
+            snprintf(result_buf, sizeof(result_buf), "Bust! -$%u", s->current_bet);
+        } else if(s->player_count == MAX_HAND) {
+            /* Player wins with 6 cards */
+            s->games_won++;
+            uint16_t payout = s->current_bet * 2;
+            s->balance += payout;
+            snprintf(result_buf, sizeof(result_buf), "6 cards! +$%u", payout);
+        } else if(dv > 21) {
+            s->games_won++;
+            uint16_t payout = s->current_bet * 2;
+            s->balance += payout;
+            if(s->dealer_count == MAX_HAND) {
+                snprintf(result_buf, sizeof(result_buf), "Dealer 6 cards! +$%u", payout);
+            } else {
+                snprintf(result_buf, sizeof(result_buf), "Dealer bust! +$%u", payout);
+            }
+        } else if(pv > dv) {
+            s->games_won++;
+            uint16_t payout = s->current_bet * 2;
+            s->balance += payout;
+            snprintf(result_buf, sizeof(result_buf), "You win! +$%u", payout);
+        } else if(pv < dv) {
+            s->games_lost++;
+            snprintf(result_buf, sizeof(result_buf), "Dealer wins. -$%u", s->current_bet);
+        } else {
+            s->games_pushed++;
+            s->balance += s->current_bet; /* return bet on push */
+            snprintf(result_buf, sizeof(result_buf), "Push. +$%u", s->current_bet);
+        }
+    }
+
+    strncpy(s->result_msg, result_buf, sizeof(s->result_msg) - 1);
+    s->result_msg[sizeof(s->result_msg) - 1] = '\0';
+    s->games_played++;
+    s->phase = PhaseResult;
+    s->events |= GameEventRoundOver;
+}
+
+HandOutcome game_hand_outcome(const BlackjackState* s, uint8_t hand) {
+    /* Two-card dealer 21 was always peeked, ending the round before the player acted */
+    bool dealer_blackjack = (s->dealer_count == 2 && hand_totals_value(&s->dealer_totals) == 21);
+    if(s->is_blackjack) return dealer_blackjack ? HandPushed : HandBlackjack;
+    if(dealer_blackjack) return s->insurance_bet ? HandPushed : HandLost; /* Insured: main bet returned */
+    uint8_t pv = hand_totals_value(hand ? &s->player_totals2 : &s->player_totals);
+    uint8_t count = hand ? s->player_count2 : s->player_count;
+    uint8_t dv = dealer_settle_value(s);
+    if(pv > 21) return HandLost;
+    if(count == MAX_HAND || dv > 21 || pv > dv) return HandWon;
+    return (pv < dv) ? HandLost : HandPushed;
+}
@@ -0,0 +1,246 @@
+/**
+ * Blackjack rules engine.
+ * Shoe, hand totals, dealing, player actions, dealer play and settlement.
+ * No Furi/GUI dependencies: builds for the device and for the host tools in host/.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "blackjack_rng.h"
+
+#define MAX_HAND 6
+#define MAX_SPLIT_HANDS 2  /* Maximum number of hands after split */
+#define DECKS 3
+#define DECK_SIZE (52 * DECKS)  /* 3 deck shoe = 156 cards */
+#define BURN_TOP 1  /* Burn top card */
+#define BURN_BOTTOM 20  /* Cards left behind the deepest cut card */
+#define CUT_CARD_MIN (DECK_SIZE / 2)  /* 50% penetration */
+#define CUT_CARD_MAX (DECK_SIZE - BURN_BOTTOM)  /* 87% penetration; a round draws at most 18 more cards */
+#define CUT_CARD_DEFAULT ((DECK_SIZE * 3) / 4)  /* 75% penetration */
+#define SHOE_CARD_BITS 6 /* Card codes are 0-51 */
+/* Card i at bit i * SHOE_CARD_BITS, LSB first; the spare byte lets any card be read as a 16-bit window */
+#define SHOE_BYTES ((DECK_SIZE * SHOE_CARD_BITS + 7) / 8 + 1)
+#define CARD_VALUE(c) ((c) % 13)   /* 0=2, 1=3, ..., 9=10, 10=J, 11=Q, 12=K, (12 or 0 for A in rank) */
+#define CARD_SUIT(c) ((c) / 13)    /* 0=S, 1=H, 2=D, 3=C */
+#define CARD_RANK(c) ((c) % 13)    /* Get card rank (0-12) for pair detection */
+
+typedef enum {
+    PhaseSplash,
+    PhaseProfileMenu,
+    PhaseBetting,
+    PhaseDeal,
+    PhasePlayerTurn,
+    PhaseSplitPrompt,
+    PhaseInsurancePrompt,  /* Dealer Ace up: Insurance? Yes/No */
+    PhaseDealerTurn,
+    PhaseShowFinalCards,
+    PhaseResult,
+    PhaseStatistics,
+    PhaseHelp,
+    PhaseReshuffle,
+    PhaseGuestSavePrompt,  /* Guest: Save to profile? Yes/No */
+    PhaseGuestPickProfile, /* Guest: pick slot to save to */
+    PhaseSettings,         /* Sound, Vibro, Dealer S17, Penetration, Erase all */
+    PhaseConfirmErase,    /* Confirm erase all profiles */
+    PhaseCount
+} GamePhase;
+
+/* Feedback raised by the rules engine; the app plays them (sound/vibro) and clears the mask */
+typedef enum {
+    GameEventHit = 1 << 0,       /* Player took a card */
+    GameEventStand = 1 << 1,     /* Player finished all hands, dealer plays */
+    GameEventBlackjack = 1 << 2, /* Player or dealer blackjack */
+    GameEventRoundOver = 1 << 3, /* Round settled (PhaseResult); logged to the hand history */
+} GameEvent;
+
+/* What a game_* call changed, so the app only reformats that part of the screen; it clears the mask */
+typedef enum {
+    GameDirtyBank = 1 << 0,   /* balance, current_bet, bet_hand2 */
+    GameDirtyHands = 1 << 1,  /* Cards, totals, hole card, split and active hand, double/split options */
+    GameDirtyResult = 1 << 2, /* result_msg */
+    GameDirtyAll = GameDirtyBank | GameDirtyHands | GameDirtyResult,
+} GameDirty;
+
+/* How fast the app deals (persisted setting); the delay per card is the app's */
+typedef enum {
+    DealSpeedNormal, /* 0, so older stores read as Normal */
+    DealSpeedFast, /* No delay: every card is out by the time the key press returns */
+    DealSpeedSlow,
+    DealSpeedCount
+} DealSpeed;
+
+#define STARTING_BALANCE 3125
+#define MIN_BET 5
+#define MAX_BET 500
+#define BET_INCREMENT 5
+#define MAX_PROFILES 4
+#define PROFILE_NAME_LEN 17
+
+/* Running totals kept next to each hand, updated in O(1) per card by hand_totals_add */
+typedef struct {
+    uint8_t hard; /* Every Ace counted as 1 */
+    uint8_t aces;
+    bool soft;    /* One Ace can count as 11 without busting */
+} HandTotals;
+
+typedef struct BlackjackState BlackjackState;
+
+/* The view model is locked (and hashed for redraws) on every key press and frame, so the
+ * state is kept compact: the shoe is packed six bits a card, flags are bitfields, and the
+ * fields each press and frame touch come first. The size is held to a budget below. */
+struct BlackjackState {
+    /* Round in play */
+    uint8_t phase; /* GamePhase */
+    uint8_t prev_phase; /* GamePhase before the help screen */
+    uint8_t events; /* GameEvent mask raised since the app last played feedback */
+    uint8_t dirty; /* GameDirty mask raised since the app last drew */
+    uint8_t deck_top;
+    uint8_t cut_card; /* Shoe position of the cut card, CUT_CARD_MIN..CUT_CARD_MAX (persisted setting) */
+    uint8_t player_count;
+    uint8_t player_count2;
+    uint8_t dealer_count;
+    uint8_t active_hand; /* 0 = first hand, 1 = second hand */
+    bool dealer_hole : 1; /* first dealer card hidden until stand */
+    bool is_blackjack : 1; /* true if player got dealt blackjack (Ace + 10, two cards only) */
+    bool can_double_down : 1; /* true if player can double down (first 2 cards, enough balance) */
+    bool can_split : 1; /* true if player can split (first 2 cards are pair, enough balance) */
+    bool is_split : 1; /* true if hands are split */
+    bool cut_card_out : 1; /* Cut card reached: finish the round, reshuffle before the next deal */
+    bool reshuffle_announced : 1; /* Track if reshuffle was announced */
+    bool practice_mode : 1;
+    bool is_guest : 1;
+    /* Settings (persisted) */
+    bool sound_on : 1;
+    bool vibro_on : 1;
+    bool dealer_hits_soft17 : 1;
+    uint8_t deal_speed : 2; /* DealSpeed */
+    uint8_t player_hand[MAX_HAND];
+    uint8_t player_hand2[MAX_HAND]; /* Second hand after split */
+    uint8_t dealer_hand[MAX_HAND];
+    HandTotals player_totals;
+    HandTotals player_totals2;
+    HandTotals dealer_totals;
+    uint16_t balance; /* player balance in dollars */
+    uint16_t current_bet; /* current bet amount */
+    uint16_t bet_hand2; /* bet for second hand after split */
+    uint16_t base_bet;   /* original bet for session; reset to this before next hand */
+    uint16_t insurance_bet; /* 0 = none; half of base bet (rounded down) if taken */
+    uint16_t round_bet; /* Opening bet of the round, before any double or split */
+    uint16_t round_balance; /* Balance before the opening bet was taken */
+    uint8_t shoe[SHOE_BYTES]; /* Packed cards; read with shoe_card */
+    char result_msg[32];
+
+    /* Menus and statistics */
+    uint8_t splash_selection;   /* 0=Continue, 1=New, 2=Guest, 3=Practice, 4=Help, 5=Settings */
+    uint8_t profile_menu_selection;
+    uint8_t current_profile_slot;
+    uint8_t stat_scroll; /* Scroll offset for stats menu (0 = top, loops) */
+    uint8_t help_scroll; /* Scroll offset for help (0 = top) */
+    uint16_t games_played;
+    uint16_t games_won;
+    uint16_t games_lost;
+    uint16_t games_pushed;
+    uint32_t shoe_number; /* Shoes shuffled so far; the current shoe is #shoe_number */
+    char profile_names[MAX_PROFILES][PROFILE_NAME_LEN];
+
+    /* Only touched at a shuffle */
+    uint64_t rng_seed; /* Hardware-random on device; fixed on the host to replay a session */
+    BlackjackRng rng; /* Shoe shuffle stream, reseeded from (rng_seed, shoe_number) at every shuffle */
+};
+
+/* Budget for the whole state; grow it deliberately, not as a side effect of a bigger shoe */
+#define BLACKJACK_STATE_BUDGET 352
+_Static_assert(sizeof(BlackjackState) <= BLACKJACK_STATE_BUDGET, "BlackjackState is over its size budget");
+_Static_assert(DECK_SIZE <= 255, "deck_top and cut_card are uint8_t shoe positions");
+_Static_assert(MAX_HAND <= 7, "hand counts are logged in three bits (blackjack_history.h)");
+_Static_assert(PhaseCount <= UINT8_MAX, "phase is stored in a byte");
+
+/* Card at shoe position pos */
+static inline uint8_t shoe_card(const BlackjackState* s, uint8_t pos) {
+    unsigned bit = pos * SHOE_CARD_BITS;
+    const uint8_t* p = s->shoe + bit / 8;
+    return (uint8_t)(((p[0] | p[1] << 8) >> (bit % 8)) & ((1 << SHOE_CARD_BITS) - 1));
+}
+
+/* How a player hand ended, once the round is settled */
+typedef enum {
+    HandLost,
+    HandPushed,
+    HandWon,
+    HandBlackjack, /* Paid 3:2 */
+} HandOutcome;
+
+/* Blackjack points per card code 0-51 (Ace = 1; the soft flag promotes one Ace to 11) */
+extern const uint8_t card_points[52];
+
+static inline void hand_totals_reset(HandTotals* t) {
+    t->hard = 0;
+    t->aces = 0;
+    t->soft = false;
+}
+
+static inline void hand_totals_add(HandTotals* t, uint8_t card) {
+    uint8_t p = card_points[card];
+    t->hard += p;
+    t->aces += (p == 1);
+    t->soft = (t->aces != 0 && t->hard <= 11);
+}
+
+/* Best hand value (Ace 1 or 11). >21 is bust. */
+static inline uint8_t hand_totals_value(const HandTotals* t) {
+    return t->soft ? t->hard + 10 : t->hard;
+}
+
+static inline bool hand_totals_is_soft_17(const HandTotals* t) {
+    return t->soft && t->hard == 7;
+}
+
+/* Best hand value (Ace 1 or 11). Returns 0-31; >21 is bust. */
+uint8_t hand_value(const uint8_t* hand, uint8_t count);
+
+/* Get soft value (best total, one ace as 11 if it fits) and hard value (every ace as 1) */
+void hand_values_soft_hard(const uint8_t* hand, uint8_t count, uint8_t* soft, uint8_t* hard);
+
+/* True if hand value is 17 and it's a soft 17 (Ace counted as 11) */
+bool hand_is_soft_17(const uint8_t* hand, uint8_t count);
+
+void shuffle_deck(uint8_t* deck, BlackjackRng* rng);
+/* Store a DECK_SIZE card shoe in s->shoe */
+void shoe_pack(BlackjackState* s, const uint8_t* deck);
+uint8_t draw_card(BlackjackState* s);
+
+/* Next cut card position in the Settings cycle (50%, 66%, 75%, 87%) */
+uint8_t cut_card_next(uint8_t cut_card);
+/* Penetration shown in Settings, percent of the shoe dealt before the reshuffle */
+uint8_t cut_card_percent(uint8_t cut_card);
+
+/* "Splash", "PlayerTurn", ...: the GamePhase name without its prefix; "?" out of range */
+const char* game_phase_name(uint8_t phase);
+
+/* Round flow. Each call advances s->phase; see GamePhase. Dealing the opening cards and the
+ * dealer's play are left in PhaseDeal and PhaseDealerTurn for game_step to do a card at a time. */
+void game_start_betting(BlackjackState* s);
+void game_place_bet(BlackjackState* s);
+void game_bet_again(BlackjackState* s);
+void game_deal_cards(BlackjackState* s);
+void game_continue_deal(BlackjackState* s);
+void resolve_insurance(BlackjackState* s, bool took_insurance);
+void game_decline_split(BlackjackState* s);
+void game_player_hit(BlackjackState* s);
+void game_player_double_down(BlackjackState* s);
+void game_player_split(BlackjackState* s);
+void game_player_stand(BlackjackState* s);
+void game_show_result(BlackjackState* s);
+
+/* PhaseDeal and PhaseDealerTurn: cards are still to come, one per game_step */
+static inline bool game_is_dealing(const BlackjackState* s) {
+    return s->phase == PhaseDeal || s->phase == PhaseDealerTurn;
+}
+/* Deal the next card, moving on once the deal or the dealer's hand is done; false (and
+ * nothing done) when the phase does not deal */
+bool game_step(BlackjackState* s);
+/* Every step at once: fast mode and the host simulators */
+void game_run(BlackjackState* s);
+/* Outcome of player hand 0 or 1 (after a split) in a settled round, by the rules game_show_result pays */
+HandOutcome game_hand_outcome(const BlackjackState* s, uint8_t hand);
@@ -0,0 +1,205 @@
+/**
+ * Hand history records and ring (see blackjack_history.h).
+ */
+#include "blackjack_history.h"
+#include <string.h>
+
+#define HISTORY_HEADER(kind, len) ((uint8_t)(((kind) << 6) | (len)))
+#define HISTORY_CARD_BITS 6
+
+static uint8_t* put_varint(uint8_t* p, uint32_t v) {
+    while(v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+/* NULL if the varint runs past end or is longer than 32 bits */
+static const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint32_t* v) {
+    uint32_t value = 0;
+    for(unsigned shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if(!(b & 0x80)) {
+            *v = value;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+size_t history_encode_session(uint8_t* out, uint64_t seed) {
+    uint8_t* p = out + 1;
+    *p++ = HISTORY_VERSION;
+    for(int i = 0; i < 8; i++) *p++ = (uint8_t)(seed >> (8 * i));
+    out[0] = HISTORY_HEADER(HistoryKindSession, p - out - 1);
+    return (size_t)(p - out);
+}
+
+static HistoryInsurance history_insurance(const BlackjackState* s) {
+    bool dealer_blackjack = (s->dealer_count == 2 && hand_totals_value(&s->dealer_totals) == 21);
+    if(s->insurance_bet) return dealer_blackjack ? HistoryInsuranceWon : HistoryInsuranceLost;
+    if(CARD_RANK(s->dealer_hand[1]) == 12 && !s->is_blackjack) return HistoryInsuranceDeclined;
+    return HistoryInsuranceNone;
+}
+
+size_t history_encode_hand(uint8_t* out, const BlackjackState* s) {
+    uint8_t* p = out + 1;
+    uint8_t flags = s->current_profile_slot & HISTORY_PROFILE_MASK;
+    if(s->is_guest) flags |= HistoryFlagGuest;
+    if(s->practice_mode) flags |= HistoryFlagPractice;
+    if(s->is_split) flags |= HistoryFlagSplit;
+    if(s->current_bet > s->round_bet) flags |= HistoryFlagDouble1;
+    if(s->is_split && s->bet_hand2 > s->round_bet) flags |= HistoryFlagDouble2;
+    if(s->insurance_bet) flags |= HistoryFlagInsurance;
+    *p++ = flags;
+
+    uint8_t count2 = s->is_split ? s->player_count2 : 0;
+    uint8_t cards = s->player_count + count2 + s->dealer_count;
+    uint8_t start = s->deck_top - cards; /* A round never runs past the end of the shoe */
+    p = put_varint(p, s->shoe_number);
+    *p++ = start;
+    p = put_varint(p, s->round_bet);
+    p = put_varint(p, zigzag((int32_t)s->balance - (int32_t)s->round_balance));
+
+    uint16_t counts = s->player_count | count2 << 3 | s->dealer_count << 6;
+    counts |= game_hand_outcome(s, 0) << 9;
+    if(s->is_split) counts |= game_hand_outcome(s, 1) << 11;
+    counts |= history_insurance(s) << 13;
+    if(s->dealer_hits_soft17) counts |= 1u << 15;
+    *p++ = (uint8_t)counts;
+    *p++ = (uint8_t)(counts >> 8);
+
+    uint32_t bits = 0;
+    unsigned nbits = 0;
+    for(uint8_t i = 0; i < cards; i++) {
+        bits |= (uint32_t)shoe_card(s, start + i) << nbits;
+        nbits += HISTORY_CARD_BITS;
+        while(nbits >= 8) {
+            *p++ = (uint8_t)bits;
+            bits >>= 8;
+            nbits -= 8;
+        }
+    }
+    if(nbits) *p++ = (uint8_t)bits;
+
+    out[0] = HISTORY_HEADER(HistoryKindHand, p - out - 1);
+    return (size_t)(p - out);
+}
+
+static bool history_decode_hand(const uint8_t* p, const uint8_t* end, HistoryHand* h) {
+    uint32_t v;
+    if(p >= end) return false;
+    h->flags = *p++;
+    if(!(p = get_varint(p, end, &h->shoe_number)) || p >= end) return false;
+    h->shoe_pos = *p++;
+    if(!(p = get_varint(p, end, &v)) || v > UINT16_MAX) return false;
+    h->bet = (uint16_t)v;
+    if(!(p = get_varint(p, end, &v)) || end - p < 2) return false;
+    h->net = unzigzag(v);
+    uint16_t counts = p[0] | p[1] << 8;
+    p += 2;
+    h->player_count[0] = counts & 7;
+    h->player_count[1] = (counts >> 3) & 7;
+    h->dealer_count = (counts >> 6) & 7;
+    h->outcome[0] = (HandOutcome)((counts >> 9) & 3);
+    h->outcome[1] = (HandOutcome)((counts >> 11) & 3);
+    h->insurance = (HistoryInsurance)((counts >> 13) & 3);
+    h->hits_soft17 = (counts >> 15) & 1;
+    if(h->player_count[0] < 2 || h->player_count[0] > MAX_HAND || h->dealer_count < 2 || h->dealer_count > MAX_HAND) {
+        return false;
+    }
+    bool split = h->flags & HistoryFlagSplit;
+    if(split ? (h->player_count[1] < 2 || h->player_count[1] > MAX_HAND) : h->player_count[1] != 0) return false;
+
+    unsigned cards = h->player_count[0] + h->player_count[1] + h->dealer_count;
+    if(end - p != (ptrdiff_t)((cards * HISTORY_CARD_BITS + 7) / 8)) return false;
+    uint32_t bits = 0;
+    unsigned nbits = 0;
+    for(unsigned i = 0; i < cards; i++) {
+        while(nbits < HISTORY_CARD_BITS) {
+            bits |= (uint32_t)*p++ << nbits;
+            nbits += 8;
+        }
+        h->cards[i] = bits & ((1 << HISTORY_CARD_BITS) - 1);
+        if(h->cards[i] >= 52) return false;
+        bits >>= HISTORY_CARD_BITS;
+        nbits -= HISTORY_CARD_BITS;
+    }
+    return true;
+}
+
+size_t history_decode(const uint8_t* data, size_t size, HistoryRecord* out) {
+    if(size < 1) return 0;
+    size_t len = data[0] & HISTORY_BODY_MAX;
+    if(size < 1 + len) return 0;
+    const uint8_t* p = data + 1;
+    const uint8_t* end = p + len;
+    out->kind = (HistoryKind)(data[0] >> 6);
+    switch(out->kind) {
+    case HistoryKindSession:
+        if(len < 9) return 0;
+        out->version = p[0];
+        out->seed = 0;
+        for(int i = 0; i < 8; i++) out->seed |= (uint64_t)p[1 + i] << (8 * i);
+        break;
+    case HistoryKindHand:
+        if(!history_decode_hand(p, end, &out->hand)) return 0;
+        break;
+    default:
+        break;
+    }
+    return 1 + len;
+}
+
+void history_hand_cards(const HistoryHand* hand, uint8_t player[MAX_SPLIT_HANDS][MAX_HAND], uint8_t dealer[MAX_HAND]) {
+    /* Opening deal is player, dealer, player, dealer; a split deals one card to each hand */
+    const uint8_t* c = hand->cards;
+    player[0][0] = c[0];
+    dealer[0] = c[1];
+    dealer[1] = c[3];
+    size_t next = 4;
+    if(hand->flags & HistoryFlagSplit) {
+        player[1][0] = c[2];
+        player[0][1] = c[next++];
+        player[1][1] = c[next++];
+    } else {
+        player[0][1] = c[2];
+    }
+    for(uint8_t i = 2; i < hand->player_count[0]; i++) player[0][i] = c[next++];
+    for(uint8_t i = 2; i < hand->player_count[1]; i++) player[1][i] = c[next++];
+    for(uint8_t i = 2; i < hand->dealer_count; i++) dealer[i] = c[next++];
+}
+
+bool history_ring_push(HistoryRing* ring, const uint8_t* record, size_t size) {
+    if(size > HISTORY_RING_SIZE - ring->used) return false;
+    size_t tail = (ring->head + ring->used) % HISTORY_RING_SIZE;
+    size_t first = HISTORY_RING_SIZE - tail;
+    if(first > size) first = size;
+    memcpy(ring->data + tail, record, first);
+    memcpy(ring->data, record + first, size - first);
+    ring->used += size;
+    return true;
+}
+
+size_t history_ring_front(const HistoryRing* ring, const uint8_t** data) {
+    size_t size = HISTORY_RING_SIZE - ring->head;
+    if(size > ring->used) size = ring->used;
+    *data = ring->data + ring->head;
+    return size;
+}
+
+void history_ring_consume(HistoryRing* ring, size_t size) {
+    ring->head = (ring->head + size) % HISTORY_RING_SIZE;
+    ring->used -= size;
+}
@@ -0,0 +1,99 @@
+/**
+ * Hand history: one compact binary record per settled round, appended to
+ * apps_data/blackjack/history.bjh by the store worker (see blackjack_store.h).
+ *
+ * A record is a header byte (kind in the top two bits, body length in the low six) and its
+ * body, so a reader can skip kinds it does not know. Each app run starts with a session
+ * record holding the shuffle seed; the hand records after it belong to that seed:
+ *   flags      HistoryFlag bits, profile slot in the low two
+ *   shoe       varint shoe_number; the seed and shoe number give the whole shoe
+ *   position   shoe position of the round's first card
+ *   bet        varint opening bet
+ *   net        zigzag varint balance change over the round, insurance included
+ *   counts     16 bits: player cards, second hand cards, dealer cards (3 bits each),
+ *              hand outcomes (2 bits each, HandOutcome), HistoryInsurance (2), dealer hits soft 17
+ *   cards      every card in draw order, 6 bits each, LSB first
+ * The actions follow from these: a doubled hand drew one card, every other card past two was
+ * a hit, and a hand that did not bust or reach six cards was stood.
+ * No Furi dependencies: the host tools read the logs with history_decode.
+ */
+#pragma once
+
+#include "blackjack_game.h"
+#include <stddef.h>
+
+#define HISTORY_VERSION 1
+#define HISTORY_BODY_MAX 63
+#define HISTORY_RECORD_MAX (1 + HISTORY_BODY_MAX)
+#define HISTORY_CARDS_MAX (MAX_HAND * 3)
+
+typedef enum {
+    HistoryKindSession = 0, /* version, seed */
+    HistoryKindHand = 1,
+} HistoryKind;
+
+#define HISTORY_PROFILE_MASK 0x03
+typedef enum {
+    HistoryFlagGuest = 1 << 2, /* Profile slot not saved to */
+    HistoryFlagPractice = 1 << 3,
+    HistoryFlagSplit = 1 << 4,
+    HistoryFlagDouble1 = 1 << 5, /* First (or only) hand doubled */
+    HistoryFlagDouble2 = 1 << 6, /* Second split hand doubled */
+    HistoryFlagInsurance = 1 << 7, /* Insurance taken */
+} HistoryFlag;
+
+typedef enum {
+    HistoryInsuranceNone, /* Not offered */
+    HistoryInsuranceDeclined,
+    HistoryInsuranceLost,
+    HistoryInsuranceWon,
+} HistoryInsurance;
+
+typedef struct {
+    uint8_t flags; /* HistoryFlag bits, profile slot in HISTORY_PROFILE_MASK */
+    uint32_t shoe_number;
+    uint8_t shoe_pos;
+    uint16_t bet;
+    int32_t net;
+    bool hits_soft17;
+    uint8_t player_count[MAX_SPLIT_HANDS]; /* Second is 0 without a split */
+    uint8_t dealer_count;
+    HandOutcome outcome[MAX_SPLIT_HANDS];
+    HistoryInsurance insurance;
+    uint8_t cards[HISTORY_CARDS_MAX]; /* Draw order */
+} HistoryHand;
+
+typedef struct {
+    HistoryKind kind;
+    uint8_t version; /* Session records */
+    uint64_t seed; /* Session records */
+    HistoryHand hand; /* Hand records */
+} HistoryRecord;
+
+/* Encode into out (HISTORY_RECORD_MAX bytes); return the record size */
+size_t history_encode_session(uint8_t* out, uint64_t seed);
+/* The settled round in s; call on GameEventRoundOver, before the next deal */
+size_t history_encode_hand(uint8_t* out, const BlackjackState* s);
+
+/* Decode the record at data; return its size, or 0 if it is cut short or malformed.
+ * Records of an unknown kind are skipped: their size is returned with kind set. */
+size_t history_decode(const uint8_t* data, size_t size, HistoryRecord* out);
+/* Sort the draw order back into hands, as held at the end of the round */
+void history_hand_cards(const HistoryHand* hand, uint8_t player[MAX_SPLIT_HANDS][MAX_HAND], uint8_t dealer[MAX_HAND]);
+
+/* Records wait in a RAM ring until a batch is written; one writer pushes, one reader drains */
+#define HISTORY_RING_SIZE 2048
+#define HISTORY_FLUSH_BYTES 1024 /* Ring fill that asks for a write */
+
+typedef struct {
+    uint8_t data[HISTORY_RING_SIZE];
+    size_t head; /* Oldest byte not yet written out */
+    size_t used;
+} HistoryRing;
+
+/* Append a whole record; false (and nothing stored) if it does not fit */
+bool history_ring_push(HistoryRing* ring, const uint8_t* record, size_t size);
+/* Oldest unwritten bytes that are contiguous in the ring; returns how many */
+size_t history_ring_front(const HistoryRing* ring, const uint8_t** data);
+/* Release size bytes from the front once they are written */
+void history_ring_consume(HistoryRing* ring, size_t size);
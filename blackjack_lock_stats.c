@@ -0,0 +1,62 @@
+/**
+ * Model lock hold times (see blackjack_lock_stats.h).
+ */
+#include "blackjack_lock_stats.h"
+#include "blackjack_game.h"
+#include <furi.h>
+#include <stdio.h>
+
+static uint8_t lock_stats_bucket(uint32_t us) {
+    uint8_t b = 0;
+    while(b < LOCK_STATS_BUCKETS - 1 && us >= (1u << b)) b++;
+    return b;
+}
+
+void lock_stats_add(LockStats* stats, uint8_t from, uint8_t to, uint32_t us) {
+    if(us > stats->max_us) stats->max_us = us;
+    LockTransition* t = NULL;
+    for(uint8_t i = 0; i < stats->count; i++) {
+        if(stats->transitions[i].from == from && stats->transitions[i].to == to) {
+            t = &stats->transitions[i];
+            break;
+        }
+    }
+    if(!t) {
+        if(stats->count == LOCK_STATS_TRANSITIONS) {
+            stats->untracked++;
+            return;
+        }
+        t = &stats->transitions[stats->count++];
+        t->from = from;
+        t->to = to;
+    }
+    t->count++;
+    if(us > t->max_us) t->max_us = us;
+    uint16_t* bucket = &t->buckets[lock_stats_bucket(us)];
+    if(*bucket < UINT16_MAX) (*bucket)++;
+}
+
+void lock_stats_log(const LockStats* stats, const char* tag) {
+    FURI_LOG_I(
+        tag,
+        "Model lock: max %lu us, %u transitions (%lu holds untracked); buckets <1 <2 <4 .. <1024 >=1024 us",
+        (unsigned long)stats->max_us,
+        (unsigned)stats->count,
+        (unsigned long)stats->untracked);
+    for(uint8_t i = 0; i < stats->count; i++) {
+        const LockTransition* t = &stats->transitions[i];
+        char hist[LOCK_STATS_BUCKETS * 6 + 1];
+        size_t len = 0;
+        for(uint8_t b = 0; b < LOCK_STATS_BUCKETS; b++) {
+            len += snprintf(hist + len, sizeof(hist) - len, " %u", t->buckets[b]);
+        }
+        FURI_LOG_I(
+            tag,
+            "  %s>%s: %lu, max %lu us:%s",
+            game_phase_name(t->from),
+            game_phase_name(t->to),
+            (unsigned long)t->count,
+            (unsigned long)t->max_us,
+            hist);
+    }
+}
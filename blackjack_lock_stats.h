@@ -0,0 +1,33 @@
+/**
+ * How long input_callback holds the view model lock, per phase transition. The GUI thread
+ * cannot draw while the lock is held, so every key press is timed from view_get_model to
+ * view_commit_model and filed under the phase it started in and the one it left. Each
+ * transition keeps a count, the longest hold and a histogram of power-of-two microsecond
+ * buckets; the app logs the table when it exits.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define LOCK_STATS_BUCKETS 12 /* Under 1, 2, 4 ... 1024 us, then 1024 us or more */
+#define LOCK_STATS_TRANSITIONS 64 /* Distinct from/to pairs kept; later ones are only counted */
+
+typedef struct {
+    uint8_t from; /* GamePhase the key was pressed in */
+    uint8_t to; /* GamePhase the handler left */
+    uint16_t buckets[LOCK_STATS_BUCKETS]; /* Saturating */
+    uint32_t count;
+    uint32_t max_us;
+} LockTransition;
+
+typedef struct {
+    LockTransition transitions[LOCK_STATS_TRANSITIONS]; /* In order of first appearance */
+    uint8_t count;
+    uint32_t untracked; /* Holds whose transition did not fit */
+    uint32_t max_us; /* Longest hold overall */
+} LockStats;
+
+/* File one hold of us microseconds */
+void lock_stats_add(LockStats* stats, uint8_t from, uint8_t to, uint32_t us);
+/* FURI_LOG_I the table, one line per transition */
+void lock_stats_log(const LockStats* stats, const char* tag);
@@ -0,0 +1,113 @@
+/**
+ * Practice-mode EV worker (see blackjack_practice.h).
+ */
+#include "blackjack_practice.h"
+#include "blackjack_ev.h"
+#include <furi.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PRACTICE_WORKER_QUEUE 4
+#define PRACTICE_WORKER_STACK 4096 /* The search ran on the app's 4 KB stack before */
+
+/* Messages only wake the thread; the request itself is in PracticeWorker.pending */
+typedef struct {
+    bool stop;
+} PracticeWake;
+
+struct PracticeWorker {
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+    FuriMutex* mutex; /* Guards everything below but cancel */
+    PracticeReadyCallback ready;
+    void* context;
+    HandEvRequest pending;
+    bool has_pending;
+    uint32_t running_key; /* Hand being searched; 0 = none */
+    PracticeNumbers result;
+    volatile bool cancel; /* Abandon the search in progress; cleared when the next one starts */
+};
+
+static void practice_worker_wake(PracticeWorker* worker, bool stop) {
+    PracticeWake wake = {.stop = stop};
+    /* A full queue already holds a wake-up that will see pending */
+    furi_message_queue_put(worker->queue, &wake, stop ? FuriWaitForever : 0);
+}
+
+static int32_t practice_worker_thread(void* context) {
+    PracticeWorker* worker = context;
+    PracticeWake wake = {.stop = false};
+    while(!wake.stop) {
+        furi_message_queue_get(worker->queue, &wake, FuriWaitForever);
+        furi_mutex_acquire(worker->mutex, FuriWaitForever);
+        HandEvRequest req = worker->pending;
+        bool run = worker->has_pending && !wake.stop;
+        worker->has_pending = false;
+        worker->running_key = run ? req.key : 0;
+        worker->cancel = false;
+        furi_mutex_release(worker->mutex);
+        if(!run) continue;
+
+        PracticeNumbers numbers = {.key = req.key};
+        float bust;
+        bool done = hand_ev_run(&req, &worker->cancel, numbers.ev, &bust);
+        numbers.bust = isnan(bust) ? -1 : (int8_t)(bust * 100.0f + 0.5f);
+        furi_mutex_acquire(worker->mutex, FuriWaitForever);
+        worker->running_key = 0;
+        if(done) worker->result = numbers;
+        furi_mutex_release(worker->mutex);
+        if(done) worker->ready(worker->context);
+    }
+    return 0;
+}
+
+PracticeWorker* practice_worker_alloc(PracticeReadyCallback ready, void* context) {
+    PracticeWorker* worker = malloc(sizeof(PracticeWorker));
+    memset(worker, 0, sizeof(PracticeWorker));
+    worker->ready = ready;
+    worker->context = context;
+    worker->queue = furi_message_queue_alloc(PRACTICE_WORKER_QUEUE, sizeof(PracticeWake));
+    worker->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    worker->thread =
+        furi_thread_alloc_ex("BlackjackPractice", PRACTICE_WORKER_STACK, practice_worker_thread, worker);
+    furi_thread_start(worker->thread);
+    return worker;
+}
+
+void practice_worker_free(PracticeWorker* worker) {
+    worker->cancel = true;
+    practice_worker_wake(worker, true);
+    furi_thread_join(worker->thread);
+    furi_thread_free(worker->thread);
+    furi_mutex_free(worker->mutex);
+    furi_message_queue_free(worker->queue);
+    free(worker);
+}
+
+void practice_worker_request(PracticeWorker* worker, const BlackjackState* s) {
+    HandEvRequest req;
+    if(s) hand_ev_request(s, &req);
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    bool known = !s || req.key == worker->result.key;
+    bool running = worker->running_key && !worker->cancel;
+    bool post = false;
+    if(known || (running && req.key == worker->running_key)) {
+        worker->has_pending = false;
+        if(known) worker->cancel = true;
+    } else if(!worker->has_pending || worker->pending.key != req.key) {
+        worker->pending = req;
+        worker->has_pending = true;
+        worker->cancel = true;
+        post = true;
+    }
+    furi_mutex_release(worker->mutex);
+    if(post) practice_worker_wake(worker, false);
+}
+
+bool practice_worker_result(PracticeWorker* worker, PracticeNumbers* numbers) {
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    *numbers = worker->result;
+    furi_mutex_release(worker->mutex);
+    return numbers->key != 0;
+}
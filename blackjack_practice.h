@@ -0,0 +1,30 @@
+/**
+ * Practice-mode numbers for the hand on screen: the EV of each action and the dealer's bust
+ * chance. The EV search can take a good part of a second on the device for a small pair, so a
+ * worker thread runs it, and key presses and deal steps never wait for it. A new request
+ * cancels the search in progress. The worker owns the EV workspace (blackjack_ev.h) while it
+ * runs, so nothing else in the app may call into it.
+ */
+#pragma once
+
+#include "blackjack_game.h"
+
+typedef struct {
+    uint32_t key; /* hand_ev_key they were computed for; 0 = none */
+    float ev[4]; /* EV per unit bet by StrategyAction, NAN when not allowed */
+    int8_t bust; /* Dealer bust chance in percent; -1 if unknown */
+} PracticeNumbers;
+
+/* Runs on the worker thread once a search has finished */
+typedef void (*PracticeReadyCallback)(void* context);
+
+typedef struct PracticeWorker PracticeWorker;
+
+PracticeWorker* practice_worker_alloc(PracticeReadyCallback ready, void* context);
+/* Cancel the search in progress and stop the thread */
+void practice_worker_free(PracticeWorker* worker);
+/* Work out the numbers for the active hand of s, cancelling any search for another hand.
+ * Nothing is searched again for the hand of the last result. NULL only cancels. */
+void practice_worker_request(PracticeWorker* worker, const BlackjackState* s);
+/* The last finished search; false if there is none yet */
+bool practice_worker_result(PracticeWorker* worker, PracticeNumbers* numbers);
@@ -0,0 +1,80 @@
+/**
+ * Random streams for the shoe (see blackjack_rng.h).
+ * xoshiro128** by Blackman and Vigna and PCG32 by O'Neill, both seeded through SplitMix64.
+ */
+#include "blackjack_rng.h"
+
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint32_t rotl32(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint32_t rotr32(uint32_t x, unsigned k) {
+    return (x >> k) | (x << ((-k) & 31));
+}
+
+void blackjack_rng_seed(BlackjackRng* rng, uint64_t seed, uint64_t stream) {
+    /* Distinct streams start from well-separated SplitMix64 states */
+    uint64_t x = seed ^ (stream * 0xD1342543DE82EF95ULL);
+    uint64_t a = splitmix64(&x);
+    uint64_t b = splitmix64(&x);
+    if(rng->kind == BlackjackRngPcg32) {
+        rng->pcg.state = 0;
+        rng->pcg.inc = (b << 1) | 1; /* increment must be odd */
+        blackjack_rng_next(rng);
+        rng->pcg.state += a;
+        blackjack_rng_next(rng);
+        return;
+    }
+    rng->kind = BlackjackRngXoshiro128;
+    rng->xoshiro[0] = (uint32_t)a;
+    rng->xoshiro[1] = (uint32_t)(a >> 32);
+    rng->xoshiro[2] = (uint32_t)b;
+    rng->xoshiro[3] = (uint32_t)(b >> 32);
+    if((rng->xoshiro[0] | rng->xoshiro[1] | rng->xoshiro[2] | rng->xoshiro[3]) == 0) {
+        rng->xoshiro[0] = 1; /* all-zero state is a fixed point */
+    }
+}
+
+uint32_t blackjack_rng_next(BlackjackRng* rng) {
+    if(rng->kind == BlackjackRngPcg32) {
+        uint64_t old = rng->pcg.state;
+        rng->pcg.state = old * 6364136223846793005ULL + rng->pcg.inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        return rotr32(xorshifted, (unsigned)(old >> 59));
+    }
+    uint32_t s0 = rng->xoshiro[0], s1 = rng->xoshiro[1], s2 = rng->xoshiro[2], s3 = rng->xoshiro[3];
+    const uint32_t result = rotl32(s1 * 5, 7) * 9;
+    const uint32_t t = s1 << 9;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = rotl32(s3, 11);
+    rng->xoshiro[0] = s0;
+    rng->xoshiro[1] = s1;
+    rng->xoshiro[2] = s2;
+    rng->xoshiro[3] = s3;
+    return result;
+}
+
+uint32_t blackjack_rng_bounded(BlackjackRng* rng, uint32_t range) {
+    uint64_t m = (uint64_t)blackjack_rng_next(rng) * range;
+    uint32_t low = (uint32_t)m;
+    if(low < range) {
+        /* Reject the 2^32 mod range values that would over-represent small results */
+        uint32_t threshold = (uint32_t)(-range) % range;
+        while(low < threshold) {
+            m = (uint64_t)blackjack_rng_next(rng) * range;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
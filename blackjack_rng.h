@@ -0,0 +1,33 @@
+/**
+ * Random streams for the shoe.
+ * Each BlackjackState carries its own generator so tables never share RNG state.
+ * Two interchangeable generators: xoshiro128** (default, zero-initialised kind) and PCG32.
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef enum {
+    BlackjackRngXoshiro128, /* xoshiro128**: 32-bit ops only, fastest on the Cortex-M4 */
+    BlackjackRngPcg32,      /* PCG-XSH-RR 64/32: needs a 64-bit multiply */
+} BlackjackRngKind;
+
+typedef struct {
+    uint8_t kind; /* BlackjackRngKind; kept by blackjack_rng_seed */
+    union {
+        uint32_t xoshiro[4];
+        struct {
+            uint64_t state;
+            uint64_t inc;
+        } pcg;
+    };
+} BlackjackRng;
+
+/* Seed a stream; the same (kind, seed, stream) always yields the same sequence */
+void blackjack_rng_seed(BlackjackRng* rng, uint64_t seed, uint64_t stream);
+
+/* Next 32-bit output */
+uint32_t blackjack_rng_next(BlackjackRng* rng);
+
+/* Unbiased integer in [0, range), range > 0 (Lemire multiply-shift with rejection) */
+uint32_t blackjack_rng_bounded(BlackjackRng* rng, uint32_t range);
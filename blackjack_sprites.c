@@ -0,0 +1,381 @@
+/**
+ * Sprite atlas (see blackjack_sprites.h).
+ * From images/cards.png, card_back.png and chip.png.
+ * Generated by host/bj_sprite_gen (make -C host sprites); do not edit by hand.
+ */
+#include "blackjack_sprites.h"
+
+const uint8_t sprite_card_faces[52][SPRITE_CARD_BYTES] = {
+    { /* 2S */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x41, 0x9C, 0x21, 0xBE,
+        0x11, 0x88, 0x09, 0x9C, 0x7D, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 3S */
+        0xFE, 0x7F, 0x01, 0x80, 0x3D, 0x80, 0x41, 0x88, 0x41, 0x9C, 0x39, 0xBE,
+        0x41, 0x88, 0x41, 0x9C, 0x3D, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 4S */
+        0xFE, 0x7F, 0x01, 0x80, 0x21, 0x80, 0x31, 0x88, 0x29, 0x9C, 0x25, 0xBE,
+        0x7D, 0x88, 0x21, 0x9C, 0x21, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 5S */
+        0xFE, 0x7F, 0x01, 0x80, 0x7D, 0x80, 0x05, 0x88, 0x3D, 0x9C, 0x41, 0xBE,
+        0x41, 0x88, 0x45, 0x9C, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 6S */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x05, 0x88, 0x05, 0x9C, 0x3D, 0xBE,
+        0x45, 0x88, 0x45, 0x9C, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 7S */
+        0xFE, 0x7F, 0x01, 0x80, 0x7D, 0x80, 0x41, 0x88, 0x21, 0x9C, 0x11, 0xBE,
+        0x09, 0x88, 0x09, 0x9C, 0x09, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 8S */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x39, 0xBE,
+        0x45, 0x88, 0x45, 0x9C, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 9S */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x79, 0xBE,
+        0x41, 0x88, 0x41, 0x9C, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 10S */
+        0xFE, 0x7F, 0x01, 0x80, 0x65, 0x80, 0x97, 0x88, 0x95, 0x9C, 0x95, 0xBE,
+        0x95, 0x88, 0x95, 0x9C, 0x65, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* JS */
+        0xFE, 0x7F, 0x01, 0x80, 0x71, 0x80, 0x21, 0x88, 0x21, 0x9C, 0x21, 0xBE,
+        0x21, 0x88, 0x25, 0x9C, 0x19, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* QS */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x45, 0xBE,
+        0x55, 0x88, 0x25, 0x9C, 0x59, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* KS */
+        0xFE, 0x7F, 0x01, 0x80, 0x45, 0x80, 0x25, 0x88, 0x15, 0x9C, 0x0D, 0xBE,
+        0x15, 0x88, 0x25, 0x9C, 0x45, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* AS */
+        0xFE, 0x7F, 0x01, 0x80, 0x11, 0x80, 0x29, 0x88, 0x45, 0x9C, 0x45, 0xBE,
+        0x7D, 0x88, 0x45, 0x9C, 0x45, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 2H */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x94, 0x41, 0xBE, 0x21, 0xBE,
+        0x11, 0x9C, 0x09, 0x88, 0x7D, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 3H */
+        0xFE, 0x7F, 0x01, 0x80, 0x3D, 0x80, 0x41, 0x94, 0x41, 0xBE, 0x39, 0xBE,
+        0x41, 0x9C, 0x41, 0x88, 0x3D, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 4H */
+        0xFE, 0x7F, 0x01, 0x80, 0x21, 0x80, 0x31, 0x94, 0x29, 0xBE, 0x25, 0xBE,
+        0x7D, 0x9C, 0x21, 0x88, 0x21, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 5H */
+        0xFE, 0x7F, 0x01, 0x80, 0x7D, 0x80, 0x05, 0x94, 0x3D, 0xBE, 0x41, 0xBE,
+        0x41, 0x9C, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 6H */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x05, 0x94, 0x05, 0xBE, 0x3D, 0xBE,
+        0x45, 0x9C, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 7H */
+        0xFE, 0x7F, 0x01, 0x80, 0x7D, 0x80, 0x41, 0x94, 0x21, 0xBE, 0x11, 0xBE,
+        0x09, 0x9C, 0x09, 0x88, 0x09, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 8H */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x94, 0x45, 0xBE, 0x39, 0xBE,
+        0x45, 0x9C, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 9H */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x94, 0x45, 0xBE, 0x79, 0xBE,
+        0x41, 0x9C, 0x41, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 10H */
+        0xFE, 0x7F, 0x01, 0x80, 0x65, 0x80, 0x97, 0x94, 0x95, 0xBE, 0x95, 0xBE,
+        0x95, 0x9C, 0x95, 0x88, 0x65, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* JH */
+        0xFE, 0x7F, 0x01, 0x80, 0x71, 0x80, 0x21, 0x94, 0x21, 0xBE, 0x21, 0xBE,
+        0x21, 0x9C, 0x25, 0x88, 0x19, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* QH */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x94, 0x45, 0xBE, 0x45, 0xBE,
+        0x55, 0x9C, 0x25, 0x88, 0x59, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* KH */
+        0xFE, 0x7F, 0x01, 0x80, 0x45, 0x80, 0x25, 0x94, 0x15, 0xBE, 0x0D, 0xBE,
+        0x15, 0x9C, 0x25, 0x88, 0x45, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* AH */
+        0xFE, 0x7F, 0x01, 0x80, 0x11, 0x80, 0x29, 0x94, 0x45, 0xBE, 0x45, 0xBE,
+        0x7D, 0x9C, 0x45, 0x88, 0x45, 0x80, 0x01, 0x80, 0x01, 0x80, 0x61, 0x8C,
+        0xF1, 0x9E, 0xF1, 0x9F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87, 0x81, 0x83,
+        0x01, 0x81, 0x01, 0x80, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 2D */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x41, 0x9C, 0x21, 0xBE,
+        0x11, 0x9C, 0x09, 0x88, 0x7D, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 3D */
+        0xFE, 0x7F, 0x01, 0x80, 0x3D, 0x80, 0x41, 0x88, 0x41, 0x9C, 0x39, 0xBE,
+        0x41, 0x9C, 0x41, 0x88, 0x3D, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 4D */
+        0xFE, 0x7F, 0x01, 0x80, 0x21, 0x80, 0x31, 0x88, 0x29, 0x9C, 0x25, 0xBE,
+        0x7D, 0x9C, 0x21, 0x88, 0x21, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 5D */
+        0xFE, 0x7F, 0x01, 0x80, 0x7D, 0x80, 0x05, 0x88, 0x3D, 0x9C, 0x41, 0xBE,
+        0x41, 0x9C, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 6D */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x05, 0x88, 0x05, 0x9C, 0x3D, 0xBE,
+        0x45, 0x9C, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 7D */
+        0xFE, 0x7F, 0x01, 0x80, 0x7D, 0x80, 0x41, 0x88, 0x21, 0x9C, 0x11, 0xBE,
+        0x09, 0x9C, 0x09, 0x88, 0x09, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 8D */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x39, 0xBE,
+        0x45, 0x9C, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 9D */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x79, 0xBE,
+        0x41, 0x9C, 0x41, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 10D */
+        0xFE, 0x7F, 0x01, 0x80, 0x65, 0x80, 0x97, 0x88, 0x95, 0x9C, 0x95, 0xBE,
+        0x95, 0x9C, 0x95, 0x88, 0x65, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* JD */
+        0xFE, 0x7F, 0x01, 0x80, 0x71, 0x80, 0x21, 0x88, 0x21, 0x9C, 0x21, 0xBE,
+        0x21, 0x9C, 0x25, 0x88, 0x19, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* QD */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x45, 0xBE,
+        0x55, 0x9C, 0x25, 0x88, 0x59, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* KD */
+        0xFE, 0x7F, 0x01, 0x80, 0x45, 0x80, 0x25, 0x88, 0x15, 0x9C, 0x0D, 0xBE,
+        0x15, 0x9C, 0x25, 0x88, 0x45, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* AD */
+        0xFE, 0x7F, 0x01, 0x80, 0x11, 0x80, 0x29, 0x88, 0x45, 0x9C, 0x45, 0xBE,
+        0x7D, 0x9C, 0x45, 0x88, 0x45, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x81,
+        0x81, 0x83, 0xC1, 0x87, 0xE1, 0x8F, 0xF1, 0x9F, 0xE1, 0x8F, 0xC1, 0x87,
+        0x81, 0x83, 0x01, 0x81, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 2C */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x41, 0x9C, 0x21, 0xAA,
+        0x11, 0xBE, 0x09, 0x88, 0x7D, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 3C */
+        0xFE, 0x7F, 0x01, 0x80, 0x3D, 0x80, 0x41, 0x88, 0x41, 0x9C, 0x39, 0xAA,
+        0x41, 0xBE, 0x41, 0x88, 0x3D, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 4C */
+        0xFE, 0x7F, 0x01, 0x80, 0x21, 0x80, 0x31, 0x88, 0x29, 0x9C, 0x25, 0xAA,
+        0x7D, 0xBE, 0x21, 0x88, 0x21, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 5C */
+        0xFE, 0x7F, 0x01, 0x80, 0x7D, 0x80, 0x05, 0x88, 0x3D, 0x9C, 0x41, 0xAA,
+        0x41, 0xBE, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 6C */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x05, 0x88, 0x05, 0x9C, 0x3D, 0xAA,
+        0x45, 0xBE, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 7C */
+        0xFE, 0x7F, 0x01, 0x80, 0x7D, 0x80, 0x41, 0x88, 0x21, 0x9C, 0x11, 0xAA,
+        0x09, 0xBE, 0x09, 0x88, 0x09, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 8C */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x39, 0xAA,
+        0x45, 0xBE, 0x45, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 9C */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x79, 0xAA,
+        0x41, 0xBE, 0x41, 0x88, 0x39, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* 10C */
+        0xFE, 0x7F, 0x01, 0x80, 0x65, 0x80, 0x97, 0x88, 0x95, 0x9C, 0x95, 0xAA,
+        0x95, 0xBE, 0x95, 0x88, 0x65, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* JC */
+        0xFE, 0x7F, 0x01, 0x80, 0x71, 0x80, 0x21, 0x88, 0x21, 0x9C, 0x21, 0xAA,
+        0x21, 0xBE, 0x25, 0x88, 0x19, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* QC */
+        0xFE, 0x7F, 0x01, 0x80, 0x39, 0x80, 0x45, 0x88, 0x45, 0x9C, 0x45, 0xAA,
+        0x55, 0xBE, 0x25, 0x88, 0x59, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* KC */
+        0xFE, 0x7F, 0x01, 0x80, 0x45, 0x80, 0x25, 0x88, 0x15, 0x9C, 0x0D, 0xAA,
+        0x15, 0xBE, 0x25, 0x88, 0x45, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+    { /* AC */
+        0xFE, 0x7F, 0x01, 0x80, 0x11, 0x80, 0x29, 0x88, 0x45, 0x9C, 0x45, 0xAA,
+        0x7D, 0xBE, 0x45, 0x88, 0x45, 0x80, 0x01, 0x80, 0x01, 0x80, 0x81, 0x83,
+        0xC1, 0x87, 0x81, 0x83, 0x61, 0x8D, 0xF1, 0x9F, 0xF1, 0x9F, 0x61, 0x8D,
+        0x01, 0x81, 0x81, 0x83, 0x01, 0x80, 0xFE, 0x7F,
+    },
+};
+
+const uint8_t sprite_card_back[SPRITE_CARD_BYTES] = {
+        0xFE, 0x7F, 0x01, 0x80, 0x55, 0x95, 0xA9, 0xAA, 0x55, 0x95, 0xA9, 0xAA,
+        0x55, 0x95, 0xA9, 0xAA, 0x55, 0x95, 0xA9, 0xAA, 0x55, 0x95, 0xA9, 0xAA,
+        0x55, 0x95, 0xA9, 0xAA, 0x55, 0x95, 0xA9, 0xAA, 0x55, 0x95, 0xA9, 0xAA,
+        0x55, 0x95, 0xA9, 0xAA, 0x01, 0x80, 0xFE, 0x7F,
+};
+
+const uint8_t sprite_chip_stacks[SPRITE_CHIP_STACK_MAX][SPRITE_CHIP_STACK_BYTES] = {
+    { /* 1 chip */
+        0x38, 0x00, 0xFE, 0x00, 0xFE, 0x00, 0xC7, 0x01, 0x83, 0x01, 0x11, 0x01,
+        0x83, 0x01, 0xC7, 0x01, 0xFE, 0x00, 0xFE, 0x00, 0x38, 0x00,
+    },
+    { /* 2 chips */
+        0x38, 0x0E, 0xFE, 0x3F, 0xFE, 0x3F, 0xC7, 0x71, 0xC3, 0x61, 0x51, 0x45,
+        0xC3, 0x61, 0xC7, 0x71, 0xFE, 0x3F, 0xFE, 0x3F, 0x38, 0x0E,
+    },
+    { /* 3 chips */
+        0x38, 0x8E, 0x03, 0xFE, 0xFF, 0x0F, 0xFE, 0xFF, 0x0F, 0xC7, 0x71, 0x1C,
+        0xC3, 0x71, 0x18, 0x51, 0x55, 0x11, 0xC3, 0x71, 0x18, 0xC7, 0x71, 0x1C,
+        0xFE, 0xFF, 0x0F, 0xFE, 0xFF, 0x0F, 0x38, 0x8E, 0x03,
+    },
+    { /* 4 chips */
+        0x38, 0x8E, 0xE3, 0x00, 0xFE, 0xFF, 0xFF, 0x03, 0xFE, 0xFF, 0xFF, 0x03,
+        0xC7, 0x71, 0x1C, 0x07, 0xC3, 0x71, 0x1C, 0x06, 0x51, 0x55, 0x55, 0x04,
+        0xC3, 0x71, 0x1C, 0x06, 0xC7, 0x71, 0x1C, 0x07, 0xFE, 0xFF, 0xFF, 0x03,
+        0xFE, 0xFF, 0xFF, 0x03, 0x38, 0x8E, 0xE3, 0x00,
+    },
+    { /* 5 chips */
+        0x38, 0x8E, 0xE3, 0x38, 0x00, 0xFE, 0xFF, 0xFF, 0xFF, 0x00, 0xFE, 0xFF,
+        0xFF, 0xFF, 0x00, 0xC7, 0x71, 0x1C, 0xC7, 0x01, 0xC3, 0x71, 0x1C, 0x87,
+        0x01, 0x51, 0x55, 0x55, 0x15, 0x01, 0xC3, 0x71, 0x1C, 0x87, 0x01, 0xC7,
+        0x71, 0x1C, 0xC7, 0x01, 0xFE, 0xFF, 0xFF, 0xFF, 0x00, 0xFE, 0xFF, 0xFF,
+        0xFF, 0x00, 0x38, 0x8E, 0xE3, 0x38, 0x00,
+    },
+    { /* 6 chips */
+        0x38, 0x8E, 0xE3, 0x38, 0x0E, 0xFE, 0xFF, 0xFF, 0xFF, 0x3F, 0xFE, 0xFF,
+        0xFF, 0xFF, 0x3F, 0xC7, 0x71, 0x1C, 0xC7, 0x71, 0xC3, 0x71, 0x1C, 0xC7,
+        0x61, 0x51, 0x55, 0x55, 0x55, 0x45, 0xC3, 0x71, 0x1C, 0xC7, 0x61, 0xC7,
+        0x71, 0x1C, 0xC7, 0x71, 0xFE, 0xFF, 0xFF, 0xFF, 0x3F, 0xFE, 0xFF, 0xFF,
+        0xFF, 0x3F, 0x38, 0x8E, 0xE3, 0x38, 0x0E,
+    },
+    { /* 7 chips */
+        0x38, 0x8E, 0xE3, 0x38, 0x8E, 0x03, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F,
+        0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0xC7, 0x71, 0x1C, 0xC7, 0x71, 0x1C,
+        0xC3, 0x71, 0x1C, 0xC7, 0x71, 0x18, 0x51, 0x55, 0x55, 0x55, 0x55, 0x11,
+        0xC3, 0x71, 0x1C, 0xC7, 0x71, 0x18, 0xC7, 0x71, 0x1C, 0xC7, 0x71, 0x1C,
+        0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F,
+        0x38, 0x8E, 0xE3, 0x38, 0x8E, 0x03,
+    },
+    { /* 8 chips */
+        0x38, 0x8E, 0xE3, 0x38, 0x8E, 0xE3, 0x00, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0x03, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xC7, 0x71, 0x1C,
+        0xC7, 0x71, 0x1C, 0x07, 0xC3, 0x71, 0x1C, 0xC7, 0x71, 0x1C, 0x06, 0x51,
+        0x55, 0x55, 0x55, 0x55, 0x55, 0x04, 0xC3, 0x71, 0x1C, 0xC7, 0x71, 0x1C,
+        0x06, 0xC7, 0x71, 0x1C, 0xC7, 0x71, 0x1C, 0x07, 0xFE, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0x03, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0x38, 0x8E,
+        0xE3, 0x38, 0x8E, 0xE3, 0x00,
+    },
+};
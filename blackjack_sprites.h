@@ -0,0 +1,27 @@
+/**
+ * 1-bit sprite atlas in flash for draw_callback: every card face, the card back and a chip
+ * stack per bet size, in XBM layout (rows of LSB-first bytes, set bit = black) so each one
+ * is a single canvas_draw_xbm. The art is the PNGs in images/; blackjack_sprites.c is
+ * generated from them by host/bj_sprite_gen (make -C host sprites).
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define SPRITE_CARD_W 16
+#define SPRITE_CARD_H 22
+#define SPRITE_CARD_BYTES ((SPRITE_CARD_W + 7) / 8 * SPRITE_CARD_H)
+
+/* One chip; a stack of n overlaps them SPRITE_CHIP_STEP px apart */
+#define SPRITE_CHIP_W 9
+#define SPRITE_CHIP_H 11
+#define SPRITE_CHIP_STEP 6
+#define SPRITE_CHIP_STACK_MAX 8
+#define SPRITE_CHIP_STACK_W(n) (SPRITE_CHIP_W + SPRITE_CHIP_STEP * ((n) - 1))
+#define SPRITE_CHIP_STACK_BYTES ((SPRITE_CHIP_STACK_W(SPRITE_CHIP_STACK_MAX) + 7) / 8 * SPRITE_CHIP_H)
+
+/* By card index 0-51: suit * 13 + rank, as dealt */
+extern const uint8_t sprite_card_faces[52][SPRITE_CARD_BYTES];
+extern const uint8_t sprite_card_back[SPRITE_CARD_BYTES];
+/* Entry n - 1 is a stack of n chips, SPRITE_CHIP_STACK_W(n) wide */
+extern const uint8_t sprite_chip_stacks[SPRITE_CHIP_STACK_MAX][SPRITE_CHIP_STACK_BYTES];
@@ -0,0 +1,405 @@
+/**
+ * App data store (see blackjack_store.h).
+ */
+#include "blackjack_store.h"
+#include <furi.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TAG "blackjack"
+#define STORE_DIR EXT_PATH("apps_data/blackjack")
+#define STORE_PATH EXT_PATH("apps_data/blackjack/blackjack.dat")
+#define HISTORY_PATH EXT_PATH("apps_data/blackjack/history.bjh")
+static const char STORE_MAGIC[3] = {'B', 'J', 'D'};
+
+/* Files the store replaced, imported once when blackjack.dat does not exist yet */
+#define LEGACY_PROFILES_PATH EXT_PATH("apps_data/blackjack/profiles.dat")
+#define LEGACY_LAST_USED_PATH EXT_PATH("apps_data/blackjack/last_used")
+#define LEGACY_SETTINGS_PATH EXT_PATH("apps_data/blackjack/settings.dat")
+static const char LEGACY_PROFILES_MAGIC[4] = "BJ1";
+static const char LEGACY_SETTINGS_MAGIC[4] = "BJS";
+
+#define STORE_DIRTY_ALL ((uint8_t)(STORE_DIRTY_HEADER | (STORE_DIRTY_HEADER - 1)))
+
+static uint32_t store_checksum(const StoreImage* image) {
+    const uint8_t* p = (const uint8_t*)image;
+    uint32_t h = 2166136261u;
+    for(size_t i = 0; i < offsetof(StoreImage, checksum); i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+static void store_defaults(StoreImage* image) {
+    memset(image, 0, sizeof(*image));
+    memcpy(image->magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    image->version = STORE_VERSION;
+    image->settings = StoreSettingSound | StoreSettingVibro;
+    image->cut_card = CUT_CARD_DEFAULT;
+}
+
+/* Read a whole legacy file of at most size bytes; returns the bytes read, 0 if missing */
+static size_t legacy_read(Storage* storage, const char* path, void* buf, size_t size) {
+    File* file = storage_file_alloc(storage);
+    size_t n = 0;
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        n = storage_file_read(file, buf, size);
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    return n;
+}
+
+/* Same rules as the old loaders: missing or short parts keep the defaults */
+static bool store_import_legacy(StoreImage* image, Storage* storage) {
+    bool found = false;
+    uint8_t profiles[4 + sizeof(image->profiles)];
+    size_t n = legacy_read(storage, LEGACY_PROFILES_PATH, profiles, sizeof(profiles));
+    if(n >= 4 && memcmp(profiles, LEGACY_PROFILES_MAGIC, 4) == 0) {
+        size_t records = (n - 4) / sizeof(ProfileRecord);
+        memcpy(image->profiles, profiles + 4, records * sizeof(ProfileRecord));
+        for(size_t i = 0; i < records; i++) image->profiles[i].name[PROFILE_NAME_LEN - 1] = '\0';
+        found = true;
+    }
+    uint8_t last_used;
+    if(legacy_read(storage, LEGACY_LAST_USED_PATH, &last_used, 1) == 1) {
+        if(last_used < MAX_PROFILES) image->last_used = last_used;
+        found = true;
+    }
+    uint8_t settings[6];
+    n = legacy_read(storage, LEGACY_SETTINGS_PATH, settings, sizeof(settings));
+    if(n >= 4 && memcmp(settings, LEGACY_SETTINGS_MAGIC, 4) == 0) {
+        if(n >= 5) image->settings = settings[4] & (StoreSettingSound | StoreSettingVibro | StoreSettingHitSoft17);
+        if(n >= 6) image->cut_card = settings[5];
+        found = true;
+    }
+    return found;
+}
+
+void store_load(BlackjackStore* store, Storage* storage) {
+    StoreImage* image = &store->image;
+    File* file = storage_file_alloc(storage);
+    bool ok = false;
+    if(storage_file_open(file, STORE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        ok = storage_file_read(file, image, sizeof(*image)) == sizeof(*image) &&
+             memcmp(image->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) == 0 && image->version == STORE_VERSION &&
+             image->checksum == store_checksum(image) && image->last_used < MAX_PROFILES;
+        storage_file_close(file);
+        if(!ok) FURI_LOG_W(TAG, "Ignoring unreadable %s", STORE_PATH);
+    }
+    storage_file_free(file);
+    store->dirty = 0;
+    if(ok) return;
+    store_defaults(image);
+    if(store_import_legacy(image, storage)) {
+        /* Written out at the next save */
+        store->dirty = STORE_DIRTY_ALL;
+    }
+}
+
+/* Open a file in the app's folder for writing, creating the folder on the first save on this card */
+static bool store_open_for_write(Storage* storage, File* file, const char* path, FS_OpenMode mode) {
+    if(storage_file_open(file, path, FSAM_WRITE, mode)) return true;
+    storage_simply_mkdir(storage, EXT_PATH("apps_data"));
+    storage_simply_mkdir(storage, STORE_DIR);
+    return storage_file_open(file, path, FSAM_WRITE, mode);
+}
+
+bool store_flush(BlackjackStore* store, Storage* storage) {
+    if(!store->dirty) return true;
+    store->image.checksum = store_checksum(&store->image);
+    File* file = storage_file_alloc(storage);
+    bool open = store_open_for_write(storage, file, STORE_PATH, FSOM_CREATE_ALWAYS);
+    bool ok = open && storage_file_write(file, &store->image, sizeof(store->image)) == sizeof(store->image) &&
+              storage_file_sync(file);
+    if(open) storage_file_close(file);
+    storage_file_free(file);
+    if(ok) {
+        store->dirty = 0;
+    } else {
+        FURI_LOG_E(TAG, "Cannot write %s", STORE_PATH);
+    }
+    return ok;
+}
+
+void store_get_names(const BlackjackStore* store, BlackjackState* s) {
+    for(uint8_t i = 0; i < MAX_PROFILES; i++) {
+        const char* name = store->image.profiles[i].name;
+        if(name[0] != '\0') {
+            strncpy(s->profile_names[i], name, PROFILE_NAME_LEN - 1);
+            s->profile_names[i][PROFILE_NAME_LEN - 1] = '\0';
+        } else {
+            snprintf(s->profile_names[i], PROFILE_NAME_LEN, "Slot %u", (unsigned)(i + 1));
+        }
+    }
+}
+
+void store_get_profile(const BlackjackStore* store, BlackjackState* s, uint8_t slot) {
+    if(slot >= MAX_PROFILES) return;
+    const ProfileRecord* rec = &store->image.profiles[slot];
+    s->current_profile_slot = slot;
+    s->balance = rec->balance ? rec->balance : STARTING_BALANCE;
+    s->games_played = rec->games_played;
+    s->games_won = rec->games_won;
+    s->games_lost = rec->games_lost;
+    s->games_pushed = rec->games_pushed;
+}
+
+void store_put_profile(BlackjackStore* store, const BlackjackState* s) {
+    uint8_t slot = s->current_profile_slot;
+    if(slot >= MAX_PROFILES) return;
+    ProfileRecord rec;
+    memset(rec.name, 0, sizeof(rec.name));
+    strncpy(rec.name, s->profile_names[slot], PROFILE_NAME_LEN - 1);
+    rec.balance = s->balance;
+    rec.games_played = s->games_played;
+    rec.games_won = s->games_won;
+    rec.games_lost = s->games_lost;
+    rec.games_pushed = s->games_pushed;
+    if(memcmp(&rec, &store->image.profiles[slot], sizeof(rec)) != 0) {
+        store->image.profiles[slot] = rec;
+        store->dirty |= STORE_DIRTY_SLOT(slot);
+    }
+}
+
+void store_erase_profiles(BlackjackStore* store) {
+    for(uint8_t i = 0; i < MAX_PROFILES; i++) {
+        ProfileRecord* rec = &store->image.profiles[i];
+        memset(rec, 0, sizeof(*rec));
+        rec->balance = STARTING_BALANCE;
+        store->dirty |= STORE_DIRTY_SLOT(i);
+    }
+    store_set_last_used(store, 0);
+}
+
+uint8_t store_last_used(const BlackjackStore* store) {
+    return store->image.last_used;
+}
+
+void store_set_last_used(BlackjackStore* store, uint8_t slot) {
+    if(slot >= MAX_PROFILES || slot == store->image.last_used) return;
+    store->image.last_used = slot;
+    store->dirty |= STORE_DIRTY_HEADER;
+}
+
+void store_get_settings(const BlackjackStore* store, BlackjackState* s) {
+    uint8_t flags = store->image.settings;
+    s->sound_on = (flags & StoreSettingSound) != 0;
+    s->vibro_on = (flags & StoreSettingVibro) != 0;
+    s->dealer_hits_soft17 = (flags & StoreSettingHitSoft17) != 0;
+    uint8_t cut_card = store->image.cut_card;
+    s->cut_card = (cut_card >= CUT_CARD_MIN && cut_card <= CUT_CARD_MAX) ? cut_card : CUT_CARD_DEFAULT;
+    s->deal_speed = store->image.deal_speed < DealSpeedCount ? store->image.deal_speed : DealSpeedNormal;
+}
+
+void store_put_settings(BlackjackStore* store, const BlackjackState* s) {
+    uint8_t flags = (s->sound_on ? StoreSettingSound : 0) | (s->vibro_on ? StoreSettingVibro : 0) |
+                    (s->dealer_hits_soft17 ? StoreSettingHitSoft17 : 0);
+    if(flags == store->image.settings && s->cut_card == store->image.cut_card && s->deal_speed == store->image.deal_speed) {
+        return;
+    }
+    store->image.settings = flags;
+    store->image.cut_card = s->cut_card;
+    store->image.deal_speed = s->deal_speed;
+    store->dirty |= STORE_DIRTY_HEADER;
+}
+
+#define STORE_WORKER_QUEUE 8
+#define STORE_WORKER_STACK 2048
+
+typedef struct {
+    StoreSavedCallback done;
+    void* context;
+    bool stop;
+} StoreRequest;
+
+struct StoreWorker {
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+    FuriMutex* mutex; /* Guards everything below */
+    BlackjackStore pending; /* Latest image posted; dirty bits not written yet */
+    bool queued; /* A request is queued and has not taken the image yet */
+    StoreWorkerStats stats;
+    HistoryRing history; /* Hand history records not yet appended to the file */
+};
+
+/* Append what the ring held when the batch started. The bytes are written straight from the
+ * ring: the input thread only pushes past them, so just the ring indexes need the lock. */
+static void store_worker_append_history(StoreWorker* worker, Storage* storage) {
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    size_t pending = worker->history.used;
+    furi_mutex_release(worker->mutex);
+    if(!pending) return;
+
+    File* file = storage_file_alloc(storage);
+    bool open = store_open_for_write(storage, file, HISTORY_PATH, FSOM_OPEN_APPEND);
+    bool ok = open;
+    size_t written = 0;
+    while(ok && written < pending) {
+        const uint8_t* data;
+        furi_mutex_acquire(worker->mutex, FuriWaitForever);
+        size_t size = history_ring_front(&worker->history, &data);
+        furi_mutex_release(worker->mutex);
+        if(size > pending - written) size = pending - written;
+        size_t n = storage_file_write(file, data, size);
+        furi_mutex_acquire(worker->mutex, FuriWaitForever);
+        /* A short write still leaves whole bytes in the file; carry on after them next time */
+        history_ring_consume(&worker->history, n);
+        worker->stats.history_bytes += n;
+        furi_mutex_release(worker->mutex);
+        written += n;
+        ok = (n == size);
+    }
+    if(written) ok = storage_file_sync(file) && ok;
+    if(open) storage_file_close(file);
+    storage_file_free(file);
+
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    worker->stats.history_writes++;
+    if(!ok) worker->stats.failures++;
+    furi_mutex_release(worker->mutex);
+    if(!ok) FURI_LOG_E(TAG, "Cannot append to %s", HISTORY_PATH);
+}
+
+static int32_t store_worker_thread(void* context) {
+    StoreWorker* worker = context;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    StoreRequest batch[STORE_WORKER_QUEUE];
+    bool running = true;
+    while(running) {
+        size_t count = 0;
+        furi_message_queue_get(worker->queue, &batch[count++], FuriWaitForever);
+        /* Everything already queued is covered by this one write */
+        while(count < STORE_WORKER_QUEUE && furi_message_queue_get(worker->queue, &batch[count], 0) == FuriStatusOk) {
+            count++;
+        }
+        furi_mutex_acquire(worker->mutex, FuriWaitForever);
+        BlackjackStore image = worker->pending;
+        worker->pending.dirty = 0;
+        worker->queued = false;
+        furi_mutex_release(worker->mutex);
+
+        bool ok = true;
+        if(image.dirty) {
+            uint32_t start = furi_get_tick();
+            ok = store_flush(&image, storage);
+            uint32_t ms = furi_get_tick() - start;
+            furi_mutex_acquire(worker->mutex, FuriWaitForever);
+            StoreWorkerStats* stats = &worker->stats;
+            stats->writes++;
+            stats->last_ms = ms;
+            if(ms > stats->max_ms) stats->max_ms = ms;
+            stats->total_ms += ms;
+            if(!ok) {
+                stats->failures++;
+                /* Retried with the next request */
+                worker->pending.dirty |= image.dirty;
+            }
+            furi_mutex_release(worker->mutex);
+        }
+        store_worker_append_history(worker, storage);
+        for(size_t i = 0; i < count; i++) {
+            if(batch[i].stop) {
+                running = false;
+            } else if(batch[i].done) {
+                batch[i].done(ok, batch[i].context);
+            }
+        }
+    }
+    furi_record_close(RECORD_STORAGE);
+    const StoreWorkerStats* stats = &worker->stats;
+    FURI_LOG_I(
+        TAG,
+        "Store: %lu saves (%lu coalesced), %lu writes, %lu failed, max queue %lu, write %lu ms max %lu ms mean",
+        (unsigned long)stats->requests,
+        (unsigned long)stats->coalesced,
+        (unsigned long)stats->writes,
+        (unsigned long)stats->failures,
+        (unsigned long)stats->max_depth,
+        (unsigned long)stats->max_ms,
+        (unsigned long)(stats->writes ? stats->total_ms / stats->writes : 0));
+    FURI_LOG_I(
+        TAG,
+        "History: %lu records (%lu dropped), %lu bytes in %lu appends",
+        (unsigned long)stats->history_records,
+        (unsigned long)stats->history_dropped,
+        (unsigned long)stats->history_bytes,
+        (unsigned long)stats->history_writes);
+    return 0;
+}
+
+StoreWorker* store_worker_alloc(void) {
+    StoreWorker* worker = malloc(sizeof(StoreWorker));
+    memset(worker, 0, sizeof(StoreWorker));
+    worker->queue = furi_message_queue_alloc(STORE_WORKER_QUEUE, sizeof(StoreRequest));
+    worker->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    worker->thread = furi_thread_alloc_ex("BlackjackStore", STORE_WORKER_STACK, store_worker_thread, worker);
+    furi_thread_start(worker->thread);
+    return worker;
+}
+
+void store_worker_free(StoreWorker* worker) {
+    StoreRequest stop = {.stop = true};
+    furi_message_queue_put(worker->queue, &stop, FuriWaitForever);
+    furi_thread_join(worker->thread);
+    furi_thread_free(worker->thread);
+    furi_mutex_free(worker->mutex);
+    furi_message_queue_free(worker->queue);
+    free(worker);
+}
+
+void store_worker_save(StoreWorker* worker, BlackjackStore* store, StoreSavedCallback done, void* context) {
+    if(!store->dirty && !done) return;
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    worker->pending.image = store->image;
+    worker->pending.dirty |= store->dirty;
+    store->dirty = 0;
+    worker->stats.requests++;
+    bool post = done || !worker->queued;
+    if(post) {
+        worker->queued = true;
+        uint32_t depth = furi_message_queue_get_count(worker->queue) + 1;
+        if(depth > worker->stats.max_depth) worker->stats.max_depth = depth;
+    } else {
+        worker->stats.coalesced++;
+    }
+    furi_mutex_release(worker->mutex);
+    if(post) {
+        StoreRequest request = {.done = done, .context = context, .stop = false};
+        furi_message_queue_put(worker->queue, &request, FuriWaitForever);
+    }
+}
+
+bool store_worker_log(StoreWorker* worker, const uint8_t* record, size_t size) {
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    bool ok = history_ring_push(&worker->history, record, size);
+    if(ok) {
+        worker->stats.history_records++;
+    } else {
+        worker->stats.history_dropped++;
+    }
+    furi_mutex_release(worker->mutex);
+    return ok;
+}
+
+void store_worker_flush_log(StoreWorker* worker, size_t min_bytes) {
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    /* A queued request appends the ring anyway */
+    bool post = worker->history.used && worker->history.used >= min_bytes && !worker->queued;
+    if(post) {
+        worker->queued = true;
+        uint32_t depth = furi_message_queue_get_count(worker->queue) + 1;
+        if(depth > worker->stats.max_depth) worker->stats.max_depth = depth;
+    }
+    furi_mutex_release(worker->mutex);
+    if(post) {
+        StoreRequest request = {.done = NULL, .context = NULL, .stop = false};
+        furi_message_queue_put(worker->queue, &request, FuriWaitForever);
+    }
+}
+
+void store_worker_get_stats(StoreWorker* worker, StoreWorkerStats* stats) {
+    furi_mutex_acquire(worker->mutex, FuriWaitForever);
+    *stats = worker->stats;
+    furi_mutex_release(worker->mutex);
+}
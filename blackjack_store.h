@@ -0,0 +1,106 @@
+/**
+ * App data store: profiles, the last used profile and settings in one versioned file,
+ * apps_data/blackjack/blackjack.dat, read into RAM once at startup. Changes are made to the
+ * RAM image and marked dirty per profile slot; store_flush writes the whole image (one SD
+ * sector) with a single write and sync, and does nothing when nothing changed.
+ * On first run the older profiles.dat, last_used and settings.dat are imported.
+ */
+#pragma once
+
+#include "blackjack_game.h"
+#include "blackjack_history.h"
+#include <storage/storage.h>
+
+#define STORE_VERSION 1
+
+#pragma pack(push, 1)
+typedef struct {
+    char name[PROFILE_NAME_LEN]; /* Empty = never named */
+    uint16_t balance; /* 0 = never saved, starts at STARTING_BALANCE */
+    uint16_t games_played;
+    uint16_t games_won;
+    uint16_t games_lost;
+    uint16_t games_pushed;
+} ProfileRecord;
+
+typedef struct {
+    char magic[3]; /* "BJD" */
+    uint8_t version; /* STORE_VERSION */
+    uint8_t last_used; /* Profile slot "Continue" loads */
+    uint8_t settings; /* StoreSetting bits */
+    uint8_t cut_card;
+    uint8_t deal_speed; /* DealSpeed; was reserved (0), which reads as Normal */
+    ProfileRecord profiles[MAX_PROFILES];
+    uint32_t checksum; /* FNV-1a of everything above */
+} StoreImage;
+#pragma pack(pop)
+
+typedef enum {
+    StoreSettingSound = 1 << 0,
+    StoreSettingVibro = 1 << 1,
+    StoreSettingHitSoft17 = 1 << 2,
+} StoreSetting;
+
+/* Dirty bit for profile slot n; STORE_DIRTY_HEADER covers last_used and the settings */
+#define STORE_DIRTY_SLOT(n) (1u << (n))
+#define STORE_DIRTY_HEADER (1u << MAX_PROFILES)
+
+typedef struct {
+    StoreImage image;
+    uint8_t dirty; /* STORE_DIRTY_* bits changed since the last flush */
+} BlackjackStore;
+
+/* Read the store (or import the legacy files, or start empty) */
+void store_load(BlackjackStore* store, Storage* storage);
+/* Write the image if anything is dirty; false if the write failed (it stays dirty) */
+bool store_flush(BlackjackStore* store, Storage* storage);
+
+/* Slot names for the menus; unnamed slots read "Slot n" */
+void store_get_names(const BlackjackStore* store, BlackjackState* s);
+/* Balance and statistics of a slot into the state; sets current_profile_slot */
+void store_get_profile(const BlackjackStore* store, BlackjackState* s, uint8_t slot);
+/* Name, balance and statistics of the state's current slot into the image */
+void store_put_profile(BlackjackStore* store, const BlackjackState* s);
+/* All slots back to unnamed with STARTING_BALANCE, last used = 0 */
+void store_erase_profiles(BlackjackStore* store);
+
+uint8_t store_last_used(const BlackjackStore* store);
+void store_set_last_used(BlackjackStore* store, uint8_t slot);
+
+void store_get_settings(const BlackjackStore* store, BlackjackState* s);
+void store_put_settings(BlackjackStore* store, const BlackjackState* s);
+
+/* Background writer: store_flush on its own thread, so input never waits on the SD card.
+ * It also owns the hand history ring; every write it makes appends what the ring holds to
+ * the history file, and it drains the ring before stopping. */
+typedef void (*StoreSavedCallback)(bool ok, void* context);
+
+typedef struct {
+    uint32_t requests; /* store_worker_save calls */
+    uint32_t coalesced; /* Requests folded into a write already queued */
+    uint32_t writes; /* Image writes (store_flush with something dirty) */
+    uint32_t failures;
+    uint32_t max_depth; /* Most requests queued at once */
+    uint32_t last_ms; /* Write latency, open to close */
+    uint32_t max_ms;
+    uint32_t total_ms;
+    uint32_t history_records; /* Records taken into the ring */
+    uint32_t history_dropped; /* Records lost to a full ring */
+    uint32_t history_writes; /* Appends to the history file */
+    uint32_t history_bytes;
+} StoreWorkerStats;
+
+typedef struct StoreWorker StoreWorker;
+
+StoreWorker* store_worker_alloc(void);
+/* Finish the queued writes, then stop the thread; it logs its stats on the way out */
+void store_worker_free(StoreWorker* worker);
+/* Take a copy of the store's image and queue a write if anything is dirty. done, if not NULL,
+ * runs on the worker thread once the write is finished. A request without a callback made
+ * while another write is still queued is folded into that write. */
+void store_worker_save(StoreWorker* worker, BlackjackStore* store, StoreSavedCallback done, void* context);
+/* Copy one hand history record into the ring; no I/O. False if the ring is full (it is dropped). */
+bool store_worker_log(StoreWorker* worker, const uint8_t* record, size_t size);
+/* Queue a history append once the ring holds at least min_bytes */
+void store_worker_flush_log(StoreWorker* worker, size_t min_bytes);
+void store_worker_get_stats(StoreWorker* worker, StoreWorkerStats* stats);
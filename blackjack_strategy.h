@@ -0,0 +1,86 @@
+/**
+ * Basic strategy lookup.
+ * Each table row is one hand total packed as 10 two-bit cells (dealer upcard 2..10, A),
+ * so a lookup is one indexed load and a shift. The tables in blackjack_strategy_tables.c
+ * are generated by host/bj_strategy_gen from an exact composition-dependent solve of the
+ * shoe, summed per cell, under this engine's rules:
+ * dealer peeks, 3:2 blackjack, double on any two cards and after split, one split per hand,
+ * a 6-card hand wins for the player and busts the dealer. One table set per dealer soft 17 rule.
+ */
+#pragma once
+
+#include "blackjack_game.h"
+
+typedef enum {
+    StrategyStand,
+    StrategyHit,
+    StrategyDouble,
+    StrategySplit,
+} StrategyAction;
+
+/* Cell values in the hard/soft rows */
+#define STRATEGY_CELL_STAND 0
+#define STRATEGY_CELL_HIT 1
+#define STRATEGY_CELL_DOUBLE_HIT 2   /* Double if allowed, else hit */
+#define STRATEGY_CELL_DOUBLE_STAND 3 /* Double if allowed, else stand */
+
+#define STRATEGY_COUNTS 4     /* Rows per card count 2, 3, 4, 5 (the 6-card rules change late hits) */
+#define STRATEGY_HARD_MIN 4   /* 2,2 kept together */
+#define STRATEGY_HARD_ROWS 18 /* Hard 4-21 */
+#define STRATEGY_SOFT_MIN 12  /* A,A kept together */
+#define STRATEGY_SOFT_ROWS 10 /* Soft 12-21 */
+#define STRATEGY_PAIR_ROWS 10 /* Pair of A, 2, ..., 10 by card points - 1; cell 1 = split */
+
+typedef struct {
+    uint32_t hard[STRATEGY_COUNTS][STRATEGY_HARD_ROWS];
+    uint32_t soft[STRATEGY_COUNTS][STRATEGY_SOFT_ROWS];
+    uint32_t pairs[STRATEGY_PAIR_ROWS];
+} StrategyTables;
+
+/* Indexed by dealer_hits_soft17 */
+extern const StrategyTables strategy_tables[2];
+
+/* Dealer upcard column: 2..10 -> 0..8, Ace -> 9 */
+static inline uint8_t strategy_column(uint8_t dealer_card) {
+    uint8_t p = card_points[dealer_card % 52];
+    return p == 1 ? 9 : p - 2;
+}
+
+static inline uint8_t strategy_cell(uint32_t row, uint8_t column) {
+    return (row >> (column * 2)) & 3;
+}
+
+/* Best action for a hand; is_pair means two cards of the same rank (the only splittable hands) */
+static inline StrategyAction strategy_lookup(
+    const HandTotals* totals,
+    uint8_t count,
+    uint8_t dealer_card,
+    bool is_pair,
+    bool can_double,
+    bool can_split,
+    bool hits_soft17) {
+    const StrategyTables* t = &strategy_tables[hits_soft17 ? 1 : 0];
+    uint8_t column = strategy_column(dealer_card);
+    if(is_pair && can_split && strategy_cell(t->pairs[totals->hard / 2 - 1], column)) return StrategySplit;
+    uint8_t value = hand_totals_value(totals);
+    if(value > 21) return StrategyStand;
+    uint8_t c = count < 2 ? 0 : count > 5 ? STRATEGY_COUNTS - 1 : count - 2;
+    uint32_t row;
+    if(totals->soft) {
+        row = t->soft[c][value - STRATEGY_SOFT_MIN];
+    } else {
+        row = t->hard[c][value < STRATEGY_HARD_MIN ? 0 : value - STRATEGY_HARD_MIN];
+    }
+    uint8_t cell = strategy_cell(row, column);
+    if(cell >= STRATEGY_CELL_DOUBLE_HIT) {
+        if(can_double) return StrategyDouble;
+        return cell == STRATEGY_CELL_DOUBLE_HIT ? StrategyHit : StrategyStand;
+    }
+    return (StrategyAction)cell;
+}
+
+/* "Stand", "Hit", "Double" or "Split" for the practice-mode hint */
+static inline const char* strategy_action_name(StrategyAction action) {
+    static const char* const names[] = {"Stand", "Hit", "Double", "Split"};
+    return names[action & 3];
+}
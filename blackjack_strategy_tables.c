@@ -0,0 +1,101 @@
+/**
+ * Basic strategy tables (see blackjack_strategy.h).
+ * From the exact 3-deck composition-dependent solve, summed per cell.
+ * Generated by host/bj_strategy_gen (make -C host strategy); do not edit by hand.
+ */
+#include "blackjack_strategy.h"
+
+const StrategyTables strategy_tables[2] = {
+    { /* Dealer stands on soft 17 */
+        .hard = {
+            { /* 2 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x556AA,
+                0x5AAAA, 0x6AAAA, 0x55405, 0x55400, 0x55400, 0x55400,
+                0x55400, 0x00000, 0x00000, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 3 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55555, 0x55555, 0x55405, 0x55400, 0x55400, 0x55400,
+                0x45400, 0x00000, 0x00000, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 4 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55555, 0x55555, 0x55515, 0x55401, 0x55400, 0x55400,
+                0x45400, 0x00000, 0x00000, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 5 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55401, 0x54000, 0x00000, 0x00000, 0x00000, 0x00000,
+            },
+        }, /* Hard 4-21 */
+        .soft = {
+            { /* 2 cards */
+                0x55555, 0x55695, 0x55695, 0x556A5, 0x556A5, 0x556AA,
+                0x543FF, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 3 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x54000, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 4 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55155, 0x10000, 0x00000, 0x00000,
+            },
+            { /* 5 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55555, 0x55555, 0x55555, 0x55555,
+            },
+        }, /* Soft 12-21 */
+        .pairs = {
+            0x55555, 0x00555, 0x00555, 0x00140, 0x00000, 0x00155,
+            0x00555, 0x55555, 0x05155, 0x00000,
+        }, /* Pairs by card points, Ace = 1: 1-10 */
+    },
+    { /* Dealer hits soft 17 */
+        .hard = {
+            { /* 2 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x556AA,
+                0x5AAAA, 0xAAAAA, 0x55405, 0x55400, 0x55400, 0x55400,
+                0x55400, 0x00000, 0x00000, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 3 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55555, 0x55555, 0x55405, 0x55400, 0x55400, 0x55400,
+                0x45400, 0x00000, 0x00000, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 4 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55555, 0x55555, 0x55415, 0x55400, 0x55400, 0x55400,
+                0x45400, 0x00000, 0x00000, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 5 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55455,
+                0x55400, 0x54000, 0x00000, 0x00000, 0x00000, 0x00000,
+            },
+        }, /* Hard 4-21 */
+        .soft = {
+            { /* 2 cards */
+                0x55655, 0x55695, 0x55695, 0x556A5, 0x556A5, 0x556AA,
+                0x543FF, 0x00300, 0x00000, 0x00000,
+            },
+            { /* 3 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x54000, 0x00000, 0x00000, 0x00000,
+            },
+            { /* 4 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55155, 0x10000, 0x00000, 0x00000,
+            },
+            { /* 5 cards */
+                0x55555, 0x55555, 0x55555, 0x55555, 0x55555, 0x55555,
+                0x55555, 0x55555, 0x55555, 0x55555,
+            },
+        }, /* Soft 12-21 */
+        .pairs = {
+            0x55555, 0x00555, 0x00555, 0x00140, 0x00000, 0x00155,
+            0x00555, 0x55555, 0x05155, 0x00000,
+        }, /* Pairs by card points, Ace = 1: 1-10 */
+    },
+};
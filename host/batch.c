@@ -0,0 +1,108 @@
+/**
+ * Batch hand evaluation (see batch.h).
+ */
+#include "batch.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t BatchVec __attribute__((vector_size(BATCH_LANES)));
+typedef int8_t BatchMask __attribute__((vector_size(BATCH_LANES)));
+
+/* Arrays are aligned to 64 bytes and sized to whole vectors, so loads never split or run over */
+static inline BatchVec batch_load(const uint8_t* p) {
+    return *(const BatchVec*)p;
+}
+
+bool hand_batch_init(HandBatch* b, size_t capacity) {
+    memset(b, 0, sizeof(*b));
+    capacity = (capacity + 63) & ~(size_t)63;
+    b->capacity = capacity;
+    for(int i = 0; i < MAX_HAND; i++) {
+        b->points[i] = aligned_alloc(64, capacity);
+        if(!b->points[i]) {
+            hand_batch_free(b);
+            return false;
+        }
+    }
+    b->cards = aligned_alloc(64, capacity);
+    if(!b->cards) {
+        hand_batch_free(b);
+        return false;
+    }
+    hand_batch_clear(b);
+    return true;
+}
+
+void hand_batch_free(HandBatch* b) {
+    for(int i = 0; i < MAX_HAND; i++) free(b->points[i]);
+    free(b->cards);
+    memset(b, 0, sizeof(*b));
+}
+
+void hand_batch_clear(HandBatch* b) {
+    for(int i = 0; i < MAX_HAND; i++) memset(b->points[i], 0, b->capacity);
+    memset(b->cards, 0, b->capacity);
+    b->count = 0;
+}
+
+void hand_batch_push(HandBatch* b, const uint8_t* hand, uint8_t count) {
+    if(b->count == b->capacity) return;
+    size_t h = b->count++;
+    /* Every slot is written and masked, so a random card count costs no mispredicted branch */
+    for(uint8_t i = 0; i < MAX_HAND; i++) {
+        b->points[i][h] = card_points[hand[i]] & (uint8_t)-(i < count);
+    }
+    b->cards[h] = count;
+}
+
+void hand_batch_push_states(HandBatch* players, HandBatch* dealers, const BlackjackState* states, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        hand_batch_push(players, states[i].player_hand, states[i].player_count);
+        hand_batch_push(dealers, states[i].dealer_hand, states[i].dealer_count);
+    }
+}
+
+/* Hard total and soft flag (all ones) of BATCH_LANES hands starting at h */
+static inline void batch_hand(const HandBatch* b, size_t h, BatchVec* value, BatchVec* soft) {
+    BatchVec hard = batch_load(b->points[0] + h);
+    BatchVec ace = (BatchVec)(hard == 1);
+    for(int i = 1; i < MAX_HAND; i++) {
+        BatchVec p = batch_load(b->points[i] + h);
+        hard += p;
+        ace |= (BatchVec)(p == 1);
+    }
+    *soft = ace & (BatchVec)(hard <= 11);
+    *value = hard + (*soft & 10);
+}
+
+void hand_batch_totals(const HandBatch* b, uint8_t* value, uint8_t* soft, uint8_t* bust) {
+    for(size_t h = 0; h < b->capacity; h += BATCH_LANES) {
+        BatchVec v, s;
+        batch_hand(b, h, &v, &s);
+        memcpy(value + h, &v, sizeof(v));
+        s &= 1;
+        memcpy(soft + h, &s, sizeof(s));
+        BatchVec over = (BatchVec)(v > 21) & 1;
+        memcpy(bust + h, &over, sizeof(over));
+    }
+}
+
+void hand_batch_settle(const HandBatch* players, const HandBatch* dealers, int8_t* outcome) {
+    size_t n = players->capacity < dealers->capacity ? players->capacity : dealers->capacity;
+    for(size_t h = 0; h < n; h += BATCH_LANES) {
+        BatchVec pv, dv, unused;
+        batch_hand(players, h, &pv, &unused);
+        batch_hand(dealers, h, &dv, &unused);
+        BatchVec pcards = batch_load(players->cards + h);
+        BatchVec dcards = batch_load(dealers->cards + h);
+        /* A 6th dealer card without busting settles as a bust */
+        BatchVec dealer_six = (BatchVec)(dcards == MAX_HAND) & (BatchVec)(dv <= 21);
+        dv = (dv & ~dealer_six) | (dealer_six & 22);
+        BatchVec player_bust = (BatchVec)(pv > 21);
+        BatchVec win = ~player_bust & ((BatchVec)(pcards == MAX_HAND) | (BatchVec)(dv > 21) | (BatchVec)(pv > dv));
+        BatchVec lose = player_bust | (~win & (BatchVec)(pv < dv));
+        /* Masks are all ones (-1) when set, so lose - win is -1, 0 or +1 */
+        BatchMask out = (BatchMask)lose - (BatchMask)win;
+        memcpy(outcome + h, &out, sizeof(out));
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * Batch evaluation of many independent hands at once, for bulk simulation.
+ * Hands are transposed into a structure of arrays (card slot i of every hand side by side, as
+ * card points) so totals and settlement run BATCH_LANES hands per instruction. The kernels
+ * mirror hand_value and the per-hand branches of game_show_result, and are written with GCC
+ * vector extensions: the compiler emits SSE2, AVX2 (build with -mavx2 or -march=native) or NEON
+ * from the same source.
+ */
+#pragma once
+
+#include "blackjack_game.h"
+#include <stddef.h>
+
+#if defined(__AVX2__)
+#define BATCH_LANES 32
+#else
+#define BATCH_LANES 16
+#endif
+
+typedef struct {
+    size_t capacity; /* Hands, rounded up to a multiple of 64 (and so of BATCH_LANES) */
+    size_t count;
+    uint8_t* points[MAX_HAND]; /* points[i][h]: points of card i of hand h, 0 past its last card */
+    uint8_t* cards; /* Cards in each hand */
+} HandBatch;
+
+/* Room for at least capacity hands; false if out of memory */
+bool hand_batch_init(HandBatch* b, size_t capacity);
+void hand_batch_free(HandBatch* b);
+void hand_batch_clear(HandBatch* b);
+
+/* Append one hand of card codes 0-51; hand has MAX_HAND entries, those past count are ignored.
+ * Does nothing when the batch is full. */
+void hand_batch_push(HandBatch* b, const uint8_t* hand, uint8_t count);
+
+/* Append each state's first player hand and dealer hand */
+void hand_batch_push_states(HandBatch* players, HandBatch* dealers, const BlackjackState* states, size_t n);
+
+/* Per hand: value as hand_value, soft = 1 if an Ace counts 11, bust = 1 if over 21.
+ * Each output holds b->capacity entries; entries past b->count are zero hands. */
+void hand_batch_totals(const HandBatch* b, uint8_t* value, uint8_t* soft, uint8_t* bust);
+
+/* +1 win, 0 push, -1 loss for player hand h against dealer hand h, in game_show_result's order:
+ * player bust, 6-card player win, dealer bust (including 6 cards), then higher total.
+ * Naturals are settled at the deal and are not handled here. outcome holds capacity entries. */
+void hand_batch_settle(const HandBatch* players, const HandBatch* dealers, int8_t* outcome);
@@ -0,0 +1,264 @@
+/**
+ * Shuffle benchmark: time per 156-card shoe for the old rand() % n shuffle
+ * against the engine's shuffle_deck with each BlackjackRng generator.
+ *
+ * Dealer outcome benchmark: deals shoes in rounds and, after each card, asks for the dealer
+ * distribution of the round's upcard from a DealerCache and from a single path list that is
+ * rebuilt whenever the upcard changes, reporting the time per query and the largest difference.
+ *
+ * Batch benchmark: totals and settlement of many random player/dealer hand pairs, by a scalar
+ * loop over hand_value against the structure-of-arrays kernels in batch.h, with and without
+ * the transpose, checking that both give the same outcomes.
+ *
+ *   bj_bench [-n shoes] [-d dealer_shoes] [-b hands]
+ */
+#include "batch.h"
+#include "blackjack_dealer.h"
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec * 1e9 + (double)t.tv_nsec;
+}
+
+/* The shuffle as it was before the RNG layer: global rand() with modulo bias */
+static void shuffle_deck_rand(uint8_t* deck) {
+    for(int i = 0; i < DECK_SIZE; i++) {
+        deck[i] = (uint8_t)(i % 52);
+    }
+    for(int i = DECK_SIZE - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        uint8_t t = deck[i];
+        deck[i] = deck[j];
+        deck[j] = t;
+    }
+}
+
+static volatile uint8_t sink;
+
+static double bench_rand(long shoes) {
+    uint8_t deck[DECK_SIZE];
+    srand(1);
+    double t0 = now_ns();
+    for(long i = 0; i < shoes; i++) {
+        shuffle_deck_rand(deck);
+        sink = deck[0];
+    }
+    return (now_ns() - t0) / (double)shoes;
+}
+
+static double bench_engine(long shoes, BlackjackRngKind kind) {
+    uint8_t deck[DECK_SIZE];
+    BlackjackRng rng = {.kind = kind};
+    blackjack_rng_seed(&rng, 1, 0);
+    double t0 = now_ns();
+    for(long i = 0; i < shoes; i++) {
+        shuffle_deck(deck, &rng);
+        sink = deck[0];
+    }
+    return (now_ns() - t0) / (double)shoes;
+}
+
+/* Cards per simulated round for the dealer benchmark; the upcard changes every round */
+#define BENCH_ROUND_CARDS 5
+
+typedef struct {
+    double rebuild_ns;
+    double cache_ns;
+    double max_error;
+    long queries;
+} DealerBench;
+
+/* Rounds of BENCH_ROUND_CARDS cards; after each card, the round's upcard is queried once from a
+ * DealerCache and once the way a single path list would serve it: rebuilt when the upcard changes,
+ * then a full pass */
+static void bench_dealer(long shoes, bool hits_soft17, DealerBench* out) {
+    static DealerCache cache, single;
+    uint8_t deck[DECK_SIZE];
+    BlackjackRng rng = {.kind = BlackjackRngXoshiro128};
+    dealer_cache_init(&cache);
+    dealer_cache_set_rule(&cache, hits_soft17);
+    memset(out, 0, sizeof(*out));
+    for(long i = 0; i < shoes; i++) {
+        ShoeCounts shoe;
+        DealerPaths paths = {0};
+        blackjack_rng_seed(&rng, 1, (uint32_t)i);
+        shuffle_deck(deck, &rng);
+        shoe_counts_full(&shoe);
+        for(int d = BURN_TOP; d + BENCH_ROUND_CARDS <= CUT_CARD_DEFAULT; d += BENCH_ROUND_CARDS) {
+            uint8_t up = card_points[deck[d + 1]];
+            for(int k = 0; k < BENCH_ROUND_CARDS; k++) {
+                shoe.n[card_points[deck[d + k]]]--;
+                shoe.total--;
+                float ref[DEALER_OUTCOMES];
+                double t0 = now_ns();
+                if(paths.up != up) {
+                    dealer_cache_init(&single);
+                    dealer_cache_set_rule(&single, hits_soft17);
+                    dealer_cache_paths(&single, up, &paths);
+                }
+                dealer_paths_outcomes(&paths, &shoe, ref);
+                double t1 = now_ns();
+                dealer_cache_set_shoe(&cache, &shoe);
+                const float* got = dealer_cache_outcomes(&cache, up);
+                double t2 = now_ns();
+                out->rebuild_ns += t1 - t0;
+                out->cache_ns += t2 - t1;
+                for(int o = 0; o < DEALER_OUTCOMES; o++) {
+                    double err = fabs((double)got[o] - (double)ref[o]);
+                    if(err > out->max_error) out->max_error = err;
+                }
+                out->queries++;
+            }
+        }
+    }
+}
+
+/* Array-of-structs hand pair, the layout the scalar loop reads */
+typedef struct {
+    uint8_t player[MAX_HAND];
+    uint8_t dealer[MAX_HAND];
+    uint8_t player_count;
+    uint8_t dealer_count;
+} BenchHands;
+
+/* game_show_result's per-hand branches on hand_value */
+static int8_t settle_scalar(const BenchHands* x) {
+    uint8_t pv = hand_value(x->player, x->player_count);
+    uint8_t dv = hand_value(x->dealer, x->dealer_count);
+    if(x->dealer_count == MAX_HAND && dv <= 21) dv = 22;
+    if(pv > 21) return -1;
+    if(x->player_count == MAX_HAND) return 1;
+    if(dv > 21) return 1;
+    if(pv > dv) return 1;
+    if(pv < dv) return -1;
+    return 0;
+}
+
+typedef struct {
+    double scalar_ns;
+    double kernel_ns;
+    double transpose_ns;
+    long mismatches;
+} BatchBench;
+
+static void bench_batch(size_t n, int rounds, BatchBench* out) {
+    BenchHands* hands = malloc(n * sizeof(BenchHands));
+    int8_t* expect = malloc(n);
+    int8_t* got = aligned_alloc(64, (n + 63) & ~(size_t)63);
+    HandBatch players, dealers;
+    if(!hands || !expect || !got || !hand_batch_init(&players, n) || !hand_batch_init(&dealers, n)) {
+        fprintf(stderr, "bj_bench: out of memory\n");
+        exit(1);
+    }
+    /* Random 2-6 card hands from shuffled shoes; busted and 6-card hands included */
+    BlackjackRng rng = {.kind = BlackjackRngXoshiro128};
+    uint8_t deck[DECK_SIZE];
+    int top = DECK_SIZE;
+    blackjack_rng_seed(&rng, 1, 0);
+    for(size_t i = 0; i < n; i++) {
+        if(top > DECK_SIZE - 2 * MAX_HAND) {
+            shuffle_deck(deck, &rng);
+            top = 0;
+        }
+        hands[i].player_count = (uint8_t)(2 + blackjack_rng_bounded(&rng, MAX_HAND - 1));
+        hands[i].dealer_count = (uint8_t)(2 + blackjack_rng_bounded(&rng, MAX_HAND - 1));
+        for(int k = 0; k < MAX_HAND; k++) hands[i].player[k] = deck[top++];
+        for(int k = 0; k < MAX_HAND; k++) hands[i].dealer[k] = deck[top++];
+    }
+
+    memset(out, 0, sizeof(*out));
+    long sum = 0;
+    for(int r = 0; r < rounds; r++) {
+        double t0 = now_ns();
+        for(size_t i = 0; i < n; i++) expect[i] = settle_scalar(&hands[i]);
+        double t1 = now_ns();
+        hand_batch_clear(&players);
+        hand_batch_clear(&dealers);
+        for(size_t i = 0; i < n; i++) {
+            hand_batch_push(&players, hands[i].player, hands[i].player_count);
+            hand_batch_push(&dealers, hands[i].dealer, hands[i].dealer_count);
+        }
+        double t2 = now_ns();
+        hand_batch_settle(&players, &dealers, got);
+        double t3 = now_ns();
+        out->scalar_ns += t1 - t0;
+        out->transpose_ns += t2 - t1;
+        out->kernel_ns += t3 - t2;
+        sum += got[r % n];
+    }
+    sink = (uint8_t)sum;
+    for(size_t i = 0; i < n; i++) out->mismatches += expect[i] != got[i];
+    double hands_run = (double)n * rounds;
+    out->scalar_ns /= hands_run;
+    out->transpose_ns /= hands_run;
+    out->kernel_ns /= hands_run;
+    hand_batch_free(&players);
+    hand_batch_free(&dealers);
+    free(hands);
+    free(expect);
+    free(got);
+}
+
+int main(int argc, char** argv) {
+    long shoes = 200000;
+    long dealer_shoes = 200;
+    long batch_hands = 1 << 16;
+    int opt;
+    while((opt = getopt(argc, argv, "n:d:b:h")) != -1) {
+        switch(opt) {
+        case 'n':
+            shoes = strtol(optarg, NULL, 10);
+            break;
+        case 'd':
+            dealer_shoes = strtol(optarg, NULL, 10);
+            break;
+        case 'b':
+            batch_hands = strtol(optarg, NULL, 10);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n shoes] [-d dealer_shoes] [-b hands]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(shoes < 1) shoes = 1;
+    if(dealer_shoes < 1) dealer_shoes = 1;
+    if(batch_hands < 1) batch_hands = 1;
+
+    /* Warm up caches and branch predictors before timing */
+    bench_rand(shoes / 10 + 1);
+    bench_engine(shoes / 10 + 1, BlackjackRngXoshiro128);
+
+    double base = bench_rand(shoes);
+    double xo = bench_engine(shoes, BlackjackRngXoshiro128);
+    double pcg = bench_engine(shoes, BlackjackRngPcg32);
+    printf("shuffle, ns per %d-card shoe (%ld shoes)\n", DECK_SIZE, shoes);
+    printf("  rand() %% n          %8.1f   1.00x\n", base);
+    printf("  xoshiro128** bounded %8.1f   %.2fx\n", xo, base / xo);
+    printf("  pcg32 bounded        %8.1f   %.2fx\n", pcg, base / pcg);
+
+    printf("\ndealer outcomes, ns per query, %d-card rounds (%ld shoes, %zu-byte cache)\n", BENCH_ROUND_CARDS, dealer_shoes, sizeof(DealerCache));
+    for(int h17 = 0; h17 < 2; h17++) {
+        DealerBench b;
+        bench_dealer(dealer_shoes, h17, &b);
+        double rebuild = b.rebuild_ns / (double)b.queries;
+        double cached = b.cache_ns / (double)b.queries;
+        printf("  %s one list, full pass %9.1f   1.00x\n", h17 ? "H17" : "S17", rebuild);
+        printf("  %s DealerCache         %9.1f   %.2fx   max error %.1e\n", h17 ? "H17" : "S17", cached, rebuild / cached, b.max_error);
+    }
+
+    BatchBench bb;
+    bench_batch((size_t)batch_hands, 20, &bb);
+    printf("\nsettlement, ns per player/dealer hand pair (%ld hands, %d lanes)\n", batch_hands, BATCH_LANES);
+    printf("  scalar hand_value       %7.2f   1.00x\n", bb.scalar_ns);
+    printf("  batch kernel            %7.2f   %.2fx\n", bb.kernel_ns, bb.scalar_ns / bb.kernel_ns);
+    printf("  batch incl. transpose   %7.2f   %.2fx\n", bb.kernel_ns + bb.transpose_ns, bb.scalar_ns / (bb.kernel_ns + bb.transpose_ns));
+    printf("  mismatches              %ld\n", bb.mismatches);
+    return 0;
+}
@@ -0,0 +1,468 @@
+/**
+ * Hand history analyzer.
+ * Reads history.bjh files pulled off devices (or written by bj_sim -L) and reports EV and
+ * variance, win rate by starting hand and dealer upcard, how doubles, splits and insurance
+ * turned out, and how often play departed from basic strategy.
+ *
+ * Files are memory-mapped and decoded in place, in chunks spread over the work-stealing
+ * pool. Records carry no sync marks, so a chunk starts at the first offset from which a run
+ * of records decodes cleanly. Afterwards each chunk must start where the one before it
+ * stopped; one that does not is decoded again from there. Statistics are integer sums merged
+ * in file order, so any thread count prints the same numbers.
+ *
+ *   bj_history [-j threads] [-e] [-q] history.bjh...
+ */
+#include "blackjack_history.h"
+#include "blackjack_strategy.h"
+#include "pool.h"
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HIST_CHUNK (8u << 20)
+#define HIST_SYNC_RECORDS 8 /* Clean records in a row that mark a record boundary */
+
+/* Starting hand rows: hard 5-20, soft A,2-A,9, blackjack, then pairs 2,2-10,10 and A,A */
+#define HIST_ROW_HARD 0
+#define HIST_ROW_SOFT 16
+#define HIST_ROW_BLACKJACK 24
+#define HIST_ROW_PAIR 25
+#define HIST_ROWS 35
+#define HIST_COLS 10 /* Dealer upcard 2-10, A (strategy_column) */
+
+typedef struct {
+    uint64_t hands;
+    uint64_t wins;
+    int64_t net;
+    uint64_t wagered;
+} HistCell;
+
+typedef struct {
+    uint64_t sessions;
+    uint64_t hands;
+    uint64_t wins;
+    uint64_t losses;
+    uint64_t pushes;
+    int64_t net; /* Dollars */
+    uint64_t net_sq; /* Sum of squared per-hand results, for the variance */
+    uint64_t wagered; /* Opening bets */
+    uint64_t blackjacks;
+    uint64_t doubles; /* Hands doubled, split hands included */
+    uint64_t double_results[4]; /* By HandOutcome */
+    int64_t double_net;
+    uint64_t splits; /* Rounds split */
+    uint64_t split_results[4]; /* Split hands by HandOutcome */
+    int64_t split_net;
+    uint64_t insurance_offered;
+    uint64_t insurance_taken;
+    uint64_t insurance_won;
+    int64_t insurance_net;
+    uint64_t decisions[4][4]; /* [basic strategy][played], by StrategyAction */
+    uint64_t bad_records;
+    uint64_t skipped_bytes; /* Bad or cut-off records */
+    HistCell cells[HIST_ROWS][HIST_COLS];
+} HistStats;
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+} HistFile;
+
+typedef struct {
+    const HistFile* file;
+    size_t start; /* Chunk [start, end); it owns the records that begin inside it */
+    size_t end;
+    size_t sync; /* Where decoding started */
+    size_t stop; /* Where the last record it owned ended */
+    HistStats stats;
+} HistTask;
+
+static const char* const action_names[4] = {"stand", "hit", "double", "split"};
+
+static bool hist_runs_clean(const uint8_t* data, size_t size, size_t pos) {
+    for(int i = 0; i < HIST_SYNC_RECORDS && pos < size; i++) {
+        HistoryRecord r;
+        size_t n = history_decode(data + pos, size - pos, &r);
+        if(!n || r.kind > HistoryKindHand || (r.kind == HistoryKindSession && r.version != HISTORY_VERSION)) return false;
+        pos += n;
+    }
+    return true;
+}
+
+/* First record boundary at or after pos; size if there is none */
+static size_t hist_sync(const uint8_t* data, size_t size, size_t pos) {
+    while(pos < size && !hist_runs_clean(data, size, pos)) pos++;
+    return pos;
+}
+
+static unsigned hist_row(uint8_t a, uint8_t b) {
+    uint8_t pa = card_points[a], pb = card_points[b];
+    if(CARD_RANK(a) == CARD_RANK(b)) return HIST_ROW_PAIR + (pa == 1 ? 9 : pa - 2);
+    if(pa == 1 || pb == 1) {
+        uint8_t other = pa + pb - 1;
+        return other == 10 ? HIST_ROW_BLACKJACK : HIST_ROW_SOFT + other - 2;
+    }
+    return HIST_ROW_HARD + pa + pb - 5;
+}
+
+static int64_t hist_hand_net(HandOutcome outcome, int64_t bet) {
+    switch(outcome) {
+    case HandWon:
+        return bet;
+    case HandBlackjack:
+        return bet * 3 / 2;
+    case HandLost:
+        return -bet;
+    default:
+        return 0;
+    }
+}
+
+/* Decisions on one hand from `from` cards on: a hit for every card drawn, then a stand unless it
+ * busted or reached six cards. Doubling is assumed affordable, as the balance is not logged. */
+static void hist_play_hand(HistStats* st, const uint8_t* cards, uint8_t count, uint8_t from, bool doubled, uint8_t up, bool h17) {
+    HandTotals t;
+    hand_totals_reset(&t);
+    for(uint8_t i = 0; i < from; i++) hand_totals_add(&t, cards[i]);
+    for(uint8_t k = from; hand_totals_value(&t) <= 21 && k < MAX_HAND; k++) {
+        StrategyAction played = (k == 2 && doubled) ? StrategyDouble : (k < count) ? StrategyHit : StrategyStand;
+        bool is_pair = (k == 2 && CARD_RANK(cards[0]) == CARD_RANK(cards[1]));
+        st->decisions[strategy_lookup(&t, k, up, is_pair, k == 2, false, h17)][played]++;
+        if(played != StrategyHit) break;
+        hand_totals_add(&t, cards[k]);
+    }
+}
+
+static void hist_decisions(HistStats* st, const HistoryHand* h) {
+    uint8_t player[MAX_SPLIT_HANDS][MAX_HAND], dealer[MAX_HAND];
+    history_hand_cards(h, player, dealer);
+    HandTotals t;
+    hand_totals_reset(&t);
+    hand_totals_add(&t, dealer[0]);
+    hand_totals_add(&t, dealer[1]);
+    /* A blackjack on either side ended the round before the player acted */
+    if(h->dealer_count == 2 && hand_totals_value(&t) == 21) return;
+    if(hist_row(h->cards[0], h->cards[2]) == HIST_ROW_BLACKJACK) return;
+
+    uint8_t up = dealer[1];
+    bool split = h->flags & HistoryFlagSplit;
+    bool is_pair = CARD_RANK(h->cards[0]) == CARD_RANK(h->cards[2]);
+    hand_totals_reset(&t);
+    hand_totals_add(&t, h->cards[0]);
+    hand_totals_add(&t, h->cards[2]);
+    StrategyAction played = split                             ? StrategySplit :
+                            (h->flags & HistoryFlagDouble1)   ? StrategyDouble :
+                            (h->player_count[0] > 2)          ? StrategyHit :
+                                                                StrategyStand;
+    st->decisions[strategy_lookup(&t, 2, up, is_pair, true, is_pair, h->hits_soft17)][played]++;
+    if(split) {
+        hist_play_hand(st, player[0], h->player_count[0], 2, h->flags & HistoryFlagDouble1, up, h->hits_soft17);
+        hist_play_hand(st, player[1], h->player_count[1], 2, h->flags & HistoryFlagDouble2, up, h->hits_soft17);
+    } else if(played == StrategyHit) {
+        hist_play_hand(st, player[0], h->player_count[0], 3, false, up, h->hits_soft17);
+    }
+}
+
+static void hist_add(HistStats* st, const HistoryRecord* r) {
+    if(r->kind == HistoryKindSession) {
+        st->sessions++;
+        return;
+    }
+    if(r->kind != HistoryKindHand) return;
+    const HistoryHand* h = &r->hand;
+    st->hands++;
+    st->net += h->net;
+    st->net_sq += (uint64_t)((int64_t)h->net * h->net);
+    st->wagered += h->bet;
+    if(h->net > 0) st->wins++;
+    else if(h->net < 0) st->losses++;
+    else st->pushes++;
+
+    HistCell* cell = &st->cells[hist_row(h->cards[0], h->cards[2])][strategy_column(h->cards[3])];
+    cell->hands++;
+    cell->wins += (h->net > 0);
+    cell->net += h->net;
+    cell->wagered += h->bet;
+
+    if(h->outcome[0] == HandBlackjack) st->blackjacks++;
+    unsigned hands = (h->flags & HistoryFlagSplit) ? 2 : 1;
+    for(unsigned k = 0; k < hands; k++) {
+        if(!(h->flags & (k ? HistoryFlagDouble2 : HistoryFlagDouble1))) continue;
+        st->doubles++;
+        st->double_results[h->outcome[k]]++;
+        st->double_net += hist_hand_net(h->outcome[k], 2 * h->bet);
+    }
+    if(hands == 2) {
+        st->splits++;
+        st->split_results[h->outcome[0]]++;
+        st->split_results[h->outcome[1]]++;
+        st->split_net += h->net;
+    }
+    if(h->insurance != HistoryInsuranceNone) st->insurance_offered++;
+    if(h->insurance >= HistoryInsuranceLost) {
+        int64_t side = h->bet / 2;
+        st->insurance_taken++;
+        if(h->insurance == HistoryInsuranceWon) {
+            st->insurance_won++;
+            st->insurance_net += side;
+        } else {
+            st->insurance_net -= side;
+        }
+    }
+    hist_decisions(st, h);
+}
+
+/* Decode the records that begin in [from, end); skips past anything that does not decode */
+static void hist_decode_range(HistTask* t, size_t from) {
+    const uint8_t* data = t->file->data;
+    size_t size = t->file->size;
+    memset(&t->stats, 0, sizeof(t->stats));
+    t->sync = from;
+    size_t pos = from;
+    while(pos < t->end) {
+        HistoryRecord r;
+        size_t n = history_decode(data + pos, size - pos, &r);
+        if(!n) {
+            size_t next = hist_sync(data, size, pos + 1);
+            t->stats.bad_records++;
+            t->stats.skipped_bytes += next - pos;
+            pos = next;
+            continue;
+        }
+        hist_add(&t->stats, &r);
+        pos += n;
+    }
+    t->stop = pos;
+}
+
+static void hist_run_task(void* ctx, uint64_t task) {
+    HistTask* t = &((HistTask*)ctx)[task];
+    size_t from = t->start ? hist_sync(t->file->data, t->file->size, t->start) : 0;
+    hist_decode_range(t, from);
+}
+
+static void hist_merge(HistStats* into, const HistStats* from) {
+    /* Every field is a 64-bit sum */
+    uint64_t* a = (uint64_t*)into;
+    const uint64_t* b = (const uint64_t*)from;
+    for(size_t i = 0; i < sizeof(HistStats) / sizeof(uint64_t); i++) a[i] += b[i];
+}
+
+static void print_table(const HistStats* st, bool ev) {
+    static const char* const soft[8] = {"A,2", "A,3", "A,4", "A,5", "A,6", "A,7", "A,8", "A,9"};
+    static const char* const pairs[10] = {"2,2", "3,3", "4,4", "5,5", "6,6", "7,7", "8,8", "9,9", "10,10", "A,A"};
+    printf("\n%s by starting hand (rows) and dealer upcard (columns)\n", ev ? "EV per $ bet, %" : "win rate, %");
+    printf("%-6s", "");
+    for(int c = 0; c < HIST_COLS; c++) printf("%6s", c == 9 ? "A" : c == 8 ? "10" : (char[]){(char)('2' + c), 0});
+    printf("%10s\n", "hands");
+    for(int r = 0; r < HIST_ROWS; r++) {
+        char label[12]; /* Room for any int, so GCC sees the row number cannot truncate */
+        if(r < HIST_ROW_SOFT) snprintf(label, sizeof(label), "%d", r - HIST_ROW_HARD + 5);
+        else if(r < HIST_ROW_BLACKJACK) snprintf(label, sizeof(label), "%s", soft[r - HIST_ROW_SOFT]);
+        else if(r == HIST_ROW_BLACKJACK) snprintf(label, sizeof(label), "BJ");
+        else snprintf(label, sizeof(label), "%s", pairs[r - HIST_ROW_PAIR]);
+        printf("%-6s", label);
+        uint64_t hands = 0;
+        for(int c = 0; c < HIST_COLS; c++) {
+            const HistCell* cell = &st->cells[r][c];
+            hands += cell->hands;
+            if(!cell->hands) printf("%6s", ".");
+            else if(ev) printf("%+6.0f", 100.0 * (double)cell->net / (double)cell->wagered);
+            else printf("%6.0f", 100.0 * (double)cell->wins / (double)cell->hands);
+        }
+        printf("%10llu\n", (unsigned long long)hands);
+    }
+}
+
+static void print_results(const uint64_t results[4], uint64_t n) {
+    printf(
+        "won %.1f%%, pushed %.1f%%, lost %.1f%%",
+        n ? 100.0 * (double)(results[HandWon] + results[HandBlackjack]) / (double)n : 0.0,
+        n ? 100.0 * (double)results[HandPushed] / (double)n : 0.0,
+        n ? 100.0 * (double)results[HandLost] / (double)n : 0.0);
+}
+
+static void print_stats(const HistStats* st) {
+    double n = (double)st->hands;
+    double mean = (double)st->net / n;
+    double var = (double)st->net_sq / n - mean * mean;
+    double sd = sqrt(var > 0 ? var : 0);
+    double mean_bet = (double)st->wagered / n;
+    double ev = (double)st->net / (double)st->wagered;
+    double ci = 1.96 * sd / mean_bet / sqrt(n);
+    printf("sessions      %llu\n", (unsigned long long)st->sessions);
+    printf("hands         %llu (mean bet $%.2f)\n", (unsigned long long)st->hands, mean_bet);
+    printf("EV            %+.3f%% of the bet (+/- %.3f%%, 95%% CI), %+.4f $/hand\n", ev * 100.0, ci * 100.0, mean);
+    printf("std dev       %.3f $/hand (%.4f bets), variance %.2f\n", sd, sd / mean_bet, var);
+    printf("net           %+lld $\n", (long long)st->net);
+    printf("wins          %llu (%.2f%%)\n", (unsigned long long)st->wins, 100.0 * (double)st->wins / n);
+    printf("losses        %llu (%.2f%%)\n", (unsigned long long)st->losses, 100.0 * (double)st->losses / n);
+    printf("pushes        %llu (%.2f%%)\n", (unsigned long long)st->pushes, 100.0 * (double)st->pushes / n);
+    printf("blackjacks    %llu (%.2f%%)\n", (unsigned long long)st->blackjacks, 100.0 * (double)st->blackjacks / n);
+    printf("doubles       %llu hands (", (unsigned long long)st->doubles);
+    print_results(st->double_results, st->doubles);
+    printf("), net %+lld $\n", (long long)st->double_net);
+    printf("splits        %llu rounds, net %+lld $; hands ", (unsigned long long)st->splits, (long long)st->split_net);
+    print_results(st->split_results, st->splits * 2);
+    printf("\n");
+    printf(
+        "insurance     offered %llu, taken %llu (%.1f%%), won %llu, net %+lld $\n",
+        (unsigned long long)st->insurance_offered,
+        (unsigned long long)st->insurance_taken,
+        st->insurance_offered ? 100.0 * (double)st->insurance_taken / (double)st->insurance_offered : 0.0,
+        (unsigned long long)st->insurance_won,
+        (long long)st->insurance_net);
+
+    uint64_t decisions = 0, deviations = 0;
+    for(int b = 0; b < 4; b++) {
+        for(int p = 0; p < 4; p++) {
+            decisions += st->decisions[b][p];
+            if(b != p) deviations += st->decisions[b][p];
+        }
+    }
+    printf(
+        "strategy      %llu of %llu decisions departed from basic strategy (%.2f%%)\n",
+        (unsigned long long)deviations,
+        (unsigned long long)decisions,
+        decisions ? 100.0 * (double)deviations / (double)decisions : 0.0);
+    printf("  basic \\ played");
+    for(int p = 0; p < 4; p++) printf("%12s", action_names[p]);
+    printf("\n");
+    for(int b = 0; b < 4; b++) {
+        printf("  %-14s", action_names[b]);
+        for(int p = 0; p < 4; p++) printf("%12llu", (unsigned long long)st->decisions[b][p]);
+        printf("\n");
+    }
+    if(st->bad_records) {
+        printf(
+            "skipped       %llu bytes in %llu bad or cut-off records\n",
+            (unsigned long long)st->skipped_bytes,
+            (unsigned long long)st->bad_records);
+    }
+}
+
+static void usage(const char* argv0) {
+    fprintf(
+        stderr,
+        "usage: %s [-j threads] [-e] [-q] history.bjh...\n"
+        "  -j  worker threads, 0 = one per core (default 0)\n"
+        "  -e  show EV per $ bet in the starting hand table instead of the win rate\n"
+        "  -q  leave out the starting hand table\n",
+        argv0);
+}
+
+int main(int argc, char** argv) {
+    long threads = 0;
+    bool ev_table = false;
+    bool table = true;
+    int opt;
+    while((opt = getopt(argc, argv, "j:eqh")) != -1) {
+        switch(opt) {
+        case 'j':
+            threads = strtol(optarg, NULL, 10);
+            break;
+        case 'e':
+            ev_table = true;
+            break;
+        case 'q':
+            table = false;
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    int file_count = argc - optind;
+    if(file_count < 1 || threads < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if(threads == 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads < 1) threads = 1;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    HistFile* files = calloc((size_t)file_count, sizeof(HistFile));
+    uint64_t bytes = 0;
+    size_t task_count = 0;
+    for(int i = 0; i < file_count; i++) {
+        const char* path = argv[optind + i];
+        int fd = open(path, O_RDONLY);
+        struct stat st;
+        if(fd < 0 || fstat(fd, &st) != 0) {
+            perror(path);
+            return 1;
+        }
+        files[i].size = (size_t)st.st_size;
+        if(files[i].size) {
+            void* map = mmap(NULL, files[i].size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(map == MAP_FAILED) {
+                perror(path);
+                return 1;
+            }
+            madvise(map, files[i].size, MADV_SEQUENTIAL);
+            madvise(map, files[i].size, MADV_WILLNEED);
+            files[i].data = map;
+        }
+        close(fd);
+        bytes += files[i].size;
+        task_count += (files[i].size + HIST_CHUNK - 1) / HIST_CHUNK;
+    }
+
+    HistTask* tasks = calloc(task_count ? task_count : 1, sizeof(HistTask));
+    size_t t = 0;
+    for(int i = 0; i < file_count; i++) {
+        for(size_t start = 0; start < files[i].size; start += HIST_CHUNK, t++) {
+            tasks[t].file = &files[i];
+            tasks[t].start = start;
+            tasks[t].end = start + HIST_CHUNK < files[i].size ? start + HIST_CHUNK : files[i].size;
+        }
+    }
+    void** contexts = calloc((size_t)threads, sizeof(void*));
+    for(long i = 0; i < threads; i++) contexts[i] = tasks;
+    pool_run(task_count, (unsigned)threads, hist_run_task, contexts);
+
+    /* A chunk that synced somewhere other than where the previous one stopped is decoded again */
+    size_t redone = 0;
+    HistStats* total = calloc(1, sizeof(HistStats));
+    for(t = 0; t < task_count; t++) {
+        size_t expected = tasks[t].start ? tasks[t - 1].stop : 0;
+        if(tasks[t].sync != expected) {
+            hist_decode_range(&tasks[t], expected);
+            redone++;
+        }
+        hist_merge(total, &tasks[t].stats);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    printf("files         %d, %.1f MB in %zu chunks (%zu decoded again)\n", file_count, (double)bytes / 1e6, task_count, redone);
+    printf("threads       %ld\n", threads);
+    printf(
+        "throughput    %.0f MB/s, %.0f hands/s (%.3f s)\n",
+        secs > 0 ? (double)bytes / 1e6 / secs : 0.0,
+        secs > 0 ? (double)total->hands / secs : 0.0,
+        secs);
+    if(total->hands) {
+        print_stats(total);
+        if(table) print_table(total, ev_table);
+    } else {
+        printf("no hands\n");
+    }
+
+    for(int i = 0; i < file_count; i++) {
+        if(files[i].size) munmap((void*)files[i].data, files[i].size);
+    }
+    free(total);
+    free(contexts);
+    free(tasks);
+    free(files);
+    return 0;
+}
@@ -0,0 +1,687 @@
+/**
+ * Hand history index.
+ * Keeps a roaring bitmap (roaring.h) of hand ids for every value of a few columns of the
+ * history.bjh records, so boolean queries over millions of hands take milliseconds:
+ *
+ *   bj_index -i hands.bji history.bjh...        index the files, or just what was appended
+ *   bj_index -i hands.bji -u                    catch up every file already in the index
+ *   bj_index -i hands.bji -q 'pair=8 & up=10 & !split' [-l 20]
+ *   bj_index -i hands.bji                       what the index holds
+ *
+ * Hands are numbered in the order they were indexed. Each file remembers how many of its
+ * bytes are indexed, so an update decodes only the records appended since (files are assumed
+ * to only grow), and the new ids are appended to the bitmaps. A locator entry every
+ * INDEX_LOCATE_EVERY hands leads -l back to the records themselves.
+ *
+ * Query syntax: a | b, a & b, !a, (a), and column[=value]:
+ *   total=4..21  soft  pair[=2..10,J,Q,K,A]  up=2..10,A  hit  double  split
+ *   insurance[=declined,won,lost]  outcome=win,loss,push,blackjack  profile=1..4
+ *   guest  practice  h17
+ * A bare pair or insurance matches any pair or insurance taken.
+ */
+#include "blackjack_history.h"
+#include "blackjack_strategy.h"
+#include "roaring.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define INDEX_MAGIC "BJX"
+#define INDEX_VERSION 1
+#define INDEX_LOCATE_EVERY 1024
+
+typedef struct {
+    const char* name;
+    bool bare; /* The name alone is a bitmap of its own, ahead of the values */
+    const char* const* values;
+    uint8_t value_count;
+    uint16_t first; /* Set by index_columns_init */
+} IndexColumn;
+
+static const char* const total_values[] = {"4", "5", "6", "7", "8", "9", "10", "11", "12",
+                                           "13", "14", "15", "16", "17", "18", "19", "20", "21"};
+static const char* const rank_values[] = {"2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K", "A"};
+static const char* const up_values[] = {"2", "3", "4", "5", "6", "7", "8", "9", "10", "A"};
+static const char* const insurance_values[] = {"declined", "won", "lost"};
+static const char* const outcome_values[] = {"win", "loss", "push", "blackjack"};
+static const char* const profile_values[] = {"1", "2", "3", "4"};
+
+typedef enum {
+    ColTotal,
+    ColSoft,
+    ColPair,
+    ColUp,
+    ColHit,
+    ColDouble,
+    ColSplit,
+    ColInsurance,
+    ColOutcome,
+    ColProfile,
+    ColGuest,
+    ColPractice,
+    ColH17,
+    ColCount,
+} IndexColumnId;
+
+#define COLUMN_VALUES(v) v, sizeof(v) / sizeof(v[0])
+static IndexColumn columns[ColCount] = {
+    [ColTotal] = {"total", false, COLUMN_VALUES(total_values), 0},
+    [ColSoft] = {"soft", true, NULL, 0, 0},
+    [ColPair] = {"pair", true, COLUMN_VALUES(rank_values), 0},
+    [ColUp] = {"up", false, COLUMN_VALUES(up_values), 0},
+    [ColHit] = {"hit", true, NULL, 0, 0},
+    [ColDouble] = {"double", true, NULL, 0, 0},
+    [ColSplit] = {"split", true, NULL, 0, 0},
+    [ColInsurance] = {"insurance", true, COLUMN_VALUES(insurance_values), 0},
+    [ColOutcome] = {"outcome", false, COLUMN_VALUES(outcome_values), 0},
+    [ColProfile] = {"profile", false, COLUMN_VALUES(profile_values), 0},
+    [ColGuest] = {"guest", true, NULL, 0, 0},
+    [ColPractice] = {"practice", true, NULL, 0, 0},
+    [ColH17] = {"h17", true, NULL, 0, 0},
+};
+static uint16_t bitmap_count;
+
+typedef struct {
+    char* path;
+    uint64_t indexed; /* Bytes decoded so far */
+    uint64_t hands;
+    uint64_t bad_records;
+} IndexFile;
+
+typedef struct {
+    uint32_t id; /* First hand at or after offset */
+    uint32_t file;
+    uint64_t offset;
+} IndexLocator;
+
+typedef struct {
+    uint32_t hands;
+    IndexFile* files;
+    uint32_t file_count;
+    IndexLocator* locators; /* By increasing id */
+    uint32_t locator_count;
+    uint32_t locator_capacity;
+    Roaring* bitmaps; /* bitmap_count of them */
+} Index;
+
+static void index_columns_init(void) {
+    uint16_t next = 0;
+    for(int i = 0; i < ColCount; i++) {
+        columns[i].first = next;
+        next += columns[i].bare + columns[i].value_count;
+    }
+    bitmap_count = next;
+}
+
+/* Bitmap of a column's value, or of the bare column with value < 0 */
+static uint16_t column_bitmap(IndexColumnId col, int value) {
+    return columns[col].first + columns[col].bare + value;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* ---- Index file ---- */
+
+static void index_init(Index* index) {
+    memset(index, 0, sizeof(*index));
+    index->bitmaps = calloc(bitmap_count, sizeof(Roaring));
+}
+
+static void index_free(Index* index) {
+    for(uint32_t i = 0; i < index->file_count; i++) free(index->files[i].path);
+    for(uint16_t i = 0; i < bitmap_count; i++) roaring_free(&index->bitmaps[i]);
+    free(index->files);
+    free(index->locators);
+    free(index->bitmaps);
+}
+
+static bool read_u32(FILE* f, uint32_t* v) {
+    return fread(v, sizeof(*v), 1, f) == 1;
+}
+
+static bool read_u64(FILE* f, uint64_t* v) {
+    return fread(v, sizeof(*v), 1, f) == 1;
+}
+
+static bool index_read_body(Index* index, FILE* f) {
+    char magic[4];
+    if(fread(magic, 1, 4, f) != 4 || memcmp(magic, INDEX_MAGIC, 3) != 0 || magic[3] != INDEX_VERSION) return false;
+    uint32_t count;
+    if(!read_u32(f, &index->hands) || !read_u32(f, &count)) return false;
+    index->files = calloc(count ? count : 1, sizeof(IndexFile));
+    while(index->file_count < count) {
+        IndexFile* file = &index->files[index->file_count++];
+        uint32_t len;
+        if(!read_u32(f, &len) || len > PATH_MAX) return false;
+        file->path = calloc(len + 1, 1);
+        if(fread(file->path, 1, len, f) != len) return false;
+        if(!read_u64(f, &file->indexed) || !read_u64(f, &file->hands) || !read_u64(f, &file->bad_records)) return false;
+    }
+    if(!read_u32(f, &count)) return false;
+    index->locators = calloc(count ? count : 1, sizeof(IndexLocator));
+    index->locator_capacity = count ? count : 1;
+    if(fread(index->locators, sizeof(IndexLocator), count, f) != count) return false;
+    index->locator_count = count;
+    if(!read_u32(f, &count) || count != bitmap_count) return false;
+    for(uint16_t i = 0; i < bitmap_count; i++) {
+        if(!roaring_read(&index->bitmaps[i], f)) return false;
+    }
+    return true;
+}
+
+/* A missing index is an empty one; false if it exists but does not read back */
+static bool index_load(Index* index, const char* path) {
+    index_init(index);
+    FILE* f = fopen(path, "rb");
+    if(!f) return true;
+    bool ok = index_read_body(index, f);
+    fclose(f);
+    return ok;
+}
+
+static bool index_write_body(const Index* index, FILE* f) {
+    const char magic[4] = {'B', 'J', 'X', INDEX_VERSION};
+    uint32_t bitmaps = bitmap_count;
+    if(fwrite(magic, 1, 4, f) != 4 || fwrite(&index->hands, 4, 1, f) != 1) return false;
+    if(fwrite(&index->file_count, 4, 1, f) != 1) return false;
+    for(uint32_t i = 0; i < index->file_count; i++) {
+        const IndexFile* file = &index->files[i];
+        uint32_t len = (uint32_t)strlen(file->path);
+        if(fwrite(&len, 4, 1, f) != 1 || fwrite(file->path, 1, len, f) != len) return false;
+        if(fwrite(&file->indexed, 8, 1, f) != 1 || fwrite(&file->hands, 8, 1, f) != 1) return false;
+        if(fwrite(&file->bad_records, 8, 1, f) != 1) return false;
+    }
+    if(fwrite(&index->locator_count, 4, 1, f) != 1) return false;
+    if(fwrite(index->locators, sizeof(IndexLocator), index->locator_count, f) != index->locator_count) return false;
+    if(fwrite(&bitmaps, 4, 1, f) != 1) return false;
+    for(uint16_t i = 0; i < bitmap_count; i++) {
+        if(!roaring_write(&index->bitmaps[i], f)) return false;
+    }
+    return true;
+}
+
+/* Written aside and renamed over the old index, so an interrupted update loses nothing */
+static bool index_save(const Index* index, const char* path) {
+    size_t len = strlen(path);
+    char* tmp = malloc(len + 5);
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".tmp", 5);
+    FILE* f = fopen(tmp, "wb");
+    bool ok = f && index_write_body(index, f);
+    if(f && fclose(f) != 0) ok = false;
+    if(ok && rename(tmp, path) != 0) ok = false;
+    if(!ok) {
+        perror(tmp);
+        unlink(tmp);
+    }
+    free(tmp);
+    return ok;
+}
+
+/* ---- Updating ---- */
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+} IndexMap;
+
+static bool index_map(const char* path, IndexMap* map) {
+    map->data = NULL;
+    map->size = 0;
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        if(fd >= 0) close(fd);
+        return false;
+    }
+    map->size = (size_t)st.st_size;
+    if(map->size) {
+        void* data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data == MAP_FAILED) {
+            perror(path);
+            close(fd);
+            return false;
+        }
+        map->data = data;
+    }
+    close(fd);
+    return true;
+}
+
+static void index_unmap(IndexMap* map) {
+    if(map->size) munmap((void*)map->data, map->size);
+}
+
+static void index_locate_here(Index* index, uint32_t file, uint64_t offset) {
+    if(index->locator_count == index->locator_capacity) {
+        index->locator_capacity = index->locator_capacity ? index->locator_capacity * 2 : 64;
+        index->locators = realloc(index->locators, index->locator_capacity * sizeof(IndexLocator));
+    }
+    index->locators[index->locator_count++] = (IndexLocator){index->hands, file, offset};
+}
+
+static void index_add_hand(Index* index, const HistoryHand* h) {
+    uint32_t id = index->hands++;
+    Roaring* b = index->bitmaps;
+
+    HandTotals t;
+    hand_totals_reset(&t);
+    hand_totals_add(&t, h->cards[0]);
+    hand_totals_add(&t, h->cards[2]);
+    roaring_append(&b[column_bitmap(ColTotal, hand_totals_value(&t) - 4)], id);
+    if(t.soft) roaring_append(&b[column_bitmap(ColSoft, -1)], id);
+    if(CARD_RANK(h->cards[0]) == CARD_RANK(h->cards[2])) {
+        roaring_append(&b[column_bitmap(ColPair, -1)], id);
+        roaring_append(&b[column_bitmap(ColPair, CARD_RANK(h->cards[0]))], id);
+    }
+    roaring_append(&b[column_bitmap(ColUp, strategy_column(h->cards[3]))], id);
+
+    bool split = h->flags & HistoryFlagSplit;
+    bool hit = h->player_count[0] > 2 && !(h->flags & HistoryFlagDouble1);
+    if(split) hit = hit || (h->player_count[1] > 2 && !(h->flags & HistoryFlagDouble2));
+    if(hit) roaring_append(&b[column_bitmap(ColHit, -1)], id);
+    if(h->flags & (HistoryFlagDouble1 | HistoryFlagDouble2)) roaring_append(&b[column_bitmap(ColDouble, -1)], id);
+    if(split) roaring_append(&b[column_bitmap(ColSplit, -1)], id);
+
+    switch(h->insurance) {
+    case HistoryInsuranceDeclined:
+        roaring_append(&b[column_bitmap(ColInsurance, 0)], id);
+        break;
+    case HistoryInsuranceWon:
+    case HistoryInsuranceLost:
+        roaring_append(&b[column_bitmap(ColInsurance, -1)], id);
+        roaring_append(&b[column_bitmap(ColInsurance, h->insurance == HistoryInsuranceWon ? 1 : 2)], id);
+        break;
+    default:
+        break;
+    }
+
+    roaring_append(&b[column_bitmap(ColOutcome, h->net > 0 ? 0 : h->net < 0 ? 1 : 2)], id);
+    if(h->outcome[0] == HandBlackjack) roaring_append(&b[column_bitmap(ColOutcome, 3)], id);
+    if(h->flags & HistoryFlagGuest) roaring_append(&b[column_bitmap(ColGuest, -1)], id);
+    else roaring_append(&b[column_bitmap(ColProfile, h->flags & HISTORY_PROFILE_MASK)], id);
+    if(h->flags & HistoryFlagPractice) roaring_append(&b[column_bitmap(ColPractice, -1)], id);
+    if(h->hits_soft17) roaring_append(&b[column_bitmap(ColH17, -1)], id);
+}
+
+/* Index the bytes of file appended since the last update; false if it cannot be read */
+static bool index_update_file(Index* index, uint32_t file_id) {
+    IndexFile* file = &index->files[file_id];
+    IndexMap map;
+    if(!index_map(file->path, &map)) return false;
+    if(map.size < file->indexed) {
+        fprintf(stderr, "%s: shorter than when it was indexed; rebuild the index\n", file->path);
+        index_unmap(&map);
+        return false;
+    }
+    double t0 = now_seconds();
+    uint32_t first = index->hands;
+    uint64_t bad = file->bad_records;
+    size_t pos = (size_t)file->indexed;
+    while(pos < map.size) {
+        HistoryRecord r;
+        size_t n = history_decode(map.data + pos, map.size - pos, &r);
+        if(!n) {
+            size_t len = 1 + (map.data[pos] & HISTORY_BODY_MAX);
+            if(len > map.size - pos) break; /* Cut off: the rest may still be on its way */
+            file->bad_records++;
+            pos += len;
+            continue;
+        }
+        if(r.kind == HistoryKindHand) {
+            if(index->hands == UINT32_MAX) {
+                fprintf(stderr, "%s: index full\n", file->path);
+                break;
+            }
+            if(index->hands == first || index->hands % INDEX_LOCATE_EVERY == 0) index_locate_here(index, file_id, pos);
+            index_add_hand(index, &r.hand);
+        }
+        pos += n;
+    }
+    uint64_t added = index->hands - first;
+    printf(
+        "%s: %llu new hands from %.1f MB in %.3f s",
+        file->path,
+        (unsigned long long)added,
+        (double)(pos - file->indexed) / 1e6,
+        now_seconds() - t0);
+    if(file->bad_records > bad) printf(", %llu bad records skipped", (unsigned long long)(file->bad_records - bad));
+    printf("\n");
+    file->hands += added;
+    file->indexed = pos;
+    index_unmap(&map);
+    return true;
+}
+
+static uint32_t index_file_id(Index* index, const char* path) {
+    char* full = realpath(path, NULL);
+    if(!full) full = strdup(path);
+    for(uint32_t i = 0; i < index->file_count; i++) {
+        if(strcmp(index->files[i].path, full) == 0) {
+            free(full);
+            return i;
+        }
+    }
+    index->files = realloc(index->files, (index->file_count + 1) * sizeof(IndexFile));
+    index->files[index->file_count] = (IndexFile){.path = full};
+    return index->file_count++;
+}
+
+/* ---- Queries ---- */
+
+typedef struct {
+    const char* text;
+    const char* p;
+    const Index* index;
+    Roaring all;
+} Query;
+
+static void query_fail(const Query* q, const char* what) {
+    fprintf(stderr, "query: %s at column %d\n  %s\n  %*s^\n", what, (int)(q->p - q->text) + 1, q->text, (int)(q->p - q->text), "");
+    exit(2);
+}
+
+static char query_peek(Query* q) {
+    while(isspace((unsigned char)*q->p)) q->p++;
+    return *q->p;
+}
+
+static size_t query_word(Query* q, const char** word) {
+    query_peek(q);
+    *word = q->p;
+    while(isalnum((unsigned char)*q->p)) q->p++;
+    return (size_t)(q->p - *word);
+}
+
+static bool word_is(const char* word, size_t len, const char* name) {
+    return strlen(name) == len && strncasecmp(word, name, len) == 0;
+}
+
+static Roaring query_expr(Query* q);
+
+static Roaring query_leaf(Query* q) {
+    const char* name;
+    size_t len = query_word(q, &name);
+    if(!len) query_fail(q, "expected a column");
+    const IndexColumn* col = NULL;
+    for(int i = 0; i < ColCount && !col; i++) {
+        if(word_is(name, len, columns[i].name)) col = &columns[i];
+    }
+    if(!col) {
+        q->p = name;
+        query_fail(q, "unknown column");
+    }
+    uint16_t bitmap = col->first;
+    if(query_peek(q) == '=') {
+        q->p++;
+        const char* value;
+        size_t value_len = query_word(q, &value);
+        int found = -1;
+        for(int i = 0; i < col->value_count && found < 0; i++) {
+            if(word_is(value, value_len, col->values[i])) found = i;
+        }
+        if(found < 0) {
+            q->p = value;
+            query_fail(q, col->value_count ? "no such value" : "this column takes no value");
+        }
+        bitmap += col->bare + found;
+    } else if(!col->bare) {
+        query_fail(q, "this column needs =value");
+    }
+    Roaring r;
+    roaring_copy(&q->index->bitmaps[bitmap], &r);
+    return r;
+}
+
+static Roaring query_factor(Query* q) {
+    char c = query_peek(q);
+    if(c == '!') {
+        q->p++;
+        Roaring a = query_factor(q), r;
+        roaring_andnot(&q->all, &a, &r);
+        roaring_free(&a);
+        return r;
+    }
+    if(c == '(') {
+        q->p++;
+        Roaring r = query_expr(q);
+        if(query_peek(q) != ')') query_fail(q, "expected )");
+        q->p++;
+        return r;
+    }
+    return query_leaf(q);
+}
+
+static Roaring query_term(Query* q) {
+    Roaring a = query_factor(q);
+    while(query_peek(q) == '&') {
+        q->p++;
+        Roaring b = query_factor(q), r;
+        roaring_and(&a, &b, &r);
+        roaring_free(&a);
+        roaring_free(&b);
+        a = r;
+    }
+    return a;
+}
+
+static Roaring query_expr(Query* q) {
+    Roaring a = query_term(q);
+    while(query_peek(q) == '|') {
+        q->p++;
+        Roaring b = query_term(q), r;
+        roaring_or(&a, &b, &r);
+        roaring_free(&a);
+        roaring_free(&b);
+        a = r;
+    }
+    return a;
+}
+
+static Roaring query_run(const Index* index, const char* text) {
+    Query q = {.text = text, .p = text, .index = index};
+    roaring_range(&q.all, index->hands);
+    Roaring r = query_expr(&q);
+    if(query_peek(&q)) query_fail(&q, "expected & or |");
+    roaring_free(&q.all);
+    return r;
+}
+
+/* ---- Listing ---- */
+
+static void print_cards(const uint8_t* cards, uint8_t count) {
+    static const char ranks[] = "23456789TJQKA";
+    static const char suits[] = "SHDC";
+    for(uint8_t i = 0; i < count; i++) printf("%s%c%c", i ? " " : "", ranks[CARD_RANK(cards[i])], suits[CARD_SUIT(cards[i])]);
+}
+
+static void print_hand(uint32_t id, const IndexFile* file, uint64_t offset, const HistoryHand* h) {
+    static const char* const outcomes[4] = {"lost", "pushed", "won", "blackjack"};
+    uint8_t player[MAX_SPLIT_HANDS][MAX_HAND], dealer[MAX_HAND];
+    history_hand_cards(h, player, dealer);
+    printf("%10u  shoe %u pos %-3u $%-4u ", id, h->shoe_number, h->shoe_pos, h->bet);
+    unsigned hands = (h->flags & HistoryFlagSplit) ? 2 : 1;
+    for(unsigned k = 0; k < hands; k++) {
+        if(k) printf(" | ");
+        print_cards(player[k], h->player_count[k]);
+        if(h->flags & (k ? HistoryFlagDouble2 : HistoryFlagDouble1)) printf(" (x2)");
+        printf(" %s", outcomes[h->outcome[k]]);
+    }
+    printf("  vs ");
+    print_cards(dealer, h->dealer_count);
+    if(h->insurance >= HistoryInsuranceLost) printf("  insured");
+    printf("  %+d $  %s@%llu\n", h->net, file->path, (unsigned long long)offset);
+}
+
+/* Print the hands with the first `max` ids in r */
+static void list_hands(const Index* index, const Roaring* r, size_t max) {
+    uint32_t* ids = malloc((max ? max : 1) * sizeof(uint32_t));
+    size_t n = roaring_to_array(r, ids, max);
+    IndexMap* maps = calloc(index->file_count ? index->file_count : 1, sizeof(IndexMap));
+    bool* mapped = calloc(index->file_count ? index->file_count : 1, sizeof(bool));
+    for(size_t i = 0; i < n; i++) {
+        /* Last locator at or before the hand, then decode forward to it */
+        uint32_t lo = 0, hi = index->locator_count;
+        while(hi - lo > 1) {
+            uint32_t mid = (lo + hi) / 2;
+            if(index->locators[mid].id <= ids[i]) lo = mid;
+            else hi = mid;
+        }
+        const IndexLocator* at = &index->locators[lo];
+        IndexMap* map = &maps[at->file];
+        if(!mapped[at->file]) {
+            mapped[at->file] = true;
+            index_map(index->files[at->file].path, map);
+        }
+        size_t pos = (size_t)at->offset;
+        uint32_t id = at->id;
+        const size_t end = map->size < index->files[at->file].indexed ? map->size : index->files[at->file].indexed;
+        bool found = false;
+        while(pos < end && !found) {
+            HistoryRecord rec;
+            size_t len = history_decode(map->data + pos, end - pos, &rec);
+            if(!len) {
+                pos += 1 + (map->data[pos] & HISTORY_BODY_MAX);
+                continue;
+            }
+            if(rec.kind == HistoryKindHand && id++ == ids[i]) {
+                print_hand(ids[i], &index->files[at->file], pos, &rec.hand);
+                found = true;
+            }
+            pos += len;
+        }
+        if(!found) printf("%10u  not found in %s\n", ids[i], index->files[at->file].path);
+    }
+    for(uint32_t f = 0; f < index->file_count; f++) {
+        if(mapped[f]) index_unmap(&maps[f]);
+    }
+    free(mapped);
+    free(maps);
+    free(ids);
+}
+
+/* ---- Summary ---- */
+
+static void print_info(const Index* index) {
+    size_t bytes = 0;
+    for(uint16_t i = 0; i < bitmap_count; i++) bytes += roaring_size(&index->bitmaps[i]);
+    printf("hands         %u\n", index->hands);
+    printf("bitmaps       %u, %.2f MB (%.2f bytes a hand)\n", bitmap_count, (double)bytes / 1e6, index->hands ? (double)bytes / index->hands : 0.0);
+    for(uint32_t i = 0; i < index->file_count; i++) {
+        const IndexFile* file = &index->files[i];
+        printf("file          %s: %llu hands, %.1f MB indexed", file->path, (unsigned long long)file->hands, (double)file->indexed / 1e6);
+        if(file->bad_records) printf(", %llu bad records", (unsigned long long)file->bad_records);
+        printf("\n");
+    }
+    for(int c = 0; c < ColCount && index->hands; c++) {
+        const IndexColumn* col = &columns[c];
+        printf("  %-10s", col->name);
+        if(col->bare) printf(" %.1f%%", 100.0 * (double)roaring_cardinality(&index->bitmaps[col->first]) / index->hands);
+        for(int v = 0; v < col->value_count; v++) {
+            uint64_t n = roaring_cardinality(&index->bitmaps[col->first + col->bare + v]);
+            printf(" %s:%.1f%%", col->values[v], 100.0 * (double)n / index->hands);
+        }
+        printf("\n");
+    }
+}
+
+static void usage(const char* argv0) {
+    fprintf(
+        stderr,
+        "usage: %s -i index.bji [-u] [-q query [-l n]] [history.bjh...]\n"
+        "  -i  index file, created if missing\n"
+        "  -u  index whatever was appended to every file already in the index\n"
+        "  -q  count the hands matching query, e.g. 'pair=8 & up=10 & !split'\n"
+        "  -l  also list the first n matching hands\n"
+        "files given are added to the index, or caught up if they are in it already\n",
+        argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* index_path = NULL;
+    const char* query = NULL;
+    bool update_all = false;
+    long list = 0;
+    int opt;
+    while((opt = getopt(argc, argv, "i:uq:l:h")) != -1) {
+        switch(opt) {
+        case 'i':
+            index_path = optarg;
+            break;
+        case 'u':
+            update_all = true;
+            break;
+        case 'q':
+            query = optarg;
+            break;
+        case 'l':
+            list = strtol(optarg, NULL, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if(!index_path || list < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    index_columns_init();
+
+    Index index;
+    double t0 = now_seconds();
+    if(!index_load(&index, index_path)) {
+        fprintf(stderr, "%s: not a readable index (version %d)\n", index_path, INDEX_VERSION);
+        index_free(&index);
+        return 1;
+    }
+    double load_secs = now_seconds() - t0;
+
+    int status = 0;
+    bool changed = false;
+    uint32_t known = index.file_count;
+    for(int i = optind; i < argc; i++) {
+        uint32_t id = index_file_id(&index, argv[i]);
+        if(id < known && update_all) continue; /* Caught up below */
+        if(!index_update_file(&index, id)) status = 1;
+        changed = true;
+    }
+    for(uint32_t i = 0; update_all && i < known; i++) {
+        if(!index_update_file(&index, i)) status = 1;
+        changed = true;
+    }
+    if(changed && !index_save(&index, index_path)) status = 1;
+
+    if(query) {
+        t0 = now_seconds();
+        Roaring r = query_run(&index, query);
+        double secs = now_seconds() - t0;
+        uint64_t n = roaring_cardinality(&r);
+        printf(
+            "%llu of %u hands (%.2f%%) in %.3f ms (index loaded in %.0f ms)\n",
+            (unsigned long long)n,
+            index.hands,
+            index.hands ? 100.0 * (double)n / index.hands : 0.0,
+            secs * 1e3,
+            load_secs * 1e3);
+        if(list) list_hands(&index, &r, (size_t)list);
+        roaring_free(&r);
+    } else if(!changed) {
+        print_info(&index);
+    }
+    index_free(&index);
+    return status;
+}
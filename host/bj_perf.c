@@ -0,0 +1,406 @@
+/**
+ * Microbenchmarks for the engine hot paths, with a saved-baseline comparison.
+ *
+ * Each benchmark is calibrated to take about -t ms per sample, warmed up, then sampled -r
+ * times; ns/op is reported as the median with the median absolute deviation (MAD), which a
+ * stray context switch cannot drag the way it drags a mean. Inputs come from fixed-seed pools
+ * cycled by index, so every run times the same work.
+ *
+ * The draw_* benchmarks time draw_callback on one screen each. The real app runs against the
+ * host Furi shim on an empty temporary SD card, is driven to the screen by a few key presses,
+ * and every frame is drawn with all the render cache invalidated, as after a key press that
+ * changed the whole screen.
+ *
+ * Results are written as tab-separated lines (name, median, MAD, samples, ops per sample) with
+ * -o. With -c, each benchmark is compared against a file written earlier: one whose median
+ * grew by more than -x percent and by more than 3 MADs of either run is flagged as a
+ * regression, and the exit status is 1.
+ *
+ *   bj_perf [-r samples] [-t ms] [-f filter] [-o out.tsv] [-c baseline.tsv] [-x pct] [-l]
+ *   make -C host perf [BASELINE=old.tsv]
+ */
+#include "blackjack_strategy.h"
+#include "furi_shim.h"
+#include "sim.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PERF_POOL 1024 /* Inputs per pool, a power of two */
+#define PERF_SAMPLES_MAX 101
+#define PERF_RESULTS_MAX 32
+#define PERF_SCREEN_SEED 2 /* Deals a plain player turn: no blackjack, pair or insurance */
+
+int32_t blackjack_app(void* p);
+
+static double now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec * 1e9 + (double)t.tv_nsec;
+}
+
+static volatile uint32_t sink;
+
+typedef struct {
+    uint8_t cards[MAX_HAND];
+    uint8_t count;
+    uint8_t dealer_card;
+    HandTotals totals;
+    bool is_pair;
+} PerfHand;
+
+typedef struct {
+    PerfHand hand[PERF_POOL];
+    BlackjackState table;
+    uint8_t deck[DECK_SIZE];
+    BlackjackRng rng;
+} PerfInputs;
+
+static PerfInputs inputs;
+
+/* Random 2-6 card hands from shuffled shoes, each with a dealer upcard */
+static void perf_inputs_init(PerfInputs* in) {
+    memset(in, 0, sizeof(*in));
+    in->rng.kind = BlackjackRngXoshiro128;
+    blackjack_rng_seed(&in->rng, 1, 0);
+    int top = DECK_SIZE;
+    for(int i = 0; i < PERF_POOL; i++) {
+        PerfHand* h = &in->hand[i];
+        if(top > DECK_SIZE - MAX_HAND - 1) {
+            shuffle_deck(in->deck, &in->rng);
+            top = 0;
+        }
+        h->count = (uint8_t)(2 + blackjack_rng_bounded(&in->rng, MAX_HAND - 1));
+        for(int k = 0; k < MAX_HAND; k++) h->cards[k] = in->deck[top++];
+        h->dealer_card = in->deck[top++];
+        hand_totals_reset(&h->totals);
+        for(int k = 0; k < h->count; k++) hand_totals_add(&h->totals, h->cards[k]);
+        h->is_pair = h->count == 2 && CARD_RANK(h->cards[0]) == CARD_RANK(h->cards[1]);
+    }
+    BlackjackState* s = &in->table;
+    s->rng.kind = BlackjackRngXoshiro128;
+    s->rng_seed = 1;
+    s->cut_card = CUT_CARD_DEFAULT;
+    s->balance = SIM_BANKROLL;
+    shoe_pack(s, in->deck);
+    s->deck_top = BURN_TOP;
+}
+
+/* Each benchmark runs n operations and returns something derived from every result */
+typedef uint32_t (*PerfFn)(uint64_t n);
+
+static uint32_t perf_hand_value(uint64_t n) {
+    uint32_t acc = 0;
+    for(uint64_t i = 0; i < n; i++) {
+        const PerfHand* h = &inputs.hand[i & (PERF_POOL - 1)];
+        acc += hand_value(h->cards, h->count);
+    }
+    return acc;
+}
+
+static uint32_t perf_hand_values_soft_hard(uint64_t n) {
+    uint32_t acc = 0;
+    for(uint64_t i = 0; i < n; i++) {
+        const PerfHand* h = &inputs.hand[i & (PERF_POOL - 1)];
+        uint8_t soft, hard;
+        hand_values_soft_hard(h->cards, h->count, &soft, &hard);
+        acc += soft ^ hard;
+    }
+    return acc;
+}
+
+static uint32_t perf_hand_is_soft_17(uint64_t n) {
+    uint32_t acc = 0;
+    for(uint64_t i = 0; i < n; i++) {
+        const PerfHand* h = &inputs.hand[i & (PERF_POOL - 1)];
+        acc += hand_is_soft_17(h->cards, h->count);
+    }
+    return acc;
+}
+
+static uint32_t perf_strategy_lookup(uint64_t n) {
+    uint32_t acc = 0;
+    for(uint64_t i = 0; i < n; i++) {
+        const PerfHand* h = &inputs.hand[i & (PERF_POOL - 1)];
+        acc += strategy_lookup(&h->totals, h->count, h->dealer_card, h->is_pair, h->count == 2, h->is_pair, i & 1);
+    }
+    return acc;
+}
+
+static uint32_t perf_shuffle_deck(uint64_t n) {
+    for(uint64_t i = 0; i < n; i++) shuffle_deck(inputs.deck, &inputs.rng);
+    return inputs.deck[0];
+}
+
+static uint32_t perf_draw_card(uint64_t n) {
+    BlackjackState* s = &inputs.table;
+    uint32_t acc = 0;
+    s->cut_card = CUT_CARD_MAX;
+    for(uint64_t i = 0; i < n; i++) {
+        /* Stay inside one shoe so the shuffle is timed on its own */
+        if(s->deck_top >= CUT_CARD_MAX) s->deck_top = BURN_TOP;
+        acc += draw_card(s);
+    }
+    return acc;
+}
+
+/* game_deal_cards through game_show_result, playing basic strategy as Practice mode hints */
+static uint32_t perf_round(uint64_t n) {
+    BlackjackState* s = &inputs.table;
+    int32_t acc = 0;
+    s->cut_card = CUT_CARD_DEFAULT;
+    for(uint64_t i = 0; i < n; i++) acc += sim_play_hand(s, SimStrategyBasic, 10);
+    return (uint32_t)acc;
+}
+
+/* draw_callback on the screen the app is showing; the model starts with the game */
+static uint32_t perf_draw(uint64_t n) {
+    BlackjackState* s = furi_shim_view_model();
+    for(uint64_t i = 0; i < n; i++) {
+        s->dirty = GameDirtyAll;
+        furi_shim_redraw();
+    }
+    return s->phase;
+}
+
+typedef struct {
+    const char* name;
+    PerfFn fn;
+    const char* keys; /* draw_*: presses from app start to the screen, udlrob */
+} PerfBench;
+
+static const PerfBench benches[] = {
+    {"hand_value", perf_hand_value, NULL},
+    {"hand_values_soft_hard", perf_hand_values_soft_hard, NULL},
+    {"hand_is_soft_17", perf_hand_is_soft_17, NULL},
+    {"strategy_lookup", perf_strategy_lookup, NULL},
+    {"shuffle_deck", perf_shuffle_deck, NULL},
+    {"draw_card", perf_draw_card, NULL},
+    {"round", perf_round, NULL},
+    {"draw_splash", perf_draw, ""},
+    {"draw_help", perf_draw, "ddddo"},
+    {"draw_settings", perf_draw, "dddddo"},
+    {"draw_betting", perf_draw, "ddo"},
+    {"draw_player_turn", perf_draw, "ddoo"},
+    {"draw_practice", perf_draw, "dddoo"},
+    {"draw_final_cards", perf_draw, "ddoob"},
+    {"draw_result", perf_draw, "ddoobo"},
+};
+#define PERF_BENCHES (sizeof(benches) / sizeof(benches[0]))
+
+typedef struct {
+    char name[32];
+    double median;
+    double mad;
+    int samples;
+    uint64_t ops;
+} PerfResult;
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double* v, int n) {
+    qsort(v, n, sizeof(double), cmp_double);
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+static double time_ops(PerfFn fn, uint64_t ops) {
+    double t0 = now_ns();
+    sink += fn(ops);
+    return now_ns() - t0;
+}
+
+static void run_bench(const PerfBench* b, int samples, double sample_ns, PerfResult* out) {
+    /* Calibrate: double the op count until one sample takes a tenth of the target */
+    uint64_t ops = 1;
+    double t;
+    while((t = time_ops(b->fn, ops)) < sample_ns / 10 && ops < (1ULL << 40)) ops *= 2;
+    ops = (uint64_t)((double)ops * sample_ns / (t + 1)) + 1;
+    /* Warm up for about two samples, then take the samples */
+    time_ops(b->fn, ops * 2);
+    double ns[PERF_SAMPLES_MAX], dev[PERF_SAMPLES_MAX];
+    for(int i = 0; i < samples; i++) ns[i] = time_ops(b->fn, ops) / (double)ops;
+    double m = median(ns, samples);
+    for(int i = 0; i < samples; i++) dev[i] = ns[i] > m ? ns[i] - m : m - ns[i];
+    snprintf(out->name, sizeof(out->name), "%s", b->name);
+    out->median = m;
+    out->mad = median(dev, samples);
+    out->samples = samples;
+    out->ops = ops;
+}
+
+typedef struct {
+    const PerfBench* bench;
+    const char* keys; /* Still to press */
+    int samples;
+    double sample_ns;
+    PerfResult* out;
+} PerfScreen;
+
+/* Press the next key, or once the app has settled on the screen, run the benchmark and quit */
+static bool perf_screen_idle(void* context) {
+    PerfScreen* p = context;
+    static const char keys[] = "udlrob";
+    static const InputKey key_of[] = {InputKeyUp, InputKeyDown, InputKeyLeft, InputKeyRight, InputKeyOk, InputKeyBack};
+    const char* k = *p->keys ? strchr(keys, *p->keys++) : NULL;
+    if(k) {
+        furi_shim_press(key_of[k - keys]);
+        return true;
+    }
+    run_bench(p->bench, p->samples, p->sample_ns, p->out);
+    return false;
+}
+
+static bool run_screen_bench(const PerfBench* b, int samples, double sample_ns, PerfResult* out) {
+    FuriShimConfig config = {.seed = PERF_SCREEN_SEED};
+    PerfScreen p = {.bench = b, .keys = b->keys, .samples = samples, .sample_ns = sample_ns, .out = out};
+    if(!furi_shim_init(&config)) return false;
+    furi_shim_set_idle_callback(perf_screen_idle, &p);
+    blackjack_app(NULL);
+    furi_shim_deinit();
+    return true;
+}
+
+static bool write_results(const char* path, const PerfResult* r, int n) {
+    FILE* f = fopen(path, "w");
+    if(!f) return false;
+    fprintf(f, "# bj_perf\tmedian_ns\tmad_ns\tsamples\tops\n");
+    for(int i = 0; i < n; i++) {
+        fprintf(f, "%s\t%.4f\t%.4f\t%d\t%llu\n", r[i].name, r[i].median, r[i].mad, r[i].samples, (unsigned long long)r[i].ops);
+    }
+    return fclose(f) == 0;
+}
+
+/* Lines that do not parse (comments, the header) are skipped; returns -1 if unreadable */
+static int read_results(const char* path, PerfResult* r, int max) {
+    FILE* f = fopen(path, "r");
+    if(!f) return -1;
+    char line[256];
+    int n = 0;
+    while(n < max && fgets(line, sizeof(line), f)) {
+        unsigned long long ops;
+        if(line[0] == '#') continue;
+        if(sscanf(line, "%31s %lf %lf %d %llu", r[n].name, &r[n].median, &r[n].mad, &r[n].samples, &ops) == 5) {
+            r[n].ops = ops;
+            n++;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+static const PerfResult* find_result(const PerfResult* r, int n, const char* name) {
+    for(int i = 0; i < n; i++) {
+        if(strcmp(r[i].name, name) == 0) return &r[i];
+    }
+    return NULL;
+}
+
+static void usage(const char* argv0) {
+    fprintf(
+        stderr,
+        "usage: %s [-r samples] [-t ms] [-f filter] [-o out.tsv] [-c baseline.tsv] [-x pct] [-l]\n"
+        "  -r  samples per benchmark, 3-%d (default 15)\n"
+        "  -t  target time per sample in ms (default 20)\n"
+        "  -f  run only benchmarks whose name contains filter\n"
+        "  -o  write results as tab-separated values\n"
+        "  -c  compare with a saved results file; exit 1 on a regression\n"
+        "  -x  regression threshold in percent (default 5)\n"
+        "  -l  list benchmarks\n",
+        argv0,
+        PERF_SAMPLES_MAX);
+}
+
+int main(int argc, char** argv) {
+    int samples = 15;
+    double sample_ms = 20;
+    double threshold = 5;
+    const char* filter = NULL;
+    const char* out_path = NULL;
+    const char* base_path = NULL;
+    int opt;
+    while((opt = getopt(argc, argv, "r:t:f:o:c:x:lh")) != -1) {
+        switch(opt) {
+        case 'r':
+            samples = atoi(optarg);
+            break;
+        case 't':
+            sample_ms = atof(optarg);
+            break;
+        case 'f':
+            filter = optarg;
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        case 'c':
+            base_path = optarg;
+            break;
+        case 'x':
+            threshold = atof(optarg);
+            break;
+        case 'l':
+            for(unsigned i = 0; i < PERF_BENCHES; i++) printf("%s\n", benches[i].name);
+            return 0;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if(samples < 3) samples = 3;
+    if(samples > PERF_SAMPLES_MAX) samples = PERF_SAMPLES_MAX;
+    if(sample_ms < 1) sample_ms = 1;
+
+    PerfResult base[PERF_RESULTS_MAX];
+    int base_count = 0;
+    if(base_path) {
+        base_count = read_results(base_path, base, PERF_RESULTS_MAX);
+        if(base_count < 0) {
+            fprintf(stderr, "bj_perf: cannot read %s\n", base_path);
+            return 2;
+        }
+    }
+
+    perf_inputs_init(&inputs);
+    PerfResult results[PERF_RESULTS_MAX];
+    int count = 0, regressions = 0;
+    printf("%-24s %10s %9s %7s", "benchmark", "ns/op", "MAD", "MAD%");
+    if(base_path) printf(" %10s %8s", "baseline", "change");
+    printf("\n");
+    for(unsigned i = 0; i < PERF_BENCHES; i++) {
+        if(filter && !strstr(benches[i].name, filter)) continue;
+        PerfResult* r = &results[count++];
+        if(!benches[i].keys) {
+            run_bench(&benches[i], samples, sample_ms * 1e6, r);
+        } else if(!run_screen_bench(&benches[i], samples, sample_ms * 1e6, r)) {
+            fprintf(stderr, "bj_perf: cannot start the app for %s\n", benches[i].name);
+            return 2;
+        }
+        printf("%-24s %10.2f %9.3f %6.1f%%", r->name, r->median, r->mad, 100 * r->mad / r->median);
+        const PerfResult* b = base_path ? find_result(base, base_count, r->name) : NULL;
+        if(b) {
+            double change = 100 * (r->median - b->median) / b->median;
+            double noise = 3 * (r->mad > b->mad ? r->mad : b->mad);
+            bool regressed = change > threshold && r->median - b->median > noise;
+            regressions += regressed;
+            printf(" %10.2f %+7.1f%%%s", b->median, change, regressed ? "  REGRESSION" : "");
+        } else if(base_path) {
+            printf(" %10s", "-");
+        }
+        printf("\n");
+    }
+
+    if(out_path && !write_results(out_path, results, count)) {
+        fprintf(stderr, "bj_perf: cannot write %s\n", out_path);
+        return 2;
+    }
+    if(regressions) {
+        printf("%d regression%s over %.1f%%\n", regressions, regressions == 1 ? "" : "s", threshold);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * Replays a session recorded by bj_ui -w through the real app on the host Furi shim, as fast
+ * as the CPU allows, and checks the state hash after every event. Nothing is drawn unless -d
+ * (or -o) asks for it. Stops at the first event whose state differs from the recording and
+ * exits 1, printing where it happened.
+ *
+ *   bj_replay [-d] [-o dir] [-s dir] [-n runs] session.bjr
+ */
+#include "furi_shim.h"
+#include "session.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+int32_t blackjack_app(void* p);
+
+typedef struct {
+    const Session* session;
+    size_t next; /* Next event to queue */
+    size_t checked; /* Events delivered and compared */
+    bool diverged;
+    uint64_t got; /* Hash at the divergence */
+    GamePhase phase;
+    uint64_t hands; /* Rounds that reached the result screen */
+    const char* frame_dir;
+} Replay;
+
+static const char* const key_names[InputKeyMAX] = {"Up", "Down", "Right", "Left", "Ok", "Back"};
+static const char* const type_names[InputTypeMAX] = {"Press", "Release", "Short", "Long", "Repeat"};
+
+/* One event at a time, so a divergence stops the run at the event that caused it */
+static bool replay_idle(void* context) {
+    Replay* r = context;
+    if(r->diverged || r->next == r->session->count) return false;
+    const SessionEvent* e = &r->session->events[r->next++];
+    furi_shim_push_input((InputKey)e->key, (InputType)e->type);
+    return true;
+}
+
+static void replay_input(const InputEvent* event, void* model, bool consumed, void* context) {
+    UNUSED(event);
+    UNUSED(consumed);
+    Replay* r = context;
+    const BlackjackState* s = model;
+    uint64_t h = session_state_hash(s);
+    if(s->phase == PhaseResult && r->phase != PhaseResult) r->hands++;
+    r->phase = s->phase;
+    if(h != r->session->events[r->checked].hash && !r->diverged) {
+        r->diverged = true;
+        r->got = h;
+    }
+    if(!r->diverged) r->checked++;
+}
+
+static void replay_frame(const Canvas* canvas, void* model, uint64_t draw_ns, void* context) {
+    UNUSED(model);
+    UNUSED(draw_ns);
+    Replay* r = context;
+    if(!r->frame_dir) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%05llu.png", r->frame_dir, (unsigned long long)furi_shim_counters()->frames);
+    if(!canvas_shim_write_png(canvas, path)) fprintf(stderr, "bj_replay: cannot write %s\n", path);
+}
+
+static double now_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+static void usage(const char* argv0) {
+    fprintf(
+        stderr,
+        "usage: %s [-d] [-o dir] [-s dir] [-n runs] session.bjr\n"
+        "  -d  draw every frame, as the device would (default: skip rendering)\n"
+        "  -o  draw and write every frame to this directory as PNG\n"
+        "  -s  directory standing in for the SD card (default: a fresh empty one)\n"
+        "  -n  replay this many times, for timing (default 1)\n",
+        argv0);
+}
+
+int main(int argc, char** argv) {
+    FuriShimConfig config = {.skip_draw = true};
+    const char* frame_dir = NULL;
+    long runs = 1;
+    int opt;
+    while((opt = getopt(argc, argv, "do:s:n:h")) != -1) {
+        switch(opt) {
+        case 'd':
+            config.skip_draw = false;
+            break;
+        case 'o':
+            frame_dir = optarg;
+            config.skip_draw = false;
+            break;
+        case 's':
+            config.storage_root = optarg;
+            break;
+        case 'n':
+            runs = strtol(optarg, NULL, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if(optind != argc - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    if(runs < 1) runs = 1;
+    Session session;
+    if(!session_read(&session, argv[optind])) {
+        fprintf(stderr, "bj_replay: cannot read session %s\n", argv[optind]);
+        return 2;
+    }
+    if(frame_dir) mkdir(frame_dir, 0755);
+    config.seed = session.seed;
+
+    Replay r;
+    double elapsed = 0;
+    int status = 0;
+    for(long run = 0; run < runs && !status; run++) {
+        memset(&r, 0, sizeof(r));
+        r.session = &session;
+        r.frame_dir = frame_dir;
+        if(!furi_shim_init(&config)) {
+            fprintf(stderr, "bj_replay: cannot create the storage directory\n");
+            return 1;
+        }
+        furi_shim_set_idle_callback(replay_idle, &r);
+        furi_shim_set_input_callback(replay_input, &r);
+        furi_shim_set_frame_callback(replay_frame, &r);
+        double t0 = now_s();
+        blackjack_app(NULL);
+        elapsed += now_s() - t0;
+        if(r.diverged) {
+            const SessionEvent* e = &session.events[r.checked];
+            printf(
+                "diverged at event %zu of %zu (%s %s): state %016llx, recorded %016llx, phase %d\n",
+                r.checked,
+                session.count,
+                key_names[e->key],
+                type_names[e->type],
+                (unsigned long long)r.got,
+                (unsigned long long)e->hash,
+                (int)r.phase);
+            status = 1;
+        } else if(r.checked != session.count) {
+            printf("app exited after %zu of %zu events\n", r.checked, session.count);
+            status = 1;
+        }
+        furi_shim_deinit();
+    }
+    if(!status) {
+        double events = (double)session.count * (double)runs;
+        printf(
+            "%zu events, %llu hands, seed %llx: replay matches; %.0f events/s (%.3f s%s)\n",
+            session.count,
+            (unsigned long long)r.hands,
+            (unsigned long long)session.seed,
+            events / elapsed,
+            elapsed,
+            config.skip_draw ? ", not drawn" : "");
+    }
+    session_free(&session);
+    return status;
+}
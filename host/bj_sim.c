@@ -0,0 +1,257 @@
+/**
+ * Batch hand simulator for the Blackjack rules engine.
+ * Plays N hands through the same game_* calls the app makes from input_callback
+ * and reports hands/sec, EV per hand and win/loss/push counts.
+ *
+ * Each task plays one shoe, dealt down to the cut card, on a work-stealing pool. Task t
+ * plays shoe #t+1 of the session seed exactly as the device would, and statistics are
+ * integer sums, so a given seed prints the same numbers for any thread count. The seed is
+ * hex, as the Statistics screen shows it, for simulating and for -P alike.
+ *
+ *   bj_sim -n 1000000 -s basic -b 10 -r 1 -j 8 -c 75 [-H] [-L history.bjh]
+ *   bj_sim -r 1A2B3C4D -P 12     print shoe #12 of a device session (seed from the Statistics screen)
+ */
+#include "blackjack_history.h"
+#include "pool.h"
+#include "sim.h"
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Cards used per round by basic strategy, x10; estimates the shoes still needed for -n hands */
+#define SIM_CARDS_PER_HAND_X10 54
+
+typedef struct {
+    uint64_t hands;
+    SimStrategy strategy;
+    uint16_t bet;
+    uint8_t cut_card;
+    uint64_t seed;
+    BlackjackRngKind rng_kind;
+    bool hits_soft17;
+    FILE* log; /* -L: hand history, in the device's format */
+    uint64_t first_shoe; /* Task 0 plays the shoe after this one */
+} SimConfig;
+
+/* A shoe holds at most DECK_SIZE / 4 rounds */
+#define SIM_LOG_SHOE_MAX ((DECK_SIZE / 4 + 1) * HISTORY_RECORD_MAX)
+
+typedef struct {
+    const SimConfig* cfg;
+    BlackjackState table;
+    SimStats stats;
+    size_t log_len;
+    uint8_t log[SIM_LOG_SHOE_MAX]; /* This shoe's records, written whole so shoes never interleave */
+} __attribute__((aligned(64))) SimWorker;
+
+static pthread_mutex_t sim_log_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void sim_run_task(void* ctx, uint64_t task) {
+    SimWorker* w = ctx;
+    const SimConfig* cfg = w->cfg;
+    BlackjackState* s = &w->table;
+    memset(s, 0, sizeof(*s));
+    s->dealer_hits_soft17 = cfg->hits_soft17;
+    s->rng.kind = cfg->rng_kind;
+    s->rng_seed = cfg->seed;
+    s->cut_card = cfg->cut_card;
+    /* Pretend shoe #task just ran out, so the first deal shuffles shoe #task+1 */
+    s->shoe_number = (uint32_t)(cfg->first_shoe + task);
+    s->cut_card_out = true;
+
+    do {
+        sim_stats_add(&w->stats, sim_play_hand(s, cfg->strategy, cfg->bet));
+        if(cfg->log) w->log_len += history_encode_hand(w->log + w->log_len, s);
+    } while(!s->cut_card_out);
+    if(cfg->log) {
+        pthread_mutex_lock(&sim_log_lock);
+        fwrite(w->log, 1, w->log_len, cfg->log);
+        pthread_mutex_unlock(&sim_log_lock);
+        w->log_len = 0;
+    }
+}
+
+/* Print the card order of one device shoe, as shuffled by the engine from (seed, shoe) */
+static void print_shoe(uint64_t seed, uint32_t shoe, BlackjackRngKind kind, uint8_t cut_card) {
+    static const char ranks[] = "23456789TJQKA";
+    static const char suits[] = "SHDC";
+    BlackjackRng rng = {.kind = kind};
+    uint8_t deck[DECK_SIZE];
+    blackjack_rng_seed(&rng, seed, shoe);
+    shuffle_deck(deck, &rng);
+    for(int i = 0; i < DECK_SIZE; i++) {
+        const char* mark = i < BURN_TOP ? "*" : "";
+        if(i == cut_card) printf("--- cut card ---\n");
+        printf("%3d %c%c%s\n", i, ranks[CARD_RANK(deck[i])], suits[CARD_SUIT(deck[i])], mark);
+    }
+}
+
+static void usage(const char* argv0) {
+    fprintf(
+        stderr,
+        "usage: %s [-n hands] [-s basic|stand|dealer] [-b bet] [-r seed] [-j threads] [-g xoshiro|pcg] [-c pct] [-H]\n"
+        "          [-L history.bjh]\n"
+        "       %s -r seed -P shoe\n"
+        "  -n  hands to play at least, rounded up to whole shoes (default 1000000)\n"
+        "  -s  player strategy (default basic)\n"
+        "  -b  flat bet in dollars, %d-%d (default 10)\n"
+        "  -r  session seed in hex, as shown on the Statistics screen (default 1)\n"
+        "  -j  worker threads, 0 = one per core (default 1)\n"
+        "  -g  shuffle generator (default xoshiro)\n"
+        "  -c  penetration in percent of the shoe, %d-%d (default %d)\n"
+        "  -H  dealer hits soft 17\n"
+        "  -L  write every hand to a hand history file for bj_history; shoes in the order they finish\n"
+        "  -P  print the card order of a shoe (* = burned) and exit\n",
+        argv0,
+        argv0,
+        MIN_BET,
+        MAX_BET,
+        cut_card_percent(CUT_CARD_MIN),
+        cut_card_percent(CUT_CARD_MAX),
+        cut_card_percent(CUT_CARD_DEFAULT));
+}
+
+int main(int argc, char** argv) {
+    SimConfig cfg = {.hands = 1000000, .strategy = SimStrategyBasic, .bet = 10, .cut_card = CUT_CARD_DEFAULT, .seed = 1};
+    unsigned long bet = 10;
+    unsigned long cut_card = CUT_CARD_DEFAULT;
+    long threads = 1;
+    long print_shoe_number = -1;
+    const char* seed_arg = NULL;
+    const char* log_path = NULL;
+
+    int opt;
+    while((opt = getopt(argc, argv, "n:s:b:r:j:g:c:P:L:Hh")) != -1) {
+        switch(opt) {
+        case 'n':
+            cfg.hands = strtoull(optarg, NULL, 10);
+            break;
+        case 's':
+            if(!sim_strategy_parse(optarg, &cfg.strategy)) {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 'b':
+            bet = strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            seed_arg = optarg;
+            break;
+        case 'g':
+            if(strcmp(optarg, "xoshiro") == 0) cfg.rng_kind = BlackjackRngXoshiro128;
+            else if(strcmp(optarg, "pcg") == 0) cfg.rng_kind = BlackjackRngPcg32;
+            else {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 'c':
+            cut_card = strtoul(optarg, NULL, 10) * DECK_SIZE / 100;
+            break;
+        case 'P':
+            print_shoe_number = strtol(optarg, NULL, 10);
+            break;
+        case 'j':
+            threads = strtol(optarg, NULL, 10);
+            break;
+        case 'H':
+            cfg.hits_soft17 = true;
+            break;
+        case 'L':
+            log_path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if(cut_card < CUT_CARD_MIN || cut_card > CUT_CARD_MAX) {
+        usage(argv[0]);
+        return 2;
+    }
+    cfg.cut_card = (uint8_t)cut_card;
+    if(seed_arg) cfg.seed = strtoull(seed_arg, NULL, 16);
+    if(print_shoe_number >= 0) {
+        if(!seed_arg) {
+            usage(argv[0]);
+            return 2;
+        }
+        print_shoe(cfg.seed, (uint32_t)print_shoe_number, cfg.rng_kind, cfg.cut_card);
+        return 0;
+    }
+    if(cfg.hands == 0 || bet < MIN_BET || bet > MAX_BET || threads < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    cfg.bet = (uint16_t)bet;
+    if(threads == 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads < 1) threads = 1;
+
+    if(log_path) {
+        cfg.log = fopen(log_path, "wb");
+        if(!cfg.log) {
+            perror(log_path);
+            return 1;
+        }
+        uint8_t record[HISTORY_RECORD_MAX];
+        fwrite(record, 1, history_encode_session(record, cfg.seed), cfg.log);
+    }
+
+    uint64_t hands_per_shoe = (uint64_t)(cfg.cut_card - BURN_TOP) * 10 / SIM_CARDS_PER_HAND_X10 + 1;
+    SimWorker** workers = calloc((size_t)threads, sizeof(SimWorker*));
+    for(long i = 0; i < threads; i++) {
+        workers[i] = aligned_alloc(64, sizeof(SimWorker));
+        memset(workers[i], 0, sizeof(SimWorker));
+        workers[i]->cfg = &cfg;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    /* Shoes run in batches sized from the estimate until -n hands are in; the batches depend
+     * only on the hand counts, so the shoes played do not depend on the thread count */
+    uint64_t played = 0;
+    while(played < cfg.hands) {
+        uint64_t tasks = (cfg.hands - played + hands_per_shoe - 1) / hands_per_shoe;
+        pool_run(tasks, (unsigned)threads, sim_run_task, (void* const*)workers);
+        cfg.first_shoe += tasks;
+        played = 0;
+        for(long i = 0; i < threads; i++) played += workers[i]->stats.hands;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    if(cfg.log && fclose(cfg.log) != 0) {
+        perror(log_path);
+        return 1;
+    }
+
+    SimStats st;
+    memset(&st, 0, sizeof(st));
+    for(long i = 0; i < threads; i++) {
+        sim_stats_merge(&st, &workers[i]->stats);
+        free(workers[i]);
+    }
+    free(workers);
+
+    double n = (double)st.hands;
+    double ev = (double)st.net / (double)cfg.bet / n;
+    double var = (double)st.net_sq / ((double)cfg.bet * (double)cfg.bet) / n - ev * ev;
+    double ci = 1.96 * sqrt(var > 0 ? var : 0) / sqrt(n);
+
+    printf("strategy      %s%s\n", sim_strategy_names[cfg.strategy], cfg.hits_soft17 ? " (dealer H17)" : " (dealer S17)");
+    printf("threads       %ld\n", threads);
+    printf("shoes         %llu (%u%% penetration)\n", (unsigned long long)cfg.first_shoe, (unsigned)cut_card_percent(cfg.cut_card));
+    printf("hands         %llu\n", (unsigned long long)st.hands);
+    printf("hands/sec     %.0f\n", secs > 0 ? n / secs : 0.0);
+    printf("EV/hand       %+.5f units (%+.3f%% +/- %.3f%%, 95%% CI)\n", ev, ev * 100.0, ci * 100.0);
+    printf("net           %+lld $\n", (long long)st.net);
+    printf("wins          %llu (%.2f%%)\n", (unsigned long long)st.wins, 100.0 * (double)st.wins / n);
+    printf("losses        %llu (%.2f%%)\n", (unsigned long long)st.losses, 100.0 * (double)st.losses / n);
+    printf("pushes        %llu (%.2f%%)\n", (unsigned long long)st.pushes, 100.0 * (double)st.pushes / n);
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * Sprite atlas generator.
+ * Reads the art in images/ and writes blackjack_sprites.c (see blackjack_sprites.h):
+ *   cards.png      13 x 4 card faces, ranks 2..A across, suits S H D C down
+ *   card_back.png  one card back
+ *   chip.png       one chip; the stacks are built here by overlapping copies
+ * Any PNG works; dark opaque pixels become set bits. -p instead prints every sprite as
+ * text, to check the conversion.
+ *
+ *   bj_sprite_gen [-i ../images] > ../blackjack_sprites.c     (make sprites)
+ *   bj_sprite_gen [-i dir] -p
+ */
+#include "blackjack_sprites.h"
+#include "png.h"
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const rank_names[13] = {"2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K", "A"};
+static const char suit_names[4] = {'S', 'H', 'D', 'C'};
+
+typedef struct {
+    PngImage cards;
+    PngImage back;
+    PngImage chip;
+} Art;
+
+static bool load(const char* dir, const char* name, uint32_t width, uint32_t height, PngImage* out) {
+    char path[512], err[128];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    if(!png_read(path, out, err, sizeof(err))) {
+        fprintf(stderr, "bj_sprite_gen: %s: %s\n", path, err);
+        return false;
+    }
+    if(out->width != width || out->height != height) {
+        fprintf(
+            stderr,
+            "bj_sprite_gen: %s is %ux%u, expected %ux%u\n",
+            path,
+            (unsigned)out->width,
+            (unsigned)out->height,
+            (unsigned)width,
+            (unsigned)height);
+        png_free(out);
+        return false;
+    }
+    return true;
+}
+
+/* OR a width x height region of the image at (sx, sy) into an XBM buffer at (dx, 0) */
+static void pack(const PngImage* img, uint32_t sx, uint32_t sy, int width, int height, uint8_t* xbm, int stride, int dx) {
+    for(int y = 0; y < height; y++) {
+        for(int x = 0; x < width; x++) {
+            if(img->ink[(size_t)(sy + y) * img->width + sx + x]) xbm[y * stride + (dx + x) / 8] |= 1 << ((dx + x) % 8);
+        }
+    }
+}
+
+static void emit_bytes(const uint8_t* xbm, int len) {
+    for(int i = 0; i < len; i++) printf("%s0x%02X,%s", i % 12 ? " " : "        ", xbm[i], i % 12 == 11 || i == len - 1 ? "\n" : "");
+}
+
+static void print_sprite(const char* name, const uint8_t* xbm, int width, int height) {
+    int stride = (width + 7) / 8;
+    printf("%s (%dx%d)\n", name, width, height);
+    for(int y = 0; y < height; y++) {
+        for(int x = 0; x < width; x++) putchar(xbm[y * stride + x / 8] & (1 << (x % 8)) ? '#' : '.');
+        putchar('\n');
+    }
+    putchar('\n');
+}
+
+static void card_face(const Art* art, int card, uint8_t* xbm) {
+    memset(xbm, 0, SPRITE_CARD_BYTES);
+    pack(&art->cards, (card % 13) * SPRITE_CARD_W, (card / 13) * SPRITE_CARD_H, SPRITE_CARD_W, SPRITE_CARD_H, xbm, (SPRITE_CARD_W + 7) / 8, 0);
+}
+
+/* Stacks are stored at the widest stride so the array is rectangular; each is drawn at its own width */
+static void chip_stack(const Art* art, int chips, uint8_t* xbm) {
+    int stride = (SPRITE_CHIP_STACK_W(chips) + 7) / 8;
+    memset(xbm, 0, SPRITE_CHIP_STACK_BYTES);
+    for(int i = 0; i < chips; i++) pack(&art->chip, 0, 0, SPRITE_CHIP_W, SPRITE_CHIP_H, xbm, stride, i * SPRITE_CHIP_STEP);
+}
+
+static void print_atlas(const Art* art) {
+    uint8_t xbm[SPRITE_CHIP_STACK_BYTES > SPRITE_CARD_BYTES ? SPRITE_CHIP_STACK_BYTES : SPRITE_CARD_BYTES];
+    char name[24];
+    for(int card = 0; card < 52; card++) {
+        card_face(art, card, xbm);
+        snprintf(name, sizeof(name), "%s%c", rank_names[card % 13], suit_names[card / 13]);
+        print_sprite(name, xbm, SPRITE_CARD_W, SPRITE_CARD_H);
+    }
+    memset(xbm, 0, sizeof(xbm));
+    pack(&art->back, 0, 0, SPRITE_CARD_W, SPRITE_CARD_H, xbm, (SPRITE_CARD_W + 7) / 8, 0);
+    print_sprite("back", xbm, SPRITE_CARD_W, SPRITE_CARD_H);
+    for(int n = 1; n <= SPRITE_CHIP_STACK_MAX; n++) {
+        chip_stack(art, n, xbm);
+        snprintf(name, sizeof(name), "%d chips", n);
+        print_sprite(name, xbm, SPRITE_CHIP_STACK_W(n), SPRITE_CHIP_H);
+    }
+}
+
+static void write_atlas(const Art* art) {
+    uint8_t xbm[SPRITE_CHIP_STACK_BYTES > SPRITE_CARD_BYTES ? SPRITE_CHIP_STACK_BYTES : SPRITE_CARD_BYTES];
+    printf("/**\n"
+           " * Sprite atlas (see blackjack_sprites.h).\n"
+           " * From images/cards.png, card_back.png and chip.png.\n"
+           " * Generated by host/bj_sprite_gen (make -C host sprites); do not edit by hand.\n"
+           " */\n"
+           "#include \"blackjack_sprites.h\"\n\n");
+    printf("const uint8_t sprite_card_faces[52][SPRITE_CARD_BYTES] = {\n");
+    for(int card = 0; card < 52; card++) {
+        card_face(art, card, xbm);
+        printf("    { /* %s%c */\n", rank_names[card % 13], suit_names[card / 13]);
+        emit_bytes(xbm, SPRITE_CARD_BYTES);
+        printf("    },\n");
+    }
+    printf("};\n\n");
+    memset(xbm, 0, sizeof(xbm));
+    pack(&art->back, 0, 0, SPRITE_CARD_W, SPRITE_CARD_H, xbm, (SPRITE_CARD_W + 7) / 8, 0);
+    printf("const uint8_t sprite_card_back[SPRITE_CARD_BYTES] = {\n");
+    emit_bytes(xbm, SPRITE_CARD_BYTES);
+    printf("};\n\n");
+    printf("const uint8_t sprite_chip_stacks[SPRITE_CHIP_STACK_MAX][SPRITE_CHIP_STACK_BYTES] = {\n");
+    for(int n = 1; n <= SPRITE_CHIP_STACK_MAX; n++) {
+        chip_stack(art, n, xbm);
+        printf("    { /* %d chip%s */\n", n, n == 1 ? "" : "s");
+        emit_bytes(xbm, (SPRITE_CHIP_STACK_W(n) + 7) / 8 * SPRITE_CHIP_H);
+        printf("    },\n");
+    }
+    printf("};\n");
+}
+
+int main(int argc, char** argv) {
+    const char* dir = "../images";
+    bool text = false;
+    int opt;
+    while((opt = getopt(argc, argv, "i:ph")) != -1) {
+        switch(opt) {
+        case 'i':
+            dir = optarg;
+            break;
+        case 'p':
+            text = true;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-i images_dir] [-p]\n", argv[0]);
+            return 2;
+        }
+    }
+    Art art;
+    if(!load(dir, "cards.png", 13 * SPRITE_CARD_W, 4 * SPRITE_CARD_H, &art.cards)) return 1;
+    if(!load(dir, "card_back.png", SPRITE_CARD_W, SPRITE_CARD_H, &art.back)) return 1;
+    if(!load(dir, "chip.png", SPRITE_CHIP_W, SPRITE_CHIP_H, &art.chip)) return 1;
+    if(text) {
+        print_atlas(&art);
+    } else {
+        write_atlas(&art);
+    }
+    png_free(&art.cards);
+    png_free(&art.back);
+    png_free(&art.chip);
+    return 0;
+}
@@ -0,0 +1,307 @@
+/**
+ * Basic strategy table generator.
+ * Computes infinite-deck EV for stand / hit / double / split under the engine's rules
+ * (see blackjack_strategy.h) and writes blackjack_strategy_tables.c, or a readable chart.
+ * With -e, the cells are then redone from the exact composition-dependent solve of the
+ * DECKS-deck shoe (cd_solve.h); only cells no hand can reach keep the infinite-deck play.
+ *
+ *   bj_strategy_gen -e -j 0 > ../blackjack_strategy_tables.c     (make strategy)
+ *   bj_strategy_gen [-e] -c [-H]                                 print the chart, dealer S17 or H17
+ */
+#include "blackjack_strategy.h"
+#include "cd_solve.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Outcomes of a dealer hand: 17..21, then bust (including the 6-card rule) */
+#define DEALER_OUTCOMES 6
+#define DEALER_BUST 5
+#define MAX_TOTAL 32
+
+/* Infinite deck: A, 2..9 at 1/13 each, ten-valued at 4/13; index = card points */
+static const double card_prob[11] = {0, 1.0 / 13, 1.0 / 13, 1.0 / 13, 1.0 / 13, 1.0 / 13, 1.0 / 13, 1.0 / 13, 1.0 / 13, 1.0 / 13, 4.0 / 13};
+
+typedef struct {
+    bool hits_soft17;
+    double dealer[10][DEALER_OUTCOMES]; /* By strategy column, given no dealer blackjack */
+    int column;
+    /* Player memo by (hard, ace held, cards): best of stand/hit without doubling */
+    double best[MAX_TOTAL][2][MAX_HAND + 1];
+    bool best_done[MAX_TOTAL][2][MAX_HAND + 1];
+} Solver;
+
+static uint8_t value_of(uint8_t hard, bool ace) {
+    return (ace && hard <= 11) ? hard + 10 : hard;
+}
+
+static void dealer_play(const Solver* sv, uint8_t hard, bool ace, uint8_t count, double p, double* out) {
+    uint8_t v = value_of(hard, ace);
+    if(v > 21 || count == MAX_HAND) {
+        out[DEALER_BUST] += p; /* A 6th card without busting still loses */
+        return;
+    }
+    bool soft17 = (v == 17 && ace && hard == 7);
+    if(v >= 17 && !(soft17 && sv->hits_soft17)) {
+        out[v - 17] += p;
+        return;
+    }
+    for(uint8_t c = 1; c <= 10; c++) {
+        dealer_play(sv, hard + c, ace || c == 1, count + 1, p * card_prob[c], out);
+    }
+}
+
+/* Final dealer totals for an upcard, conditioned on the hole card not making blackjack (peek) */
+static void dealer_table(Solver* sv) {
+    for(uint8_t up = 1; up <= 10; up++) {
+        int col = up == 1 ? 9 : up - 2;
+        double* out = sv->dealer[col];
+        memset(out, 0, sizeof(sv->dealer[col]));
+        double norm = 0;
+        for(uint8_t hole = 1; hole <= 10; hole++) {
+            if((up == 1 && hole == 10) || (up == 10 && hole == 1)) continue;
+            norm += card_prob[hole];
+            dealer_play(sv, up + hole, up == 1 || hole == 1, 2, card_prob[hole], out);
+        }
+        for(int i = 0; i < DEALER_OUTCOMES; i++) out[i] /= norm;
+    }
+}
+
+static double ev_stand(const Solver* sv, uint8_t v) {
+    const double* d = sv->dealer[sv->column];
+    double ev = d[DEALER_BUST];
+    for(uint8_t t = 17; t <= 21; t++) {
+        if(v > t) ev += d[t - 17];
+        else if(v < t) ev -= d[t - 17];
+    }
+    return ev;
+}
+
+static double ev_best(Solver* sv, uint8_t hard, bool ace, uint8_t count);
+
+static double ev_hit(Solver* sv, uint8_t hard, bool ace, uint8_t count) {
+    double ev = 0;
+    for(uint8_t c = 1; c <= 10; c++) {
+        uint8_t h = hard + c;
+        bool a = ace || c == 1;
+        if(value_of(h, a) > 21) ev -= card_prob[c];
+        else if(count + 1 == MAX_HAND) ev += card_prob[c]; /* 6 cards without busting wins */
+        else ev += card_prob[c] * ev_best(sv, h, a, count + 1);
+    }
+    return ev;
+}
+
+static double ev_best(Solver* sv, uint8_t hard, bool ace, uint8_t count) {
+    if(sv->best_done[hard][ace][count]) return sv->best[hard][ace][count];
+    double stand = ev_stand(sv, value_of(hard, ace));
+    double hit = ev_hit(sv, hard, ace, count);
+    double best = hit > stand ? hit : stand;
+    sv->best[hard][ace][count] = best;
+    sv->best_done[hard][ace][count] = true;
+    return best;
+}
+
+static double ev_double(const Solver* sv, uint8_t hard, bool ace) {
+    double ev = 0;
+    for(uint8_t c = 1; c <= 10; c++) {
+        uint8_t v = value_of(hard + c, ace || c == 1);
+        ev += card_prob[c] * (v > 21 ? -1.0 : ev_stand(sv, v));
+    }
+    return 2 * ev;
+}
+
+/* Each split hand gets one card and is then played with doubling allowed, no resplit */
+static double ev_split(Solver* sv, uint8_t card) {
+    double ev = 0;
+    for(uint8_t c = 1; c <= 10; c++) {
+        uint8_t h = card + c;
+        bool a = card == 1 || c == 1;
+        double best = ev_best(sv, h, a, 2);
+        double dbl = ev_double(sv, h, a);
+        ev += card_prob[c] * (dbl > best ? dbl : best);
+    }
+    return 2 * ev;
+}
+
+static uint8_t solve_cell(Solver* sv, uint8_t hard, bool ace, uint8_t count) {
+    double stand = ev_stand(sv, value_of(hard, ace));
+    double hit = ev_hit(sv, hard, ace, count);
+    if(count == 2 && ev_double(sv, hard, ace) > (hit > stand ? hit : stand)) {
+        return hit > stand ? STRATEGY_CELL_DOUBLE_HIT : STRATEGY_CELL_DOUBLE_STAND;
+    }
+    return hit > stand ? STRATEGY_CELL_HIT : STRATEGY_CELL_STAND;
+}
+
+static void solve(StrategyTables* t, bool hits_soft17) {
+    static Solver sv;
+    memset(&sv, 0, sizeof(sv));
+    memset(t, 0, sizeof(*t));
+    sv.hits_soft17 = hits_soft17;
+    dealer_table(&sv);
+    for(int col = 0; col < 10; col++) {
+        sv.column = col;
+        memset(sv.best_done, 0, sizeof(sv.best_done));
+        for(int c = 0; c < STRATEGY_COUNTS; c++) {
+            uint8_t count = (uint8_t)(c + 2);
+            for(int r = 0; r < STRATEGY_HARD_ROWS; r++) {
+                uint8_t hard = (uint8_t)(STRATEGY_HARD_MIN + r);
+                t->hard[c][r] |= (uint32_t)solve_cell(&sv, hard, false, count) << (col * 2);
+            }
+            for(int r = 0; r < STRATEGY_SOFT_ROWS; r++) {
+                uint8_t hard = (uint8_t)(STRATEGY_SOFT_MIN + r - 10);
+                t->soft[c][r] |= (uint32_t)solve_cell(&sv, hard, true, count) << (col * 2);
+            }
+        }
+        for(int r = 0; r < STRATEGY_PAIR_ROWS; r++) {
+            uint8_t card = (uint8_t)(r + 1);
+            uint8_t hard = card * 2;
+            bool ace = card == 1;
+            double keep = ev_best(&sv, hard, ace, 2);
+            double dbl = ev_double(&sv, hard, ace);
+            if(dbl > keep) keep = dbl;
+            if(ev_split(&sv, card) > keep) t->pairs[r] |= 1U << (col * 2);
+        }
+    }
+}
+
+static void print_rows(const char* name, const uint32_t* rows, int n, int first, const char* label) {
+    printf("        .%s = {", name);
+    for(int r = 0; r < n; r++) {
+        if(r % 6 == 0) printf("\n            ");
+        else printf(" ");
+        printf("0x%05X,", (unsigned)rows[r]);
+    }
+    printf("\n        }, /* %s %d-%d */\n", label, first, first + n - 1);
+}
+
+static void print_source(const StrategyTables* tables, bool exact) {
+    printf("/**\n");
+    printf(" * Basic strategy tables (see blackjack_strategy.h).\n");
+    if(exact) printf(" * From the exact %d-deck composition-dependent solve, summed per cell.\n", DECKS);
+    else printf(" * From infinite-deck EV.\n");
+    printf(" * Generated by host/bj_strategy_gen (make -C host strategy); do not edit by hand.\n");
+    printf(" */\n");
+    printf("#include \"blackjack_strategy.h\"\n\n");
+    printf("const StrategyTables strategy_tables[2] = {\n");
+    for(int h = 0; h < 2; h++) {
+        const StrategyTables* t = &tables[h];
+        printf("    { /* Dealer %s soft 17 */\n", h ? "hits" : "stands on");
+        printf("        .hard = {\n");
+        for(int c = 0; c < STRATEGY_COUNTS; c++) {
+            printf("            { /* %d cards */", c + 2);
+            for(int r = 0; r < STRATEGY_HARD_ROWS; r++) {
+                if(r % 6 == 0) printf("\n                ");
+                else printf(" ");
+                printf("0x%05X,", (unsigned)t->hard[c][r]);
+            }
+            printf("\n            },\n");
+        }
+        printf("        }, /* Hard %d-%d */\n", STRATEGY_HARD_MIN, STRATEGY_HARD_MIN + STRATEGY_HARD_ROWS - 1);
+        printf("        .soft = {\n");
+        for(int c = 0; c < STRATEGY_COUNTS; c++) {
+            printf("            { /* %d cards */", c + 2);
+            for(int r = 0; r < STRATEGY_SOFT_ROWS; r++) {
+                if(r % 6 == 0) printf("\n                ");
+                else printf(" ");
+                printf("0x%05X,", (unsigned)t->soft[c][r]);
+            }
+            printf("\n            },\n");
+        }
+        printf("        }, /* Soft %d-%d */\n", STRATEGY_SOFT_MIN, STRATEGY_SOFT_MIN + STRATEGY_SOFT_ROWS - 1);
+        print_rows("pairs", t->pairs, STRATEGY_PAIR_ROWS, 1, "Pairs by card points, Ace = 1:");
+        printf("    },\n");
+    }
+    printf("};\n");
+}
+
+static void print_chart_row(const char* label, uint32_t row, bool pair) {
+    static const char* const cells[] = {"S ", "H ", "Dh", "Ds"};
+    printf("%-7s", label);
+    for(uint8_t col = 0; col < 10; col++) {
+        uint8_t cell = strategy_cell(row, col);
+        printf(" %s", pair ? (cell ? "P " : ". ") : cells[cell]);
+    }
+    printf("\n");
+}
+
+static void print_chart(const StrategyTables* t, bool hits_soft17) {
+    char label[16];
+    printf("Dealer %s soft 17; S=stand H=hit Dh/Ds=double else hit/stand P=split\n", hits_soft17 ? "hits" : "stands on");
+    for(int c = 0; c < STRATEGY_COUNTS; c++) {
+        printf("\n%d cards 2  3  4  5  6  7  8  9  T  A\n", c + 2);
+        for(int r = 0; r < STRATEGY_HARD_ROWS; r++) {
+            snprintf(label, sizeof(label), "H%d", STRATEGY_HARD_MIN + r);
+            print_chart_row(label, t->hard[c][r], false);
+        }
+        for(int r = 0; r < STRATEGY_SOFT_ROWS; r++) {
+            snprintf(label, sizeof(label), "S%d", STRATEGY_SOFT_MIN + r);
+            print_chart_row(label, t->soft[c][r], false);
+        }
+    }
+    printf("\npairs   2  3  4  5  6  7  8  9  T  A\n");
+    for(int r = 0; r < STRATEGY_PAIR_ROWS; r++) {
+        if(r == 0) snprintf(label, sizeof(label), "A,A");
+        else snprintf(label, sizeof(label), "%d,%d", r + 1, r + 1);
+        print_chart_row(label, t->pairs[r], true);
+    }
+}
+
+int main(int argc, char** argv) {
+    bool chart = false;
+    bool hits_soft17 = false;
+    bool exact = false;
+    long threads = 1;
+    int opt;
+    while((opt = getopt(argc, argv, "cHej:")) != -1) {
+        switch(opt) {
+        case 'c':
+            chart = true;
+            break;
+        case 'H':
+            hits_soft17 = true;
+            break;
+        case 'e':
+            exact = true;
+            break;
+        case 'j':
+            threads = strtol(optarg, NULL, 10);
+            break;
+        default:
+            fprintf(
+                stderr,
+                "usage: %s [-e [-j threads]] [-c [-H]]\n"
+                "  -e  exact composition-dependent solve of the %d-deck shoe\n"
+                "  -j  worker threads for -e, 0 = one per core (default 1)\n"
+                "  -c  print a readable chart instead of C source\n"
+                "  -H  chart for dealer hits soft 17\n",
+                argv[0],
+                DECKS);
+            return 2;
+        }
+    }
+    if(threads == 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads < 1) threads = 1;
+    StrategyTables tables[2];
+    for(int h = 0; h < 2; h++) {
+        solve(&tables[h], h);
+        if(!exact) continue;
+        CdSolveStats st;
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        cd_solve(&tables[h], h, (unsigned)threads, &st);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        fprintf(
+            stderr,
+            "%s: %llu compositions, %llu table nodes, %llu play differently from their cell, %.1f s\n",
+            h ? "H17" : "S17",
+            (unsigned long long)st.compositions,
+            (unsigned long long)st.nodes,
+            (unsigned long long)st.exceptions,
+            (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9);
+    }
+    if(chart) print_chart(&tables[hits_soft17 ? 1 : 0], hits_soft17);
+    else print_source(tables, exact);
+    return 0;
+}
@@ -0,0 +1,441 @@
+/**
+ * Headless run of the real app (blackjack.c, unmodified) on the host Furi shim.
+ * Keys come from a script; every frame can be timed by game phase and dumped as PNG or PBM.
+ * Build with sanitizers or run under perf like any host binary.
+ *
+ * Key script: u d l r o b for Up, Down, Left, Right, OK, Back (either case), each sent as
+ * Press, Short, Release; a number repeats the key after it ("3r" = "rrr"); anything else is
+ * ignored. -R n then adds n random presses (mostly OK, never Back where it would quit).
+ * When the keys run out the app returns, as if the user pressed the power button.
+ *
+ * -w records the session (seed, every event and the state hash after it, see session.h) for
+ * bj_replay. Without -s it then starts from an empty temporary SD card, so the replay does too.
+ *
+ * -E presses every key in every phase the app waits in. After the script (default
+ * UI_ENUM_SCRIPT, through the menus) and a random walk (-R, default UI_ENUM_WALK presses) have
+ * reached the phases, on an empty temporary SD card unless -s is given, the first state seen in each
+ * phase is restored into the model before every key not pressed there yet; a key that quits
+ * the app restarts it. Fails if a key the app ignored changed the game state.
+ *
+ *   bj_ui -k "o 2r o o" -r 1A2B3C4D -s build/ext -t -o build/frames [-p] [-v]
+ *   bj_ui -k @session.keys
+ *   bj_ui -k "3d" -R 100000 -w build/monkey.bjr
+ *   bj_ui -E
+ */
+#include "furi_shim.h"
+#include "session.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+int32_t blackjack_app(void* p);
+
+#define UI_PHASES PhaseCount
+#define UI_SAMPLES_MAX 4096 /* Draw times kept per phase for the median */
+#define UI_ENUM_WALK 20000
+/* -E without -k: Settings, Erase all and back, then play as a guest and save to a slot */
+#define UI_ENUM_SCRIPT "5d o 5d o b b 3u o b d o o"
+
+typedef struct {
+    uint64_t frames;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t kept;
+    uint32_t sample[UI_SAMPLES_MAX];
+} PhaseTimes;
+
+static const char* const key_names[InputKeyMAX] = {"Up", "Down", "Right", "Left", "OK", "Back"};
+
+typedef enum {
+    UiKeyPressed = 1 << 0,
+    UiKeyHandled = 1 << 1, /* The app took the key at least once */
+    UiKeyIgnored = 1 << 2, /* ... or passed it on */
+    UiKeyExit = 1 << 3, /* The app quit */
+    UiKeyChanged = 1 << 4, /* Passed on, yet the game state changed: a bug */
+} UiKeyOutcome;
+
+/* -E bookkeeping */
+typedef struct {
+    bool waits[UI_PHASES]; /* Seen waiting for a key */
+    BlackjackState first[UI_PHASES]; /* The first such state, restored to press the rest */
+    uint8_t outcome[UI_PHASES][InputKeyMAX]; /* UiKeyOutcome bits */
+    uint32_t leads_to[UI_PHASES][InputKeyMAX]; /* Bit per phase a handled key led to */
+    uint8_t before; /* Phase the next press starts from */
+    uint64_t hash_before;
+    uint8_t last_phase; /* Phase and key of the last press, to blame if the app quits */
+    InputKey last_key;
+    bool priming; /* A press from a state not seen yet (app start): not counted */
+    bool done; /* Every pair pressed */
+} UiEnum;
+
+typedef struct {
+    const char* script;
+    size_t pos;
+    InputKey key;
+    unsigned repeat; /* Presses of key still to send */
+    uint64_t random_presses;
+    uint64_t random_state;
+    GamePhase last_phase; /* After the last event */
+    Session* record;
+    const char* frame_dir;
+    bool pbm;
+    UiEnum* enumerate;
+    BlackjackState* model; /* Seen by the first input; NULL until then */
+    PhaseTimes phase[UI_PHASES];
+} UiRun;
+
+/* First phase and key the app waits in that has not been pressed; false when all are */
+static bool ui_enum_next(const UiEnum* en, uint8_t* phase, InputKey* key) {
+    for(uint8_t p = 0; p < UI_PHASES; p++) {
+        for(int k = 0; en->waits[p] && k < InputKeyMAX; k++) {
+            if(!(en->outcome[p][k] & UiKeyPressed)) {
+                *phase = p;
+                *key = (InputKey)k;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* The app waits for a key in s: note the state the press starts from */
+static void ui_enum_wait(UiEnum* en, const BlackjackState* s) {
+    if(s->phase < UI_PHASES && !en->waits[s->phase]) {
+        en->waits[s->phase] = true;
+        en->first[s->phase] = *s;
+    }
+    en->before = s->phase;
+    en->hash_before = session_state_hash(s);
+    en->priming = false;
+}
+
+static bool ui_enum_idle(UiRun* run) {
+    UiEnum* en = run->enumerate;
+    uint8_t phase;
+    InputKey key;
+    if(!ui_enum_next(en, &phase, &key)) {
+        en->done = true;
+        return false;
+    }
+    if(!run->model) {
+        /* A restarted app: any key gets it to ui_input, which finds the model */
+        en->priming = true;
+        furi_shim_press(InputKeyUp);
+        return true;
+    }
+    /* Walk done: press the next pair from the first state of its phase */
+    BlackjackState* s = run->model;
+    *s = en->first[phase];
+    s->dirty = GameDirtyAll;
+    en->before = phase;
+    en->hash_before = session_state_hash(s);
+    run->last_phase = phase;
+    furi_shim_press(key);
+    return true;
+}
+
+static void ui_enum_input(UiEnum* en, const InputEvent* event, const BlackjackState* s, bool consumed) {
+    if(event->type != InputTypePress) return;
+    if(!en->priming) {
+        uint8_t* outcome = &en->outcome[en->before][event->key];
+        *outcome |= UiKeyPressed | (consumed ? UiKeyHandled : UiKeyIgnored);
+        if(consumed) en->leads_to[en->before][event->key] |= 1u << s->phase;
+        else if(session_state_hash(s) != en->hash_before) *outcome |= UiKeyChanged;
+        en->last_phase = en->before;
+        en->last_key = event->key;
+    }
+}
+
+/* One line per phase and key; returns how many ignored keys changed the state */
+static unsigned ui_enum_report(const UiEnum* en) {
+    unsigned waiting = 0, pairs = 0, handled = 0, ignored = 0, exits = 0, changed = 0;
+    printf("%-18s %-6s %s\n", "phase", "key", "result");
+    for(uint8_t p = 0; p < UI_PHASES; p++) {
+        if(!en->waits[p]) continue;
+        waiting++;
+        for(int k = 0; k < InputKeyMAX; k++) {
+            uint8_t o = en->outcome[p][k];
+            pairs++;
+            handled += (o & UiKeyHandled) != 0;
+            ignored += (o & UiKeyHandled) == 0;
+            exits += (o & UiKeyExit) != 0;
+            changed += (o & UiKeyChanged) != 0;
+            printf("%-18s %-6s", game_phase_name(p), key_names[k]);
+            if(o & UiKeyExit) printf(" exit");
+            for(uint8_t q = 0; q < UI_PHASES; q++) {
+                if(!(o & UiKeyExit) && (en->leads_to[p][k] >> q & 1)) printf(" %s", game_phase_name(q));
+            }
+            if(o & UiKeyIgnored) printf("%s", (o & UiKeyHandled) ? " (ignored at times)" : " ignored");
+            if(o & UiKeyChanged) printf(" CHANGED THE STATE");
+            printf("\n");
+        }
+    }
+    printf("never waited for a key:");
+    for(uint8_t p = 0; p < UI_PHASES; p++) {
+        if(!en->waits[p]) printf(" %s", game_phase_name(p));
+    }
+    printf(
+        "\n%u phases wait for keys: %u phase/key pairs, %u handled, %u always ignored, %u exit\n",
+        waiting,
+        pairs,
+        handled,
+        ignored,
+        exits);
+    if(changed) printf("%u ignored keys changed the game state\n", changed);
+    return changed;
+}
+
+/* Queue the next press of the script */
+static bool ui_idle(void* context) {
+    UiRun* run = context;
+    static const char keys[] = "udlrob";
+    /* Timers and custom events have run by now, so this is the state the next key meets */
+    if(run->enumerate && run->model) ui_enum_wait(run->enumerate, run->model);
+    static const InputKey key_of[] = {InputKeyUp, InputKeyDown, InputKeyLeft, InputKeyRight, InputKeyOk, InputKeyBack};
+    unsigned repeat = 0;
+    while(!run->repeat && run->script[run->pos]) {
+        char c = run->script[run->pos++];
+        const char* k = strchr(keys, c | 0x20);
+        if(c >= '0' && c <= '9') {
+            repeat = repeat * 10 + (unsigned)(c - '0');
+        } else if(k) {
+            run->key = key_of[k - keys];
+            run->repeat = repeat ? repeat : 1;
+        }
+    }
+    if(!run->repeat && run->random_presses) {
+        /* OK moves play along; Back from the menus would quit the app */
+        static const InputKey weighted[10] = {
+            InputKeyOk, InputKeyOk, InputKeyOk, InputKeyOk, InputKeyUp,
+            InputKeyDown, InputKeyDown, InputKeyLeft, InputKeyRight, InputKeyBack};
+        InputKey key;
+        do {
+            uint64_t z = (run->random_state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = weighted[(z ^ (z >> 31)) % 10];
+        } while(key == InputKeyBack && (run->last_phase == PhaseSplash || run->last_phase == PhaseProfileMenu));
+        run->random_presses--;
+        run->key = key;
+        run->repeat = 1;
+    }
+    if(!run->repeat) return run->enumerate ? ui_enum_idle(run) : false;
+    run->repeat--;
+    furi_shim_press(run->key);
+    return true;
+}
+
+static void ui_input(const InputEvent* event, void* model, bool consumed, void* context) {
+    UiRun* run = context;
+    BlackjackState* s = model;
+    run->model = s;
+    run->last_phase = s->phase;
+    if(run->enumerate) ui_enum_input(run->enumerate, event, s, consumed);
+    if(run->record && !session_append(run->record, event->key, event->type, session_state_hash(s))) {
+        fprintf(stderr, "bj_ui: out of memory recording the session\n");
+        exit(1);
+    }
+}
+
+static void ui_frame(const Canvas* canvas, void* model, uint64_t draw_ns, void* context) {
+    UiRun* run = context;
+    const BlackjackState* s = model;
+    unsigned p = s->phase < UI_PHASES ? s->phase : 0;
+    PhaseTimes* t = &run->phase[p];
+    t->frames++;
+    t->total_ns += draw_ns;
+    if(draw_ns > t->max_ns) t->max_ns = draw_ns;
+    if(t->kept < UI_SAMPLES_MAX) t->sample[t->kept++] = (uint32_t)(draw_ns > UINT32_MAX ? UINT32_MAX : draw_ns);
+    if(run->frame_dir) {
+        char path[512];
+        uint64_t n = furi_shim_counters()->frames;
+        snprintf(path, sizeof(path), "%s/%05llu_%s.%s", run->frame_dir, (unsigned long long)n, game_phase_name(p), run->pbm ? "pbm" : "png");
+        bool ok = run->pbm ? canvas_shim_write_pbm(canvas, path) : canvas_shim_write_png(canvas, path);
+        if(!ok) fprintf(stderr, "bj_ui: cannot write %s\n", path);
+    }
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void print_times(UiRun* run) {
+    printf("%-18s %8s %10s %10s %10s\n", "phase", "frames", "median us", "mean us", "max us");
+    for(unsigned p = 0; p < UI_PHASES; p++) {
+        PhaseTimes* t = &run->phase[p];
+        if(!t->frames) continue;
+        qsort(t->sample, t->kept, sizeof(uint32_t), cmp_u32);
+        printf(
+            "%-18s %8llu %10.2f %10.2f %10.2f\n",
+            game_phase_name(p),
+            (unsigned long long)t->frames,
+            t->sample[t->kept / 2] / 1e3,
+            (double)t->total_ns / (double)t->frames / 1e3,
+            (double)t->max_ns / 1e3);
+    }
+}
+
+static char* read_script(const char* path) {
+    FILE* f = fopen(path, "r");
+    if(!f) return NULL;
+    size_t len = 0, cap = 4096;
+    char* buf = malloc(cap);
+    while(buf) {
+        len += fread(buf + len, 1, cap - len - 1, f);
+        if(len < cap - 1) break;
+        char* grown = realloc(buf, cap *= 2);
+        if(!grown) free(buf);
+        buf = grown;
+    }
+    fclose(f);
+    if(buf) buf[len] = '\0';
+    return buf;
+}
+
+static void usage(const char* argv0) {
+    fprintf(
+        stderr,
+        "usage: %s [-k keys|@file] [-R presses] [-r seed] [-s dir] [-S ms] [-w session] [-o dir] [-p] [-t] [-v] [-E]\n"
+        "  -k  key script: u d l r o b (Up Down Left Right OK Back), a number repeats the next key\n"
+        "  -R  random presses after the script, from the seed\n"
+        "  -r  session seed in hex, as shown on the Statistics screen (default 1)\n"
+        "  -s  directory standing in for the SD card /ext (default build/ext, or empty with -w)\n"
+        "  -S  make every storage_file_sync take this long, like a slow SD card\n"
+        "  -w  record the session for bj_replay\n"
+        "  -o  write every frame to this directory, named <frame>_<phase>.png\n"
+        "  -p  write frames as PBM instead of PNG\n"
+        "  -t  print draw_callback time per game phase\n"
+        "  -v  print app log lines and notifications\n"
+        "  -E  press every key in every phase the app waits in, and report what each did\n",
+        argv0);
+}
+
+int main(int argc, char** argv) {
+    UiRun* run = calloc(1, sizeof(UiRun));
+    FuriShimConfig config = {.seed = 1};
+    const char* storage = NULL;
+    const char* record_path = NULL;
+    Session record;
+    const char* keys = "";
+    char* script = NULL;
+    bool times = false;
+    bool enumerate = false;
+    bool walk_set = false;
+    int opt;
+    if(!run) return 1;
+    while((opt = getopt(argc, argv, "k:R:r:s:S:w:o:ptvEh")) != -1) {
+        switch(opt) {
+        case 'k':
+            keys = optarg;
+            break;
+        case 'R':
+            run->random_presses = strtoull(optarg, NULL, 10);
+            walk_set = true;
+            break;
+        case 'r':
+            config.seed = strtoull(optarg, NULL, 16);
+            break;
+        case 's':
+            storage = optarg;
+            break;
+        case 'S':
+            config.sync_delay_ms = strtoul(optarg, NULL, 10);
+            break;
+        case 'w':
+            record_path = optarg;
+            break;
+        case 'o':
+            run->frame_dir = optarg;
+            break;
+        case 'p':
+            run->pbm = true;
+            break;
+        case 't':
+            times = true;
+            break;
+        case 'v':
+            config.verbose = true;
+            break;
+        case 'E':
+            enumerate = true;
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if(keys[0] == '@') {
+        script = read_script(keys + 1);
+        if(!script) {
+            fprintf(stderr, "bj_ui: cannot read %s\n", keys + 1);
+            return 2;
+        }
+        keys = script;
+    }
+    if(enumerate && record_path) {
+        fprintf(stderr, "bj_ui: -E restores states behind the app's back, so it cannot be recorded\n");
+        return 2;
+    }
+    if(enumerate) {
+        run->enumerate = calloc(1, sizeof(UiEnum));
+        if(!walk_set) run->random_presses = UI_ENUM_WALK;
+        if(!keys[0]) keys = UI_ENUM_SCRIPT;
+    }
+    if(run->frame_dir) mkdir(run->frame_dir, 0755);
+
+    run->script = keys;
+    run->random_state = config.seed ^ 0x5DEECE66DULL;
+    config.storage_root = storage ? storage : (record_path || enumerate) ? NULL : "build/ext";
+    if(record_path) {
+        session_init(&record, config.seed);
+        run->record = &record;
+    }
+    if(!furi_shim_init(&config)) {
+        fprintf(stderr, "bj_ui: cannot create the storage directory\n");
+        return 1;
+    }
+    furi_shim_set_idle_callback(ui_idle, run);
+    furi_shim_set_frame_callback(ui_frame, run);
+    furi_shim_set_input_callback(ui_input, run);
+    if(run->enumerate) run->enumerate->priming = true;
+    blackjack_app(NULL);
+    while(run->enumerate && !run->enumerate->done) {
+        /* The last key quit the app; start it again for the rest */
+        run->enumerate->outcome[run->enumerate->last_phase][run->enumerate->last_key] |= UiKeyExit;
+        run->enumerate->priming = true;
+        run->model = NULL;
+        blackjack_app(NULL);
+    }
+
+    const FuriShimCounters* c = furi_shim_counters();
+    printf(
+        "%llu inputs, %llu frames, %llu timer fires, %llu sounds, %llu vibrations, %llu file opens, %llu syncs\n",
+        (unsigned long long)c->inputs,
+        (unsigned long long)c->frames,
+        (unsigned long long)c->timer_fires,
+        (unsigned long long)c->sounds,
+        (unsigned long long)c->vibros,
+        (unsigned long long)c->file_opens,
+        (unsigned long long)c->file_syncs);
+    if(times) {
+        print_times(run);
+        printf("slowest input callback: %.2f us\n", (double)c->input_max_ns / 1e3);
+    }
+    int status = 0;
+    if(run->enumerate && ui_enum_report(run->enumerate)) status = 1;
+    if(record_path) {
+        if(!session_write(&record, record_path)) {
+            fprintf(stderr, "bj_ui: cannot write %s\n", record_path);
+            status = 1;
+        }
+        session_free(&record);
+    }
+    furi_shim_deinit();
+    free(script);
+    free(run->enumerate);
+    free(run);
+    return status;
+}
@@ -0,0 +1,356 @@
+/**
+ * Composition-dependent solver (see cd_solve.h).
+ */
+#include "cd_solve.h"
+#include "blackjack_dealer.h"
+#include "pool.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Transposition table slots per worker (power of two); an upcard needs up to ~60000 nodes */
+#define CD_TT_BITS 18
+#define CD_TT_SIZE (1U << CD_TT_BITS)
+#define CD_TT_LOAD (CD_TT_SIZE / 4 * 3) /* Past this, nodes are computed but not stored */
+
+/* Key: card counts 4 bits per value (bits 0-39), split pair card (40-43), always-set marker */
+#define CD_KEY_MARKER (1ULL << 63)
+
+typedef struct {
+    uint64_t key; /* 0 = empty */
+    double stand; /* NAN until computed */
+    double best; /* Best of stand and hit, NAN until computed */
+} CdEntry;
+
+/* Weighted EV sums of one table cell: stand, hit, double */
+typedef struct {
+    double weight;
+    double ev[3];
+} CdCell;
+
+/* One decision composition, kept to count the ones that disagree with their cell */
+typedef struct {
+    bool soft;
+    uint8_t count_index; /* Card count - 2, as in StrategyTables */
+    uint8_t row;
+    double ev[3]; /* Double is NAN past two cards */
+} CdComp;
+
+/* Everything solved for one upcard */
+typedef struct {
+    CdCell hard[STRATEGY_COUNTS][STRATEGY_HARD_ROWS];
+    CdCell soft[STRATEGY_COUNTS][STRATEGY_SOFT_ROWS];
+    double pair_keep[STRATEGY_PAIR_ROWS];
+    double pair_split[STRATEGY_PAIR_ROWS];
+    CdComp* comp;
+    size_t comp_count;
+    size_t comp_cap;
+    uint64_t nodes;
+} CdUpcard;
+
+typedef struct {
+    bool hits_soft17;
+    CdUpcard* results; /* By upcard points - 1 */
+    DealerCache dealer;
+    DealerPaths paths;
+    ShoeCounts root; /* Full shoe less the upcard */
+    ShoeCounts shoe; /* Root less the hand (and the other card of a split pair) */
+    uint8_t hand[11];
+    uint8_t split_card;
+    CdEntry* tt;
+    uint32_t tt_used;
+} CdWorker;
+
+static uint8_t cd_value(uint8_t hard, bool ace) {
+    return (ace && hard <= 11) ? hard + 10 : hard;
+}
+
+static void cd_draw(CdWorker* w, uint8_t c, int delta) {
+    w->hand[c] += delta;
+    w->shoe.n[c] -= delta;
+    w->shoe.total -= delta;
+}
+
+/* Table entry for the current hand; once the table is full, the caller's spare is used instead */
+static CdEntry* cd_entry(CdWorker* w, CdEntry* spare) {
+    uint64_t key = CD_KEY_MARKER | ((uint64_t)w->split_card << 40);
+    for(uint8_t v = 1; v <= 10; v++) key |= (uint64_t)w->hand[v] << (4 * (v - 1));
+    uint32_t slot = (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> (64 - CD_TT_BITS));
+    CdEntry* e;
+    while(true) {
+        e = &w->tt[slot];
+        if(e->key == key) return e;
+        if(e->key == 0) break;
+        slot = (slot + 1) & (CD_TT_SIZE - 1);
+    }
+    if(w->tt_used < CD_TT_LOAD) {
+        w->tt_used++;
+        e->key = key;
+    } else {
+        e = spare;
+    }
+    e->stand = NAN;
+    e->best = NAN;
+    return e;
+}
+
+static double cd_stand_at(CdWorker* w, CdEntry* e, uint8_t v) {
+    if(isnan(e->stand)) {
+        float d[DEALER_OUTCOMES];
+        dealer_paths_outcomes(&w->paths, &w->shoe, d);
+        double ev = d[DEALER_BUST];
+        for(uint8_t t = 17; t <= 21; t++) {
+            if(v > t) ev += d[t - 17];
+            else if(v < t) ev -= d[t - 17];
+        }
+        e->stand = ev;
+    }
+    return e->stand;
+}
+
+static double cd_stand(CdWorker* w, uint8_t v) {
+    CdEntry spare;
+    return cd_stand_at(w, cd_entry(w, &spare), v);
+}
+
+static double cd_best(CdWorker* w, uint8_t hard, bool ace, uint8_t count);
+
+static double cd_hit(CdWorker* w, uint8_t hard, bool ace, uint8_t count) {
+    double ev = 0;
+    double total = w->shoe.total;
+    for(uint8_t c = 1; c <= 10; c++) {
+        if(!w->shoe.n[c]) continue;
+        double p = w->shoe.n[c] / total;
+        uint8_t h = hard + c;
+        bool a = ace || c == 1;
+        if(cd_value(h, a) > 21) {
+            ev -= p;
+        } else if(count + 1 == MAX_HAND) {
+            ev += p; /* 6 cards without busting wins */
+        } else {
+            cd_draw(w, c, 1);
+            ev += p * cd_best(w, h, a, count + 1);
+            cd_draw(w, c, -1);
+        }
+    }
+    return ev;
+}
+
+/* Best of stand and hit; drawing to hard 11 or less cannot lower the stand EV, so it always hits */
+static double cd_best(CdWorker* w, uint8_t hard, bool ace, uint8_t count) {
+    CdEntry spare;
+    CdEntry* e = cd_entry(w, &spare);
+    if(!isnan(e->best)) return e->best;
+    double best = cd_hit(w, hard, ace, count);
+    if(hard > 11 || ace) {
+        double stand = cd_stand_at(w, e, cd_value(hard, ace));
+        if(stand > best) best = stand;
+    }
+    e->best = best;
+    return best;
+}
+
+static double cd_double(CdWorker* w, uint8_t hard, bool ace) {
+    double ev = 0;
+    double total = w->shoe.total;
+    for(uint8_t c = 1; c <= 10; c++) {
+        if(!w->shoe.n[c]) continue;
+        double p = w->shoe.n[c] / total;
+        uint8_t v = cd_value(hard + c, ace || c == 1);
+        if(v > 21) {
+            ev -= p;
+        } else {
+            cd_draw(w, c, 1);
+            ev += p * cd_stand(w, v);
+            cd_draw(w, c, -1);
+        }
+    }
+    return 2 * ev;
+}
+
+/* Hand is the pair; each split hand keeps one card, draws one, then plays with doubling allowed */
+static double cd_split(CdWorker* w, uint8_t card) {
+    double ev = 0;
+    w->hand[card]--;
+    w->split_card = card;
+    double total = w->shoe.total;
+    for(uint8_t c = 1; c <= 10; c++) {
+        if(!w->shoe.n[c]) continue;
+        double p = w->shoe.n[c] / total;
+        uint8_t h = card + c;
+        bool a = card == 1 || c == 1;
+        cd_draw(w, c, 1);
+        double best = cd_best(w, h, a, 2);
+        double dbl = cd_double(w, h, a);
+        cd_draw(w, c, -1);
+        ev += p * (dbl > best ? dbl : best);
+    }
+    w->split_card = 0;
+    w->hand[card]++;
+    return 2 * ev;
+}
+
+/* Chance of being dealt the current hand from the root shoe, in any order */
+static double cd_weight(const CdWorker* w) {
+    double p = 1;
+    uint8_t drawn = 0;
+    for(uint8_t v = 1; v <= 10; v++) {
+        for(uint8_t k = 0; k < w->hand[v]; k++) {
+            drawn++;
+            /* Multinomial orders times the draw probabilities, one card at a time */
+            p *= (double)drawn / (k + 1) * (w->root.n[v] - k) / (w->root.total - drawn + 1);
+        }
+    }
+    return p;
+}
+
+static void cd_record(CdWorker* w, CdUpcard* r, uint8_t hard, bool ace, uint8_t count) {
+    bool soft = ace && hard <= 11;
+    uint8_t v = cd_value(hard, ace);
+    uint8_t c = count > 5 ? STRATEGY_COUNTS - 1 : count - 2;
+    double ev[3];
+    ev[0] = cd_stand(w, v);
+    ev[1] = cd_hit(w, hard, ace, count);
+    ev[2] = count == 2 ? cd_double(w, hard, ace) : NAN;
+    double weight = cd_weight(w);
+    uint8_t row = soft ? v - STRATEGY_SOFT_MIN : v - STRATEGY_HARD_MIN;
+    CdCell* cell = soft ? &r->soft[c][row] : &r->hard[c][row];
+    cell->weight += weight;
+    for(int i = 0; i < 3; i++) {
+        if(!isnan(ev[i])) cell->ev[i] += weight * ev[i];
+    }
+    if(count == 2 && hard % 2 == 0 && w->hand[hard / 2] == 2) {
+        double keep = ev[0] > ev[1] ? ev[0] : ev[1];
+        if(ev[2] > keep) keep = ev[2];
+        r->pair_keep[hard / 2 - 1] += weight * keep;
+        r->pair_split[hard / 2 - 1] += weight * cd_split(w, hard / 2);
+    }
+    if(r->comp_count == r->comp_cap) {
+        r->comp_cap = r->comp_cap ? r->comp_cap * 2 : 1024;
+        r->comp = realloc(r->comp, r->comp_cap * sizeof(CdComp));
+        if(!r->comp) {
+            fprintf(stderr, "cd_solve: out of memory\n");
+            exit(1);
+        }
+    }
+    CdComp* comp = &r->comp[r->comp_count++];
+    comp->soft = soft;
+    comp->count_index = c;
+    comp->row = row;
+    memcpy(comp->ev, ev, sizeof(ev));
+}
+
+/* Every multiset of 2..5 cards (values non-decreasing, so each once) that is still a decision */
+static void cd_enumerate(CdWorker* w, CdUpcard* r, uint8_t min_card, uint8_t hard, bool ace, uint8_t count) {
+    bool blackjack = count == 2 && ace && hard == 11;
+    if(count >= 2 && !blackjack) cd_record(w, r, hard, ace, count);
+    if(count == MAX_HAND - 1) return;
+    for(uint8_t c = min_card; c <= 10; c++) {
+        if(hard + c > 21) break;
+        if(!w->shoe.n[c]) continue;
+        cd_draw(w, c, 1);
+        cd_enumerate(w, r, c, hard + c, ace || c == 1, count + 1);
+        cd_draw(w, c, -1);
+    }
+}
+
+static void cd_solve_upcard(void* ctx, uint64_t task) {
+    CdWorker* w = ctx;
+    uint8_t up = (uint8_t)(task + 1);
+    CdUpcard* r = &w->results[task];
+    memset(w->tt, 0, sizeof(CdEntry) * CD_TT_SIZE);
+    w->tt_used = 0;
+    dealer_cache_init(&w->dealer);
+    dealer_cache_set_rule(&w->dealer, w->hits_soft17);
+    if(!dealer_cache_paths(&w->dealer, up, &w->paths)) {
+        fprintf(stderr, "cd_solve: out of memory\n");
+        exit(1);
+    }
+    shoe_counts_full(&w->root);
+    w->root.n[up]--;
+    w->root.total--;
+    w->shoe = w->root;
+    memset(w->hand, 0, sizeof(w->hand));
+    w->split_card = 0;
+    cd_enumerate(w, r, 1, 0, false, 0);
+    r->nodes = w->tt_used;
+}
+
+/* Same cell choice as the infinite-deck generator, from summed EVs */
+static uint8_t cd_cell(const CdCell* cell, bool can_double) {
+    double stand = cell->ev[0];
+    double hit = cell->ev[1];
+    if(can_double && cell->ev[2] > (hit > stand ? hit : stand)) {
+        return hit > stand ? STRATEGY_CELL_DOUBLE_HIT : STRATEGY_CELL_DOUBLE_STAND;
+    }
+    return hit > stand ? STRATEGY_CELL_HIT : STRATEGY_CELL_STAND;
+}
+
+static void cd_set(uint32_t* row, uint8_t col, uint8_t cell) {
+    *row = (*row & ~(3U << (col * 2))) | ((uint32_t)cell << (col * 2));
+}
+
+/* Action a cell gives, against the composition's own best */
+static bool cd_disagrees(const CdComp* comp, uint8_t cell) {
+    bool can_double = comp->count_index == 0;
+    uint8_t own;
+    double keep = comp->ev[1] > comp->ev[0] ? comp->ev[1] : comp->ev[0];
+    if(can_double && comp->ev[2] > keep) own = StrategyDouble;
+    else own = comp->ev[1] > comp->ev[0] ? StrategyHit : StrategyStand;
+    uint8_t table;
+    if(cell >= STRATEGY_CELL_DOUBLE_HIT && can_double) table = StrategyDouble;
+    else if(cell == STRATEGY_CELL_HIT || cell == STRATEGY_CELL_DOUBLE_HIT) table = StrategyHit;
+    else table = StrategyStand;
+    return own != table;
+}
+
+void cd_solve(StrategyTables* t, bool hits_soft17, unsigned threads, CdSolveStats* stats) {
+    CdUpcard* results = calloc(10, sizeof(CdUpcard));
+    CdWorker** workers = calloc(threads, sizeof(CdWorker*));
+    if(!results || !workers) {
+        fprintf(stderr, "cd_solve: out of memory\n");
+        exit(1);
+    }
+    for(unsigned i = 0; i < threads; i++) {
+        workers[i] = calloc(1, sizeof(CdWorker));
+        if(!workers[i] || !(workers[i]->tt = malloc(sizeof(CdEntry) * CD_TT_SIZE))) {
+            fprintf(stderr, "cd_solve: out of memory\n");
+            exit(1);
+        }
+        workers[i]->hits_soft17 = hits_soft17;
+        workers[i]->results = results;
+    }
+    pool_run(10, threads, cd_solve_upcard, (void* const*)workers);
+
+    memset(stats, 0, sizeof(*stats));
+    for(uint8_t up = 1; up <= 10; up++) {
+        CdUpcard* r = &results[up - 1];
+        uint8_t col = up == 1 ? 9 : up - 2;
+        for(int c = 0; c < STRATEGY_COUNTS; c++) {
+            for(int row = 0; row < STRATEGY_HARD_ROWS; row++) {
+                if(r->hard[c][row].weight > 0) cd_set(&t->hard[c][row], col, cd_cell(&r->hard[c][row], c == 0));
+            }
+            for(int row = 0; row < STRATEGY_SOFT_ROWS; row++) {
+                if(r->soft[c][row].weight > 0) cd_set(&t->soft[c][row], col, cd_cell(&r->soft[c][row], c == 0));
+            }
+        }
+        for(int row = 0; row < STRATEGY_PAIR_ROWS; row++) {
+            cd_set(&t->pairs[row], col, r->pair_split[row] > r->pair_keep[row] ? 1 : 0);
+        }
+        for(size_t i = 0; i < r->comp_count; i++) {
+            const CdComp* comp = &r->comp[i];
+            uint32_t row = comp->soft ? t->soft[comp->count_index][comp->row] : t->hard[comp->count_index][comp->row];
+            if(cd_disagrees(comp, strategy_cell(row, col))) stats->exceptions++;
+        }
+        stats->compositions += r->comp_count;
+        stats->nodes += r->nodes;
+        free(r->comp);
+    }
+    for(unsigned i = 0; i < threads; i++) {
+        free(workers[i]->tt);
+        free(workers[i]);
+    }
+    free(workers);
+    free(results);
+}
@@ -0,0 +1,23 @@
+/**
+ * Exact composition-dependent strategy solver.
+ * For each dealer upcard, computes the EV of stand / hit / double / split for every player card
+ * composition against the full DECKS-deck shoe less the upcard and the player's cards, under the
+ * engine's rules (see blackjack_strategy.h). Subtrees are shared through a transposition table
+ * keyed by the hand's rank-count vector; upcards are solved in parallel on the host pool.
+ *
+ * The device tables are indexed by total and card count, not composition, so each cell then
+ * takes the action with the best EV summed over the compositions that land in it, weighted by
+ * their chance of being dealt.
+ */
+#pragma once
+
+#include "blackjack_strategy.h"
+
+typedef struct {
+    uint64_t compositions; /* Player hands at a decision, over all upcards */
+    uint64_t nodes; /* Transposition table entries created */
+    uint64_t exceptions; /* Compositions whose own best play differs from their cell */
+} CdSolveStats;
+
+/* Overwrite every cell some composition reaches; unreachable cells keep what t holds */
+void cd_solve(StrategyTables* t, bool hits_soft17, unsigned threads, CdSolveStats* stats);
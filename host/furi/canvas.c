@@ -0,0 +1,361 @@
+/**
+ * 128x64 1-bit canvas for the host shim, with PBM and PNG output (see furi_shim.h).
+ */
+#include "furi_shim.h"
+#include <stdio.h>
+#include <string.h>
+
+struct Canvas {
+    uint8_t fb[CANVAS_HEIGHT][CANVAS_WIDTH / 8]; /* 1 = black, most significant bit leftmost */
+    Color color;
+    Font font;
+};
+
+/* 5x7 glyphs for ASCII 32-126, one byte per column, bit 0 on top, bit 7 the descender row */
+static const uint8_t font5x7[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x08, 0x07, 0x03, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+    {0x00, 0x80, 0x70, 0x30, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x00, 0x60, 0x60, 0x00},
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x00, 0x14, 0x00, 0x00},
+    {0x00, 0x40, 0x34, 0x00, 0x00}, {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x59, 0x09, 0x06}, {0x3E, 0x41, 0x5D, 0x59, 0x4E},
+    {0x7C, 0x12, 0x11, 0x12, 0x7C}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x7F, 0x41, 0x41, 0x41, 0x3E}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+    {0x3E, 0x41, 0x41, 0x51, 0x73}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+    {0x7F, 0x02, 0x1C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+    {0x26, 0x49, 0x49, 0x49, 0x32}, {0x03, 0x01, 0x7F, 0x01, 0x03}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+    {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x59, 0x49, 0x4D, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x41},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x41, 0x7F}, {0x04, 0x02, 0x01, 0x02, 0x04},
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x03, 0x07, 0x08, 0x00}, {0x20, 0x54, 0x54, 0x78, 0x40},
+    {0x7F, 0x28, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x28}, {0x38, 0x44, 0x44, 0x28, 0x7F},
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x00, 0x08, 0x7E, 0x09, 0x02}, {0x18, 0xA4, 0xA4, 0x9C, 0x78},
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x40, 0x3D, 0x00},
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x78, 0x04, 0x78},
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0xFC, 0x18, 0x24, 0x24, 0x18},
+    {0x18, 0x24, 0x24, 0x18, 0xFC}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x24},
+    {0x04, 0x04, 0x3F, 0x44, 0x24}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x4C, 0x90, 0x90, 0x90, 0x7C},
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x77, 0x00, 0x00},
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x02, 0x01, 0x02, 0x04, 0x02},
+};
+
+#define GLYPH_ROWS 8
+#define GLYPH_ASCENT 7 /* Rows above the baseline */
+
+Canvas* canvas_shim_alloc(void) {
+    Canvas* canvas = calloc(1, sizeof(Canvas));
+    if(canvas) canvas_shim_reset(canvas);
+    return canvas;
+}
+
+void canvas_shim_free(Canvas* canvas) {
+    free(canvas);
+}
+
+void canvas_shim_reset(Canvas* canvas) {
+    canvas_clear(canvas);
+    canvas->color = ColorBlack;
+    canvas->font = FontSecondary;
+}
+
+bool canvas_shim_pixel(const Canvas* canvas, int32_t x, int32_t y) {
+    if(x < 0 || y < 0 || x >= CANVAS_WIDTH || y >= CANVAS_HEIGHT) return false;
+    return canvas->fb[y][x / 8] & (0x80 >> (x % 8));
+}
+
+size_t canvas_width(const Canvas* canvas) {
+    UNUSED(canvas);
+    return CANVAS_WIDTH;
+}
+
+size_t canvas_height(const Canvas* canvas) {
+    UNUSED(canvas);
+    return CANVAS_HEIGHT;
+}
+
+void canvas_clear(Canvas* canvas) {
+    memset(canvas->fb, 0, sizeof(canvas->fb));
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    canvas->color = color;
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    canvas->font = font;
+}
+
+/* Apply the current color to the pixels of one framebuffer byte set in mask */
+static void draw_mask(Canvas* canvas, uint8_t* byte, uint8_t mask) {
+    if(canvas->color == ColorBlack) {
+        *byte |= mask;
+    } else if(canvas->color == ColorWhite) {
+        *byte &= ~mask;
+    } else {
+        *byte ^= mask;
+    }
+}
+
+void canvas_draw_dot(Canvas* canvas, int32_t x, int32_t y) {
+    if(x < 0 || y < 0 || x >= CANVAS_WIDTH || y >= CANVAS_HEIGHT) return;
+    draw_mask(canvas, &canvas->fb[y][x / 8], 0x80 >> (x % 8));
+}
+
+/* Horizontal run, a byte at a time as u8g2 fills its page buffer */
+static void draw_span(Canvas* canvas, int32_t x, int32_t y, int32_t width) {
+    if(y < 0 || y >= CANVAS_HEIGHT) return;
+    if(x < 0) {
+        width += x;
+        x = 0;
+    }
+    if(x + width > CANVAS_WIDTH) width = CANVAS_WIDTH - x;
+    while(width > 0) {
+        int32_t bit = x % 8, n = 8 - bit < width ? 8 - bit : width;
+        draw_mask(canvas, &canvas->fb[y][x / 8], (uint8_t)((0xFF >> bit) & ~(0xFF >> (bit + n))));
+        x += n;
+        width -= n;
+    }
+}
+
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    int32_t dx = x2 > x1 ? x2 - x1 : x1 - x2;
+    int32_t dy = y2 > y1 ? y1 - y2 : y2 - y1;
+    int32_t sx = x1 < x2 ? 1 : -1;
+    int32_t sy = y1 < y2 ? 1 : -1;
+    int32_t err = dx + dy;
+    for(;;) {
+        canvas_draw_dot(canvas, x1, y1);
+        if(x1 == x2 && y1 == y2) break;
+        int32_t e2 = 2 * err;
+        if(e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if(e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    for(size_t j = 0; j < height; j++) draw_span(canvas, x, y + (int32_t)j, (int32_t)width);
+}
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    if(!width || !height) return;
+    int32_t x2 = x + (int32_t)width - 1, y2 = y + (int32_t)height - 1;
+    for(int32_t i = x; i <= x2; i++) {
+        canvas_draw_dot(canvas, i, y);
+        if(y2 != y) canvas_draw_dot(canvas, i, y2);
+    }
+    for(int32_t j = y + 1; j < y2; j++) {
+        canvas_draw_dot(canvas, x, j);
+        if(x2 != x) canvas_draw_dot(canvas, x2, j);
+    }
+}
+
+/* Midpoint circle, as u8g2 draws it; filled draws spans instead of the eight octant points */
+static void draw_circle(Canvas* canvas, int32_t x0, int32_t y0, int32_t r, bool filled) {
+    int32_t f = 1 - r, ddx = 1, ddy = -2 * r, x = 0, y = r;
+    while(x <= y) {
+        if(filled) {
+            for(int32_t i = x0 - x; i <= x0 + x; i++) {
+                canvas_draw_dot(canvas, i, y0 + y);
+                if(y) canvas_draw_dot(canvas, i, y0 - y);
+            }
+            for(int32_t i = x0 - y; i <= x0 + y; i++) {
+                canvas_draw_dot(canvas, i, y0 + x);
+                if(x) canvas_draw_dot(canvas, i, y0 - x);
+            }
+        } else {
+            canvas_draw_dot(canvas, x0 + x, y0 + y);
+            canvas_draw_dot(canvas, x0 - x, y0 + y);
+            canvas_draw_dot(canvas, x0 + x, y0 - y);
+            canvas_draw_dot(canvas, x0 - x, y0 - y);
+            canvas_draw_dot(canvas, x0 + y, y0 + x);
+            canvas_draw_dot(canvas, x0 - y, y0 + x);
+            canvas_draw_dot(canvas, x0 + y, y0 - x);
+            canvas_draw_dot(canvas, x0 - y, y0 - x);
+        }
+        if(f >= 0) {
+            y--;
+            ddy += 2;
+            f += ddy;
+        }
+        x++;
+        ddx += 2;
+        f += ddx;
+    }
+}
+
+void canvas_draw_circle(Canvas* canvas, int32_t x, int32_t y, size_t radius) {
+    draw_circle(canvas, x, y, (int32_t)radius, false);
+}
+
+void canvas_draw_disc(Canvas* canvas, int32_t x, int32_t y, size_t radius) {
+    draw_circle(canvas, x, y, (int32_t)radius, true);
+}
+
+/* Set bits only, like the firmware; a byte of the bitmap at a time when it lies fully on screen */
+void canvas_draw_xbm(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height, const uint8_t* bitmap) {
+    size_t stride = (width + 7) / 8;
+    bool inside = x >= 0 && x + (int32_t)width <= CANVAS_WIDTH;
+    for(size_t j = 0; j < height; j++, bitmap += stride) {
+        int32_t py = y + (int32_t)j;
+        if(py < 0 || py >= CANVAS_HEIGHT) continue;
+        for(size_t k = 0; k < stride; k++) {
+            uint8_t b = bitmap[k];
+            size_t left = width - k * 8;
+            if(left < 8) b &= (uint8_t)((1 << left) - 1);
+            if(!b) continue;
+            int32_t px = x + (int32_t)k * 8;
+            if(!inside) {
+                for(int i = 0; i < 8; i++) {
+                    if(b & (1 << i)) canvas_draw_dot(canvas, px + i, py);
+                }
+                continue;
+            }
+            /* XBM is least significant bit leftmost, the framebuffer most significant */
+            uint8_t r = (uint8_t)(((b * 0x0802u & 0x22110u) | (b * 0x8020u & 0x88440u)) * 0x10101u >> 16);
+            int shift = px % 8;
+            draw_mask(canvas, &canvas->fb[py][px / 8], r >> shift);
+            if(shift && (r << (8 - shift)) & 0xFF) draw_mask(canvas, &canvas->fb[py][px / 8 + 1], (uint8_t)(r << (8 - shift)));
+        }
+    }
+}
+
+/* Pixels per glyph column and horizontal advance by font */
+static int font_scale(Font font) {
+    return font == FontBigNumbers ? 2 : 1;
+}
+
+static int font_advance(Font font) {
+    return font == FontPrimary ? 7 : 6 * font_scale(font);
+}
+
+uint16_t canvas_string_width(Canvas* canvas, const char* str) {
+    size_t len = strlen(str);
+    if(!len) return 0;
+    /* No spacing after the last glyph */
+    return (uint16_t)(len * font_advance(canvas->font) - font_scale(canvas->font));
+}
+
+static void draw_glyph(Canvas* canvas, int32_t x, int32_t y, char c) {
+    if(c < 32 || c > 126) c = '?';
+    const uint8_t* g = font5x7[c - 32];
+    int scale = font_scale(canvas->font);
+    bool bold = canvas->font == FontPrimary;
+    int32_t top = y - GLYPH_ASCENT * scale;
+    for(int col = 0; col < 5; col++) {
+        for(int row = 0; row < GLYPH_ROWS; row++) {
+            if(!(g[col] & (1 << row))) continue;
+            for(int sy = 0; sy < scale; sy++) {
+                for(int sx = 0; sx < scale; sx++) {
+                    int32_t px = x + col * scale + sx, py = top + row * scale + sy;
+                    canvas_draw_dot(canvas, px, py);
+                    /* Bold: smear right unless the next column already has this pixel, so XOR stays clean */
+                    if(bold && (col == 4 || !(g[col + 1] & (1 << row)))) canvas_draw_dot(canvas, px + 1, py);
+                }
+            }
+        }
+    }
+}
+
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    for(; *str; str++, x += font_advance(canvas->font)) draw_glyph(canvas, x, y, *str);
+}
+
+void canvas_draw_str_aligned(Canvas* canvas, int32_t x, int32_t y, Align horizontal, Align vertical, const char* str) {
+    int32_t w = canvas_string_width(canvas, str);
+    int32_t h = GLYPH_ASCENT * font_scale(canvas->font);
+    if(horizontal == AlignRight) x -= w;
+    else if(horizontal == AlignCenter) x -= w / 2;
+    if(vertical == AlignTop) y += h;
+    else if(vertical == AlignCenter) y += h / 2;
+    canvas_draw_str(canvas, x, y, str);
+}
+
+bool canvas_shim_write_pbm(const Canvas* canvas, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if(!f) return false;
+    fprintf(f, "P4\n%d %d\n", CANVAS_WIDTH, CANVAS_HEIGHT);
+    fwrite(canvas->fb, 1, sizeof(canvas->fb), f);
+    return fclose(f) == 0;
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t* p, size_t n) {
+    crc = ~crc;
+    while(n--) {
+        crc ^= *p++;
+        for(int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void png_chunk(FILE* f, const char* type, const uint8_t* data, uint32_t len) {
+    uint8_t head[8];
+    put_be32(head, len);
+    memcpy(head + 4, type, 4);
+    fwrite(head, 1, 8, f);
+    if(len) fwrite(data, 1, len, f);
+    uint32_t crc = crc32_update(crc32_update(0, (const uint8_t*)type, 4), data, len);
+    put_be32(head, crc);
+    fwrite(head, 1, 4, f);
+}
+
+/* 1-bit grayscale, one stored (uncompressed) deflate block: the frame is only 1 KB */
+bool canvas_shim_write_png(const Canvas* canvas, const char* path) {
+    enum { ROW = 1 + CANVAS_WIDTH / 8, RAW = ROW * CANVAS_HEIGHT };
+    uint8_t raw[RAW];
+    for(int y = 0; y < CANVAS_HEIGHT; y++) {
+        raw[y * ROW] = 0; /* Filter: none */
+        /* PNG gray 0 is black, the framebuffer's 1 is black */
+        for(int i = 0; i < CANVAS_WIDTH / 8; i++) raw[y * ROW + 1 + i] = (uint8_t)~canvas->fb[y][i];
+    }
+    uint8_t z[2 + 5 + RAW + 4];
+    z[0] = 0x78;
+    z[1] = 0x01;
+    z[2] = 1; /* Final block, stored */
+    z[3] = RAW & 0xFF;
+    z[4] = RAW >> 8;
+    z[5] = (uint8_t)~z[3];
+    z[6] = (uint8_t)~z[4];
+    memcpy(z + 7, raw, RAW);
+    uint32_t a = 1, b = 0;
+    for(int i = 0; i < RAW; i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    put_be32(z + 7 + RAW, (b << 16) | a);
+
+    uint8_t ihdr[13];
+    put_be32(ihdr, CANVAS_WIDTH);
+    put_be32(ihdr + 4, CANVAS_HEIGHT);
+    ihdr[8] = 1; /* Bit depth */
+    ihdr[9] = 0; /* Grayscale */
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;
+
+    FILE* f = fopen(path, "wb");
+    if(!f) return false;
+    fwrite("\x89PNG\r\n\x1a\n", 1, 8, f);
+    png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    png_chunk(f, "IDAT", z, sizeof(z));
+    png_chunk(f, "IEND", NULL, 0);
+    return fclose(f) == 0;
+}
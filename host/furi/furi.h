@@ -0,0 +1,90 @@
+/**
+ * Host stand-in for the firmware's furi.h: records, ticks, logging, timers, and threads,
+ * message queues and mutexes on pthreads.
+ * Only what the app uses; see furi_shim.h for the harness side.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define UNUSED(x) (void)(x)
+
+/* The SD card; furi_shim maps it to a host directory */
+#define EXT_PATH(path) "/ext/" path
+
+#define RECORD_GUI "gui"
+#define RECORD_STORAGE "storage"
+#define RECORD_NOTIFICATION "notification"
+
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+/* Milliseconds since the shim started */
+uint32_t furi_get_tick(void);
+#define furi_ms_to_ticks(ms) ((uint32_t)(ms))
+
+void furi_log_print(char level, const char* tag, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+#define FURI_LOG_E(tag, ...) furi_log_print('E', tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) furi_log_print('W', tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) furi_log_print('I', tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) furi_log_print('D', tag, __VA_ARGS__)
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+    FuriStatusErrorResource = -3,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+/* Threads: a real pthread each; stack_size is ignored */
+typedef struct FuriThread FuriThread;
+typedef int32_t (*FuriThreadCallback)(void* context);
+
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+int32_t furi_thread_get_return_code(FuriThread* thread);
+
+/* Fixed-size message queue; timeouts are in ticks (milliseconds) */
+typedef struct FuriMessageQueue FuriMessageQueue;
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* queue);
+FuriStatus furi_message_queue_put(FuriMessageQueue* queue, const void* msg, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* queue, void* msg, uint32_t timeout);
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue);
+
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+typedef struct FuriMutex FuriMutex;
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+
+/* Timers run in virtual time on the view dispatcher's thread: while one is running,
+ * view_dispatcher_run fires it before taking the next input, as if the player waited for it */
+typedef struct FuriTimer FuriTimer;
+typedef void (*FuriTimerCallback)(void* context);
+
+typedef enum {
+    FuriTimerTypeOnce,
+    FuriTimerTypePeriodic,
+} FuriTimerType;
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context);
+void furi_timer_free(FuriTimer* instance);
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer* instance);
+uint32_t furi_timer_is_running(FuriTimer* instance);
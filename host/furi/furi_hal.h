@@ -0,0 +1,21 @@
+/**
+ * Host stand-in for furi_hal.h: the hardware RNG, replaced by a seeded stream, and the
+ * Cortex-M4 cycle counter, run from the host clock at the device's 64 MHz.
+ */
+#pragma once
+
+#include <furi.h>
+
+uint32_t furi_hal_random_get(void);
+
+#define FURI_SHIM_CPU_MHZ 64
+
+/* DWT->CYCCNT reads the counter; every use of DWT refreshes it */
+typedef struct {
+    uint32_t CYCCNT;
+} FuriShimDwt;
+
+FuriShimDwt* furi_shim_dwt(void);
+#define DWT (furi_shim_dwt())
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
@@ -0,0 +1,601 @@
+/**
+ * Host Furi shim: records, views, the view dispatcher loop, storage and notifications
+ * (see furi_shim.h).
+ */
+#define _XOPEN_SOURCE 700 /* nftw */
+#include "furi_shim.h"
+#include <furi_hal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHIM_QUEUE 256
+#define SHIM_PATH_MAX 512
+#define SHIM_VIEWS 8
+#define SHIM_EVENTS 16
+
+struct View {
+    ViewDrawCallback draw;
+    ViewInputCallback input;
+    void* context;
+    ViewModelType model_type;
+    void* model;
+    bool locked;
+    bool update; /* Redraw once the current event is handled */
+};
+
+struct ViewDispatcher {
+    View* views[SHIM_VIEWS];
+    uint32_t current;
+    bool running;
+    ViewDispatcherCustomEventCallback custom_cb;
+    void* event_ctx;
+    pthread_mutex_t event_lock; /* Custom events may come from FuriThreads */
+    uint32_t events[SHIM_EVENTS];
+    size_t event_head, event_count;
+};
+
+struct FuriTimer {
+    FuriTimerCallback callback;
+    FuriTimerType type;
+    void* context;
+    uint32_t period;
+    uint64_t deadline; /* Virtual milliseconds */
+    bool running;
+    FuriTimer* next;
+};
+
+struct File {
+    FILE* f;
+};
+
+struct Gui {
+    Canvas* canvas;
+};
+
+static struct {
+    FuriShimConfig config;
+    char storage_root[SHIM_PATH_MAX];
+    bool storage_temporary;
+    uint64_t rng;
+    bool rng_started;
+    struct timespec start;
+    InputEvent queue[SHIM_QUEUE];
+    size_t head, count;
+    uint32_t sequence;
+    FuriShimFrameCallback frame_cb;
+    void* frame_ctx;
+    FuriShimIdleCallback idle_cb;
+    void* idle_ctx;
+    FuriShimInputCallback input_cb;
+    void* input_ctx;
+    FuriShimCounters counters;
+    Gui gui;
+    View* shown; /* The view the running dispatcher shows; NULL outside view_dispatcher_run */
+    FuriTimer* timers; /* Every allocated timer */
+    uint64_t timer_now; /* Virtual milliseconds: the deadline of the last timer fired */
+} shim;
+
+/* Records are singletons; only the GUI holds state */
+static int storage_record, notification_record;
+
+static uint64_t shim_now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+static void mkdir_parents(const char* path) {
+    char buf[SHIM_PATH_MAX];
+    snprintf(buf, sizeof(buf), "%s", path);
+    for(char* p = buf + 1; *p; p++) {
+        if(*p != '/') continue;
+        *p = '\0';
+        mkdir(buf, 0755);
+        *p = '/';
+    }
+    mkdir(buf, 0755);
+}
+
+bool furi_shim_init(const FuriShimConfig* config) {
+    furi_shim_deinit();
+    shim.config = *config;
+    if(config->storage_root) {
+        snprintf(shim.storage_root, sizeof(shim.storage_root), "%s", config->storage_root);
+        mkdir_parents(shim.storage_root);
+    } else {
+        const char* tmp = getenv("TMPDIR");
+        snprintf(shim.storage_root, sizeof(shim.storage_root), "%s/furi_shim.XXXXXX", tmp ? tmp : "/tmp");
+        if(!mkdtemp(shim.storage_root)) return false;
+        shim.storage_temporary = true;
+    }
+    shim.config.storage_root = shim.storage_root;
+    shim.rng = config->seed;
+    clock_gettime(CLOCK_MONOTONIC, &shim.start);
+    shim.gui.canvas = canvas_shim_alloc();
+    return shim.gui.canvas != NULL;
+}
+
+static int remove_entry(const char* path, const struct stat* st, int flag, struct FTW* ftw) {
+    UNUSED(st);
+    UNUSED(flag);
+    UNUSED(ftw);
+    return remove(path);
+}
+
+void furi_shim_deinit(void) {
+    canvas_shim_free(shim.gui.canvas);
+    if(shim.storage_temporary) nftw(shim.storage_root, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    memset(&shim, 0, sizeof(shim));
+}
+
+void furi_shim_push_input(InputKey key, InputType type) {
+    if(shim.count == SHIM_QUEUE) {
+        fprintf(stderr, "furi_shim: input queue full, event dropped\n");
+        return;
+    }
+    InputEvent* e = &shim.queue[(shim.head + shim.count++) % SHIM_QUEUE];
+    e->sequence = ++shim.sequence;
+    e->key = key;
+    e->type = type;
+}
+
+void furi_shim_press(InputKey key) {
+    furi_shim_push_input(key, InputTypePress);
+    furi_shim_push_input(key, InputTypeShort);
+    furi_shim_push_input(key, InputTypeRelease);
+}
+
+size_t furi_shim_pending_inputs(void) {
+    return shim.count;
+}
+
+void furi_shim_set_frame_callback(FuriShimFrameCallback callback, void* context) {
+    shim.frame_cb = callback;
+    shim.frame_ctx = context;
+}
+
+void furi_shim_set_idle_callback(FuriShimIdleCallback callback, void* context) {
+    shim.idle_cb = callback;
+    shim.idle_ctx = context;
+}
+
+void furi_shim_set_input_callback(FuriShimInputCallback callback, void* context) {
+    shim.input_cb = callback;
+    shim.input_ctx = context;
+}
+
+const FuriShimCounters* furi_shim_counters(void) {
+    return &shim.counters;
+}
+
+/* furi.h */
+
+void* furi_record_open(const char* name) {
+    if(strcmp(name, RECORD_GUI) == 0) return &shim.gui;
+    if(strcmp(name, RECORD_STORAGE) == 0) return &storage_record;
+    if(strcmp(name, RECORD_NOTIFICATION) == 0) return &notification_record;
+    fprintf(stderr, "furi_shim: unknown record %s\n", name);
+    abort();
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+uint32_t furi_get_tick(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)((t.tv_sec - shim.start.tv_sec) * 1000 + (t.tv_nsec - shim.start.tv_nsec) / 1000000);
+}
+
+void furi_log_print(char level, const char* tag, const char* format, ...) {
+    if(!shim.config.verbose) return;
+    va_list ap;
+    va_start(ap, format);
+    fprintf(stderr, "%u [%c][%s] ", furi_get_tick(), level, tag);
+    vfprintf(stderr, format, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+FuriShimDwt* furi_shim_dwt(void) {
+    static FuriShimDwt dwt;
+    dwt.CYCCNT = (uint32_t)(shim_now_ns() * FURI_SHIM_CPU_MHZ / 1000);
+    return &dwt;
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return FURI_SHIM_CPU_MHZ;
+}
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
+    FuriTimer* timer = calloc(1, sizeof(FuriTimer));
+    timer->callback = func;
+    timer->type = type;
+    timer->context = context;
+    timer->next = shim.timers;
+    shim.timers = timer;
+    return timer;
+}
+
+void furi_timer_free(FuriTimer* instance) {
+    for(FuriTimer** p = &shim.timers; *p; p = &(*p)->next) {
+        if(*p == instance) {
+            *p = instance->next;
+            break;
+        }
+    }
+    free(instance);
+}
+
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks) {
+    instance->period = ticks;
+    instance->deadline = shim.timer_now + ticks;
+    instance->running = true;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer* instance) {
+    instance->running = false;
+    return FuriStatusOk;
+}
+
+uint32_t furi_timer_is_running(FuriTimer* instance) {
+    return instance->running;
+}
+
+/* Fire the running timer due first, moving virtual time to its deadline; false if none runs */
+static bool shim_fire_timer(void) {
+    FuriTimer* due = NULL;
+    for(FuriTimer* timer = shim.timers; timer; timer = timer->next) {
+        if(timer->running && (!due || timer->deadline < due->deadline)) due = timer;
+    }
+    if(!due) return false;
+    shim.timer_now = due->deadline;
+    if(due->type == FuriTimerTypePeriodic) {
+        due->deadline += due->period ? due->period : 1;
+    } else {
+        due->running = false;
+    }
+    shim.counters.timer_fires++;
+    due->callback(due->context);
+    return true;
+}
+
+/* The first draw is the seed itself, so the app's session seed is the one the harness chose */
+uint32_t furi_hal_random_get(void) {
+    if(!shim.rng_started) {
+        shim.rng_started = true;
+        return (uint32_t)shim.config.seed;
+    }
+    uint64_t z = (shim.rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+/* gui/view.h */
+
+View* view_alloc(void) {
+    return calloc(1, sizeof(View));
+}
+
+void view_free(View* view) {
+    if(!view) return;
+    free(view->model);
+    free(view);
+}
+
+void view_set_draw_callback(View* view, ViewDrawCallback callback) {
+    view->draw = callback;
+}
+
+void view_set_input_callback(View* view, ViewInputCallback callback) {
+    view->input = callback;
+}
+
+void view_set_context(View* view, void* context) {
+    view->context = context;
+}
+
+void view_allocate_model(View* view, ViewModelType type, size_t size) {
+    free(view->model);
+    view->model_type = type;
+    view->model = type == ViewModelTypeNone ? NULL : calloc(1, size);
+}
+
+void* view_get_model(View* view) {
+    if(view->model_type == ViewModelTypeLocking) {
+        if(view->locked) {
+            fprintf(stderr, "furi_shim: view_get_model on a model that is still locked\n");
+            abort();
+        }
+        view->locked = true;
+    }
+    return view->model;
+}
+
+void view_commit_model(View* view, bool update) {
+    if(view->model_type == ViewModelTypeLocking) {
+        if(!view->locked) {
+            fprintf(stderr, "furi_shim: view_commit_model without view_get_model\n");
+            abort();
+        }
+        view->locked = false;
+    }
+    if(update) view->update = true;
+}
+
+/* gui/view_dispatcher.h */
+
+ViewDispatcher* view_dispatcher_alloc(void) {
+    ViewDispatcher* view_dispatcher = calloc(1, sizeof(ViewDispatcher));
+    if(view_dispatcher) pthread_mutex_init(&view_dispatcher->event_lock, NULL);
+    return view_dispatcher;
+}
+
+void view_dispatcher_free(ViewDispatcher* view_dispatcher) {
+    pthread_mutex_destroy(&view_dispatcher->event_lock);
+    free(view_dispatcher);
+}
+
+void view_dispatcher_add_view(ViewDispatcher* view_dispatcher, uint32_t view_id, View* view) {
+    if(view_id < SHIM_VIEWS) view_dispatcher->views[view_id] = view;
+}
+
+void view_dispatcher_remove_view(ViewDispatcher* view_dispatcher, uint32_t view_id) {
+    if(view_id < SHIM_VIEWS) view_dispatcher->views[view_id] = NULL;
+}
+
+void view_dispatcher_switch_to_view(ViewDispatcher* view_dispatcher, uint32_t view_id) {
+    view_dispatcher->current = view_id;
+    if(view_id < SHIM_VIEWS && view_dispatcher->views[view_id]) view_dispatcher->views[view_id]->update = true;
+}
+
+void view_dispatcher_attach_to_gui(ViewDispatcher* view_dispatcher, Gui* gui, ViewDispatcherType type) {
+    UNUSED(view_dispatcher);
+    UNUSED(gui);
+    UNUSED(type);
+}
+
+/* As the GUI thread does: reset the canvas, lock the model, draw */
+static void shim_draw(View* view) {
+    view->update = false;
+    if(!view->draw) return;
+    if(shim.config.skip_draw) {
+        shim.counters.frames++;
+        return;
+    }
+    Canvas* canvas = shim.gui.canvas;
+    void* model = view_get_model(view);
+    canvas_shim_reset(canvas);
+    uint64_t t0 = shim_now_ns();
+    view->draw(canvas, model);
+    uint64_t ns = shim_now_ns() - t0;
+    shim.counters.frames++;
+    if(shim.frame_cb) shim.frame_cb(canvas, model, ns, shim.frame_ctx);
+    view_commit_model(view, false);
+}
+
+void view_dispatcher_set_event_callback_context(ViewDispatcher* view_dispatcher, void* context) {
+    view_dispatcher->event_ctx = context;
+}
+
+void view_dispatcher_set_custom_event_callback(ViewDispatcher* view_dispatcher, ViewDispatcherCustomEventCallback callback) {
+    view_dispatcher->custom_cb = callback;
+}
+
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event) {
+    pthread_mutex_lock(&view_dispatcher->event_lock);
+    if(view_dispatcher->event_count == SHIM_EVENTS) {
+        fprintf(stderr, "furi_shim: custom event queue full, event dropped\n");
+    } else {
+        view_dispatcher->events[(view_dispatcher->event_head + view_dispatcher->event_count++) % SHIM_EVENTS] = event;
+    }
+    pthread_mutex_unlock(&view_dispatcher->event_lock);
+}
+
+/* Take the oldest custom event; false if there is none */
+static bool shim_next_custom_event(ViewDispatcher* view_dispatcher, uint32_t* event) {
+    pthread_mutex_lock(&view_dispatcher->event_lock);
+    bool any = view_dispatcher->event_count > 0;
+    if(any) {
+        *event = view_dispatcher->events[view_dispatcher->event_head];
+        view_dispatcher->event_head = (view_dispatcher->event_head + 1) % SHIM_EVENTS;
+        view_dispatcher->event_count--;
+    }
+    pthread_mutex_unlock(&view_dispatcher->event_lock);
+    return any;
+}
+
+static void shim_check_unlocked(const View* view, const char* callback) {
+    if(view->locked) {
+        fprintf(stderr, "furi_shim: %s callback returned with the model locked\n", callback);
+        abort();
+    }
+}
+
+void view_dispatcher_run(ViewDispatcher* view_dispatcher) {
+    view_dispatcher->running = true;
+    while(view_dispatcher->running) {
+        View* view = view_dispatcher->current < SHIM_VIEWS ? view_dispatcher->views[view_dispatcher->current] : NULL;
+        if(!view) break;
+        shim.shown = view;
+        furi_shim_settle();
+        if(view->update) shim_draw(view);
+        uint32_t custom_event;
+        if(shim_next_custom_event(view_dispatcher, &custom_event)) {
+            if(view_dispatcher->custom_cb) view_dispatcher->custom_cb(view_dispatcher->event_ctx, custom_event);
+            shim_check_unlocked(view, "custom event");
+            continue;
+        }
+        if(shim_fire_timer()) continue;
+        if(!shim.count) {
+            if(!shim.idle_cb || !shim.idle_cb(shim.idle_ctx) || !shim.count) break;
+        }
+        InputEvent event = shim.queue[shim.head];
+        shim.head = (shim.head + 1) % SHIM_QUEUE;
+        shim.count--;
+        bool consumed = false;
+        if(view->input) {
+            shim.counters.inputs++;
+            uint64_t start = shim_now_ns();
+            consumed = view->input(&event, view->context);
+            uint64_t ns = shim_now_ns() - start;
+            if(ns > shim.counters.input_max_ns) shim.counters.input_max_ns = ns;
+        }
+        shim_check_unlocked(view, "input");
+        if(shim.input_cb) shim.input_cb(&event, view->model, consumed, shim.input_ctx);
+    }
+    view_dispatcher->running = false;
+    shim.shown = NULL;
+}
+
+void* furi_shim_view_model(void) {
+    return shim.shown ? shim.shown->model : NULL;
+}
+
+void furi_shim_redraw(void) {
+    if(shim.shown) shim_draw(shim.shown);
+}
+
+void view_dispatcher_stop(ViewDispatcher* view_dispatcher) {
+    view_dispatcher->running = false;
+}
+
+/* storage/storage.h */
+
+bool furi_shim_path(const char* path, char* out, size_t size) {
+    static const char ext[] = "/ext";
+    if(strncmp(path, ext, sizeof(ext) - 1) != 0 || (path[sizeof(ext) - 1] != '/' && path[sizeof(ext) - 1])) {
+        return false;
+    }
+    if(strstr(path, "/../")) return false;
+    int n = snprintf(out, size, "%s%s", shim.storage_root, path + sizeof(ext) - 1);
+    return n > 0 && (size_t)n < size;
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return calloc(1, sizeof(File));
+}
+
+void storage_file_free(File* file) {
+    if(!file) return;
+    if(file->f) storage_file_close(file);
+    free(file);
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    char host[SHIM_PATH_MAX];
+    if(file->f || !furi_shim_path(path, host, sizeof(host))) return false;
+    int flags = access_mode == FSAM_READ_WRITE ? O_RDWR : access_mode == FSAM_WRITE ? O_WRONLY : O_RDONLY;
+    if(open_mode == FSOM_OPEN_ALWAYS) flags |= O_CREAT;
+    if(open_mode == FSOM_OPEN_APPEND) flags |= O_CREAT | O_APPEND;
+    if(open_mode == FSOM_CREATE_NEW) flags |= O_CREAT | O_EXCL;
+    if(open_mode == FSOM_CREATE_ALWAYS) flags |= O_CREAT | O_TRUNC;
+    int fd = open(host, flags, 0644);
+    if(fd < 0) return false;
+    const char* mode = access_mode == FSAM_READ_WRITE ? "r+b" : access_mode == FSAM_WRITE ? "wb" : "rb";
+    if(open_mode == FSOM_OPEN_APPEND) mode = access_mode == FSAM_READ_WRITE ? "a+b" : "ab";
+    file->f = fdopen(fd, mode);
+    if(!file->f) {
+        close(fd);
+        return false;
+    }
+    __atomic_fetch_add(&shim.counters.file_opens, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->f) return false;
+    bool ok = fclose(file->f) == 0;
+    file->f = NULL;
+    return ok;
+}
+
+bool storage_file_is_open(File* file) {
+    return file->f != NULL;
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    if(!file->f) return 0;
+    return fread(buff, 1, bytes_to_read, file->f);
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    if(!file->f) return 0;
+    return fwrite(buff, 1, bytes_to_write, file->f);
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    if(!file->f) return false;
+    return fseek(file->f, (long)offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+uint64_t storage_file_tell(File* file) {
+    if(!file->f) return 0;
+    long pos = ftell(file->f);
+    return pos < 0 ? 0 : (uint64_t)pos;
+}
+
+uint64_t storage_file_size(File* file) {
+    struct stat st;
+    if(!file->f) return 0;
+    fflush(file->f);
+    return fstat(fileno(file->f), &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+bool storage_file_sync(File* file) {
+    if(!file->f) return false;
+    __atomic_fetch_add(&shim.counters.file_syncs, 1, __ATOMIC_RELAXED);
+    if(shim.config.sync_delay_ms) {
+        struct timespec delay = {shim.config.sync_delay_ms / 1000, (long)(shim.config.sync_delay_ms % 1000) * 1000000L};
+        nanosleep(&delay, NULL);
+    }
+    return fflush(file->f) == 0;
+}
+
+bool storage_file_exists(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host[SHIM_PATH_MAX];
+    struct stat st;
+    return furi_shim_path(path, host, sizeof(host)) && stat(host, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host[SHIM_PATH_MAX];
+    if(!furi_shim_path(path, host, sizeof(host))) return false;
+    return mkdir(host, 0755) == 0 || errno == EEXIST;
+}
+
+bool storage_simply_remove(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host[SHIM_PATH_MAX];
+    if(!furi_shim_path(path, host, sizeof(host))) return false;
+    return remove(host) == 0 || errno == ENOENT;
+}
+
+/* notification/notification.h */
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    UNUSED(app);
+    for(const NotificationMessage* const* m = *sequence; *m; m++) {
+        if((*m)->type == NotificationMessageTypeSoundOn) {
+            shim.counters.sounds++;
+            if(shim.config.verbose) fprintf(stderr, "%u [N] sound %.0f Hz\n", furi_get_tick(), (double)(*m)->data.sound.frequency);
+        } else if((*m)->type == NotificationMessageTypeVibro && (*m)->data.vibro.on) {
+            shim.counters.vibros++;
+            if(shim.config.verbose) fprintf(stderr, "%u [N] vibro\n", furi_get_tick());
+        }
+    }
+}
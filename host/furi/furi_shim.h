@@ -0,0 +1,86 @@
+/**
+ * Harness side of the host Furi shim.
+ * The headers in this directory stand in for the firmware's furi.h, gui/, input/, storage/ and
+ * notification/, so blackjack.c builds unmodified for Linux and runs headless: the harness
+ * queues key presses, calls blackjack_app, and sees every frame drawn on the 128x64 canvas.
+ * The view dispatcher runs on the calling thread. FuriThread is a real thread, and may use
+ * storage, records, logging and view_dispatcher_send_custom_event; the rest of the shim is not
+ * thread-safe. Before each event the dispatcher waits until every FuriThread has exited or is
+ * blocked on an empty message queue, so whatever a worker posts lands at the same point in
+ * every run.
+ */
+#pragma once
+
+#include <gui/view_dispatcher.h>
+#include <notification/notification.h>
+#include <storage/storage.h>
+
+typedef struct {
+    uint64_t seed; /* furi_hal_random_get returns its low 32 bits first, then a stream from it */
+    /* Host directory standing in for /ext, created if missing; NULL = a fresh temporary
+     * directory (an empty SD card) that furi_shim_deinit removes */
+    const char* storage_root;
+    bool verbose; /* Print FURI_LOG lines and notifications to stderr */
+    bool skip_draw; /* Never call draw callbacks; frames are counted but not drawn */
+    uint32_t sync_delay_ms; /* Sleep in every storage_file_sync, standing in for a slow SD card */
+} FuriShimConfig;
+
+typedef struct {
+    uint64_t inputs; /* Events delivered to an input callback */
+    uint64_t frames; /* Redraws, including those skip_draw leaves out */
+    uint64_t sounds; /* NotificationMessageTypeSoundOn messages */
+    uint64_t vibros; /* NotificationMessageTypeVibro on messages */
+    uint64_t file_opens; /* Successful storage_file_open calls, from any thread */
+    uint64_t file_syncs; /* storage_file_sync calls, each a flush to the card on device */
+    uint64_t input_max_ns; /* Longest input callback */
+    uint64_t timer_fires; /* FuriTimer callbacks, each run before the next input */
+} FuriShimCounters;
+
+/* Called after each frame with the view's model (locked for the call) and the draw time */
+typedef void (*FuriShimFrameCallback)(const Canvas* canvas, void* model, uint64_t draw_ns, void* context);
+
+/* Called when the input queue is empty; queue more and return true, or false to end the run */
+typedef bool (*FuriShimIdleCallback)(void* context);
+
+/* Called after each event reaches an input callback, with the view's model as the event left it
+ * and what the callback returned; the model is not locked, and may be changed before the next event */
+typedef void (*FuriShimInputCallback)(const InputEvent* event, void* model, bool consumed, void* context);
+
+/* Reset the shim; call before blackjack_app. False if the storage root cannot be created. */
+bool furi_shim_init(const FuriShimConfig* config);
+/* Free the canvas and remove a temporary storage root */
+void furi_shim_deinit(void);
+
+void furi_shim_push_input(InputKey key, InputType type);
+/* Press, Short and Release, as the device sends for a short press */
+void furi_shim_press(InputKey key);
+size_t furi_shim_pending_inputs(void);
+
+void furi_shim_set_frame_callback(FuriShimFrameCallback callback, void* context);
+void furi_shim_set_idle_callback(FuriShimIdleCallback callback, void* context);
+void furi_shim_set_input_callback(FuriShimInputCallback callback, void* context);
+
+const FuriShimCounters* furi_shim_counters(void);
+
+/* For timing draw callbacks from the idle callback: the shown view's model (not locked), and
+ * one redraw of it as the GUI thread would, model locked for the draw; NULL / nothing when no
+ * view dispatcher is running */
+void* furi_shim_view_model(void);
+void furi_shim_redraw(void);
+
+/* Map an /ext/... path into the storage root; false if it does not fit */
+bool furi_shim_path(const char* path, char* out, size_t size);
+
+/* Canvas contents, for the frame callback */
+bool canvas_shim_pixel(const Canvas* canvas, int32_t x, int32_t y);
+/* Binary PBM (P4) or 1-bit PNG of the canvas, black pixels black; false on I/O errors */
+bool canvas_shim_write_pbm(const Canvas* canvas, const char* path);
+bool canvas_shim_write_png(const Canvas* canvas, const char* path);
+
+/* Used by the shim itself */
+/* Wait until no FuriThread is busy (see above) */
+void furi_shim_settle(void);
+Canvas* canvas_shim_alloc(void);
+void canvas_shim_free(Canvas* canvas);
+/* Clear to white, black ink, FontSecondary: the state the GUI hands each draw callback */
+void canvas_shim_reset(Canvas* canvas);
@@ -0,0 +1,8 @@
+/**
+ * Host stand-in for gui/gui.h.
+ */
+#pragma once
+
+#include <gui/canvas.h>
+
+typedef struct Gui Gui;
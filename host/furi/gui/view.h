@@ -0,0 +1,31 @@
+/**
+ * Host stand-in for gui/view.h: a view with a draw callback, an input callback and a model.
+ * A locking model must be released by view_commit_model before it is taken again; the shim
+ * aborts on a nested view_get_model, which on the device would deadlock.
+ */
+#pragma once
+
+#include <gui/canvas.h>
+#include <input/input.h>
+
+typedef struct View View;
+
+typedef enum {
+    ViewModelTypeNone,
+    ViewModelTypeLockFree,
+    ViewModelTypeLocking,
+} ViewModelType;
+
+typedef void (*ViewDrawCallback)(Canvas* canvas, void* model);
+typedef bool (*ViewInputCallback)(InputEvent* event, void* context);
+
+View* view_alloc(void);
+void view_free(View* view);
+void view_set_draw_callback(View* view, ViewDrawCallback callback);
+void view_set_input_callback(View* view, ViewInputCallback callback);
+void view_set_context(View* view, void* context);
+/* Zeroed model of size bytes */
+void view_allocate_model(View* view, ViewModelType type, size_t size);
+void* view_get_model(View* view);
+/* Release the model; update = redraw after the current input is handled */
+void view_commit_model(View* view, bool update);
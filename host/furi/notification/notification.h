@@ -0,0 +1,35 @@
+/**
+ * Host stand-in for notification/notification.h. Messages are counted, not played.
+ */
+#pragma once
+
+#include <furi.h>
+
+typedef struct NotificationApp NotificationApp;
+
+typedef enum {
+    NotificationMessageTypeVibro,
+    NotificationMessageTypeSoundOn,
+    NotificationMessageTypeSoundOff,
+    NotificationMessageTypeDelay,
+} NotificationMessageType;
+
+typedef struct {
+    NotificationMessageType type;
+    union {
+        struct {
+            bool on;
+        } vibro;
+        struct {
+            float frequency;
+            float volume;
+        } sound;
+        struct {
+            uint32_t length;
+        } delay;
+    } data;
+} NotificationMessage;
+
+typedef const NotificationMessage* NotificationSequence[];
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence);
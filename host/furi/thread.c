@@ -0,0 +1,223 @@
+/**
+ * FuriThread, FuriMessageQueue and FuriMutex for the host shim, on pthreads (see furi.h).
+ * A started thread counts as busy until it exits, except while it blocks in
+ * furi_message_queue_get on an empty queue; furi_shim_settle waits for none to be busy.
+ */
+#include "furi_shim.h"
+#include <furi.h>
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+struct FuriThread {
+    pthread_t thread;
+    FuriThreadCallback callback;
+    void* context;
+    int32_t return_code;
+    bool started;
+};
+
+struct FuriMessageQueue {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint32_t msg_count, msg_size;
+    uint32_t head, count;
+    uint32_t getters; /* Threads blocked in get on an empty queue */
+    uint32_t idle; /* Of those, how many are not counted busy: a put hands one back its count */
+    uint8_t* buf;
+};
+
+struct FuriMutex {
+    pthread_mutex_t lock;
+};
+
+static pthread_mutex_t settle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t settled = PTHREAD_COND_INITIALIZER;
+static uint32_t busy_threads;
+
+static void busy_add(int delta) {
+    pthread_mutex_lock(&settle_lock);
+    busy_threads += delta;
+    if(!busy_threads) pthread_cond_broadcast(&settled);
+    pthread_mutex_unlock(&settle_lock);
+}
+
+void furi_shim_settle(void) {
+    pthread_mutex_lock(&settle_lock);
+    while(busy_threads) pthread_cond_wait(&settled, &settle_lock);
+    pthread_mutex_unlock(&settle_lock);
+}
+
+static void* thread_main(void* arg) {
+    FuriThread* thread = arg;
+    thread->return_code = thread->callback(thread->context);
+    busy_add(-1);
+    return NULL;
+}
+
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context) {
+    UNUSED(name);
+    UNUSED(stack_size);
+    FuriThread* thread = calloc(1, sizeof(FuriThread));
+    if(!thread) abort();
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
+
+void furi_thread_start(FuriThread* thread) {
+    busy_add(1); /* Before it runs, so a settle right after the start waits for it */
+    if(pthread_create(&thread->thread, NULL, thread_main, thread) != 0) abort();
+    thread->started = true;
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    if(thread->started) pthread_join(thread->thread, NULL);
+    thread->started = false;
+    return true;
+}
+
+int32_t furi_thread_get_return_code(FuriThread* thread) {
+    return thread->return_code;
+}
+
+/* Absolute CLOCK_REALTIME deadline timeout ticks from now, for pthread_cond_timedwait */
+static struct timespec deadline(uint32_t timeout) {
+    struct timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    t.tv_sec += timeout / 1000;
+    t.tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if(t.tv_nsec >= 1000000000L) {
+        t.tv_sec++;
+        t.tv_nsec -= 1000000000L;
+    }
+    return t;
+}
+
+/* With the lock held, wait for a free slot (want_space) or a message, up to the timeout.
+ * A getter stops counting as busy while the queue is empty. */
+static bool queue_wait(FuriMessageQueue* q, pthread_cond_t* cond, bool want_space, uint32_t timeout) {
+    struct timespec until = deadline(timeout == FuriWaitForever ? 0 : timeout);
+    bool getter = false;
+    bool ok = true;
+    while(want_space ? q->count == q->msg_count : q->count == 0) {
+        if(timeout == 0) return false;
+        if(!want_space) {
+            if(!getter) q->getters++;
+            getter = true;
+            /* Also after a wakeup whose message another getter took */
+            if(q->idle < q->getters) {
+                q->idle++;
+                busy_add(-1);
+            }
+        }
+        if(timeout == FuriWaitForever) {
+            pthread_cond_wait(cond, &q->lock);
+        } else if(pthread_cond_timedwait(cond, &q->lock, &until) == ETIMEDOUT) {
+            ok = false;
+            break;
+        }
+    }
+    if(getter) {
+        q->getters--;
+        if(q->idle > q->getters) {
+            q->idle--;
+            busy_add(1);
+        }
+    }
+    return ok;
+}
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* q = calloc(1, sizeof(FuriMessageQueue));
+    if(!q) abort();
+    q->buf = calloc(msg_count, msg_size);
+    if(!q->buf) abort();
+    q->msg_count = msg_count;
+    q->msg_size = msg_size;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+    return q;
+}
+
+void furi_message_queue_free(FuriMessageQueue* queue) {
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue->buf);
+    free(queue);
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* queue, const void* msg, uint32_t timeout) {
+    pthread_mutex_lock(&queue->lock);
+    if(!queue_wait(queue, &queue->not_full, true, timeout)) {
+        pthread_mutex_unlock(&queue->lock);
+        return timeout ? FuriStatusErrorTimeout : FuriStatusErrorResource;
+    }
+    uint32_t tail = (queue->head + queue->count) % queue->msg_count;
+    memcpy(queue->buf + (size_t)tail * queue->msg_size, msg, queue->msg_size);
+    queue->count++;
+    /* The woken getter is busy from now, not from when it gets to run */
+    if(queue->idle) {
+        queue->idle--;
+        busy_add(1);
+    }
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return FuriStatusOk;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* queue, void* msg, uint32_t timeout) {
+    pthread_mutex_lock(&queue->lock);
+    if(!queue_wait(queue, &queue->not_empty, false, timeout)) {
+        pthread_mutex_unlock(&queue->lock);
+        return timeout ? FuriStatusErrorTimeout : FuriStatusErrorResource;
+    }
+    memcpy(msg, queue->buf + (size_t)queue->head * queue->msg_size, queue->msg_size);
+    queue->head = (queue->head + 1) % queue->msg_count;
+    queue->count--;
+    pthread_cond_signal(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+    return FuriStatusOk;
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue) {
+    pthread_mutex_lock(&queue->lock);
+    uint32_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* mutex = calloc(1, sizeof(FuriMutex));
+    if(!mutex) abort();
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    if(type == FuriMutexTypeRecursive) pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return mutex;
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    pthread_mutex_destroy(&mutex->lock);
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    if(timeout == FuriWaitForever) return pthread_mutex_lock(&mutex->lock) == 0 ? FuriStatusOk : FuriStatusError;
+    struct timespec until = deadline(timeout);
+    int err = timeout ? pthread_mutex_timedlock(&mutex->lock, &until) : pthread_mutex_trylock(&mutex->lock);
+    return err == 0 ? FuriStatusOk : timeout ? FuriStatusErrorTimeout : FuriStatusErrorResource;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    return pthread_mutex_unlock(&mutex->lock) == 0 ? FuriStatusOk : FuriStatusError;
+}
@@ -0,0 +1,405 @@
+/**
+ * PNG reader (see png.h): chunk parsing, a small inflate after the zlib reference "puff",
+ * the five scanline filters and a 1-bit threshold. No interlacing, no gamma.
+ */
+#include "png.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PNG_MAX_SIDE 4096
+
+typedef struct {
+    const uint8_t* in;
+    size_t in_len;
+    size_t pos;
+    uint32_t bits;
+    int nbits;
+    uint8_t* out;
+    size_t out_len;
+    size_t out_cap;
+    bool error;
+} Inflate;
+
+/* Canonical Huffman code: codes per length, then symbols ordered by code */
+typedef struct {
+    uint16_t count[16];
+    uint16_t symbol[288];
+} Huffman;
+
+static const uint16_t len_base[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t len_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t dist_base[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                       193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static uint32_t get_bits(Inflate* z, int n) {
+    while(z->nbits < n) {
+        if(z->pos >= z->in_len) {
+            z->error = true;
+            return 0;
+        }
+        z->bits |= (uint32_t)z->in[z->pos++] << z->nbits;
+        z->nbits += 8;
+    }
+    uint32_t v = z->bits & ((1u << n) - 1);
+    z->bits >>= n;
+    z->nbits -= n;
+    return v;
+}
+
+static void put_byte(Inflate* z, uint8_t b) {
+    if(z->out_len == z->out_cap) {
+        z->error = true;
+        return;
+    }
+    z->out[z->out_len++] = b;
+}
+
+/* False if the lengths over-subscribe the code space */
+static bool huffman_build(Huffman* h, const uint8_t* lengths, int n) {
+    uint16_t offset[16];
+    memset(h->count, 0, sizeof(h->count));
+    for(int i = 0; i < n; i++) h->count[lengths[i]]++;
+    h->count[0] = 0;
+    int left = 1;
+    for(int len = 1; len < 16; len++) {
+        left = (left << 1) - h->count[len];
+        if(left < 0) return false;
+    }
+    offset[1] = 0;
+    for(int len = 1; len < 15; len++) offset[len + 1] = offset[len] + h->count[len];
+    for(int i = 0; i < n; i++) {
+        if(lengths[i]) h->symbol[offset[lengths[i]]++] = (uint16_t)i;
+    }
+    return true;
+}
+
+static int huffman_decode(Inflate* z, const Huffman* h) {
+    int code = 0, first = 0, index = 0;
+    for(int len = 1; len < 16; len++) {
+        code |= (int)get_bits(z, 1);
+        int count = h->count[len];
+        if(code - count < first) return h->symbol[index + (code - first)];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    z->error = true;
+    return -1;
+}
+
+static void inflate_codes(Inflate* z, const Huffman* lit, const Huffman* dist) {
+    while(!z->error) {
+        int sym = huffman_decode(z, lit);
+        if(sym < 0 || sym == 256) return;
+        if(sym < 256) {
+            put_byte(z, (uint8_t)sym);
+            continue;
+        }
+        sym -= 257;
+        if(sym >= 29) {
+            z->error = true;
+            return;
+        }
+        size_t len = len_base[sym] + get_bits(z, len_extra[sym]);
+        int d = huffman_decode(z, dist);
+        if(d < 0 || d >= 30) {
+            z->error = true;
+            return;
+        }
+        size_t back = dist_base[d] + get_bits(z, dist_extra[d]);
+        if(back > z->out_len) {
+            z->error = true;
+            return;
+        }
+        while(len-- && !z->error) put_byte(z, z->out[z->out_len - back]);
+    }
+}
+
+static void inflate_stored(Inflate* z) {
+    z->bits = 0;
+    z->nbits = 0;
+    if(z->pos + 4 > z->in_len) {
+        z->error = true;
+        return;
+    }
+    size_t len = z->in[z->pos] | (size_t)z->in[z->pos + 1] << 8;
+    size_t nlen = z->in[z->pos + 2] | (size_t)z->in[z->pos + 3] << 8;
+    z->pos += 4;
+    if(len != (~nlen & 0xFFFF) || z->pos + len > z->in_len) {
+        z->error = true;
+        return;
+    }
+    while(len-- && !z->error) put_byte(z, z->in[z->pos++]);
+}
+
+static void inflate_fixed(Inflate* z) {
+    uint8_t lengths[288];
+    Huffman lit, dist;
+    for(int i = 0; i < 288; i++) lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+    huffman_build(&lit, lengths, 288);
+    memset(lengths, 5, 30);
+    huffman_build(&dist, lengths, 30);
+    inflate_codes(z, &lit, &dist);
+}
+
+static void inflate_dynamic(Inflate* z) {
+    static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    uint8_t lengths[320];
+    Huffman lit, dist;
+    int nlit = (int)get_bits(z, 5) + 257;
+    int ndist = (int)get_bits(z, 5) + 1;
+    int ncode = (int)get_bits(z, 4) + 4;
+    if(nlit > 286 || ndist > 30) {
+        z->error = true;
+        return;
+    }
+    memset(lengths, 0, sizeof(lengths));
+    for(int i = 0; i < ncode; i++) lengths[order[i]] = (uint8_t)get_bits(z, 3);
+    if(!huffman_build(&lit, lengths, 19)) {
+        z->error = true;
+        return;
+    }
+    for(int i = 0; i < nlit + ndist && !z->error;) {
+        int sym = huffman_decode(z, &lit);
+        if(sym < 0) return;
+        if(sym < 16) {
+            lengths[i++] = (uint8_t)sym;
+            continue;
+        }
+        uint8_t repeat_len = 0;
+        int repeat;
+        if(sym == 16) {
+            if(i == 0) {
+                z->error = true;
+                return;
+            }
+            repeat_len = lengths[i - 1];
+            repeat = 3 + (int)get_bits(z, 2);
+        } else if(sym == 17) {
+            repeat = 3 + (int)get_bits(z, 3);
+        } else {
+            repeat = 11 + (int)get_bits(z, 7);
+        }
+        if(i + repeat > nlit + ndist) {
+            z->error = true;
+            return;
+        }
+        while(repeat--) lengths[i++] = repeat_len;
+    }
+    if(z->error || !huffman_build(&lit, lengths, nlit) || !huffman_build(&dist, lengths + nlit, ndist)) {
+        z->error = true;
+        return;
+    }
+    inflate_codes(z, &lit, &dist);
+}
+
+/* zlib stream into a buffer of exactly the expected size */
+static bool zlib_inflate(const uint8_t* in, size_t in_len, uint8_t* out, size_t out_len) {
+    if(in_len < 2 || (in[0] & 0x0F) != 8 || (in[0] << 8 | in[1]) % 31 || (in[1] & 0x20)) return false;
+    Inflate z = {.in = in, .in_len = in_len, .pos = 2, .out = out, .out_cap = out_len};
+    bool last;
+    do {
+        last = get_bits(&z, 1);
+        switch(get_bits(&z, 2)) {
+        case 0:
+            inflate_stored(&z);
+            break;
+        case 1:
+            inflate_fixed(&z);
+            break;
+        case 2:
+            inflate_dynamic(&z);
+            break;
+        default:
+            z.error = true;
+            break;
+        }
+    } while(!last && !z.error);
+    return !z.error && z.out_len == out_len;
+}
+
+static uint32_t be32(const uint8_t* p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+/* Undo the per-row filters in place; raw rows are 1 filter byte + stride */
+static bool unfilter(uint8_t* raw, uint32_t height, size_t stride, size_t bpp) {
+    const uint8_t* prev = NULL;
+    for(uint32_t y = 0; y < height; y++) {
+        uint8_t* row = raw + y * (stride + 1);
+        uint8_t filter = row[0];
+        row++;
+        for(size_t i = 0; i < stride; i++) {
+            uint8_t a = i >= bpp ? row[i - bpp] : 0;
+            uint8_t b = prev ? prev[i] : 0;
+            uint8_t c = prev && i >= bpp ? prev[i - bpp] : 0;
+            switch(filter) {
+            case 0:
+                break;
+            case 1:
+                row[i] += a;
+                break;
+            case 2:
+                row[i] += b;
+                break;
+            case 3:
+                row[i] += (uint8_t)((a + b) / 2);
+                break;
+            case 4:
+                row[i] += paeth(a, b, c);
+                break;
+            default:
+                return false;
+            }
+        }
+        prev = row;
+    }
+    return true;
+}
+
+/* Sample k of a row, scaled to 0..255 */
+static uint8_t sample(const uint8_t* row, size_t k, uint8_t depth) {
+    if(depth == 8) return row[k];
+    if(depth == 16) return row[2 * k];
+    size_t bit = k * depth;
+    unsigned v = (row[bit / 8] >> (8 - depth - bit % 8)) & ((1u << depth) - 1);
+    return (uint8_t)(v * 255 / ((1u << depth) - 1));
+}
+
+static bool fail(char* err, size_t err_len, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(err, err_len, fmt, ap);
+    va_end(ap);
+    return false;
+}
+
+static uint8_t* read_file(const char* path, size_t* len) {
+    FILE* f = fopen(path, "rb");
+    if(!f) return NULL;
+    uint8_t* buf = NULL;
+    if(fseek(f, 0, SEEK_END) == 0) {
+        long size = ftell(f);
+        if(size >= 0 && fseek(f, 0, SEEK_SET) == 0 && (buf = malloc((size_t)size + 1))) {
+            *len = fread(buf, 1, (size_t)size, f);
+        }
+    }
+    fclose(f);
+    return buf;
+}
+
+static bool decode(const uint8_t* file, size_t len, PngImage* out, char* err, size_t err_len) {
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t palette[256][4];
+    uint8_t depth = 0, color = 0;
+    uint32_t width = 0, height = 0;
+    int trns_gray = -1; /* Gray level made transparent by tRNS */
+    size_t idat_len = 0, pos = 8;
+    uint8_t* idat = NULL;
+    memset(palette, 0xFF, sizeof(palette));
+    if(len < 8 || memcmp(file, signature, 8)) return fail(err, err_len, "not a PNG");
+    while(pos + 12 <= len) {
+        uint32_t n = be32(file + pos);
+        const uint8_t* type = file + pos + 4;
+        const uint8_t* data = type + 4;
+        if(n > len - pos - 12) break;
+        if(!memcmp(type, "IHDR", 4) && n >= 13) {
+            width = be32(data);
+            height = be32(data + 4);
+            depth = data[8];
+            color = data[9];
+            if(data[12]) return fail(err, err_len, "interlaced PNGs are not supported");
+        } else if(!memcmp(type, "PLTE", 4)) {
+            for(uint32_t i = 0; i < n / 3 && i < 256; i++) memcpy(palette[i], data + 3 * i, 3);
+        } else if(!memcmp(type, "tRNS", 4)) {
+            if(color == 3) {
+                for(uint32_t i = 0; i < n && i < 256; i++) palette[i][3] = data[i];
+            } else if(color == 0 && n >= 2) {
+                trns_gray = data[0] << 8 | data[1];
+            }
+        } else if(!memcmp(type, "IDAT", 4)) {
+            uint8_t* grown = realloc(idat, idat_len + n);
+            if(!grown) {
+                free(idat);
+                return fail(err, err_len, "out of memory");
+            }
+            idat = grown;
+            memcpy(idat + idat_len, data, n);
+            idat_len += n;
+        } else if(!memcmp(type, "IEND", 4)) {
+            break;
+        }
+        pos += 12 + n;
+    }
+    static const uint8_t channels_of[7] = {1, 0, 3, 1, 2, 0, 4};
+    uint8_t channels = color < 7 ? channels_of[color] : 0;
+    if(!width || !height || width > PNG_MAX_SIDE || height > PNG_MAX_SIDE || !channels ||
+       (depth != 1 && depth != 2 && depth != 4 && depth != 8 && depth != 16) || (color == 3 && depth == 16) ||
+       (color != 0 && color != 3 && depth < 8)) {
+        free(idat);
+        return fail(err, err_len, "unsupported PNG format (color type %u, depth %u)", color, depth);
+    }
+    size_t stride = ((size_t)width * channels * depth + 7) / 8;
+    size_t bpp = (channels * depth + 7) / 8;
+    uint8_t* raw = malloc((stride + 1) * height);
+    out->ink = malloc((size_t)width * height);
+    if(!raw || !out->ink || !zlib_inflate(idat, idat_len, raw, (stride + 1) * height) ||
+       !unfilter(raw, height, stride, bpp)) {
+        free(idat);
+        free(raw);
+        png_free(out);
+        return fail(err, err_len, "corrupt image data");
+    }
+    out->width = width;
+    out->height = height;
+    for(uint32_t y = 0; y < height; y++) {
+        const uint8_t* row = raw + y * (stride + 1) + 1;
+        for(uint32_t x = 0; x < width; x++) {
+            unsigned lum, alpha = 255;
+            if(color == 3) {
+                unsigned i = depth == 8 ? row[x] : (row[x * depth / 8] >> (8 - depth - x * depth % 8)) & ((1u << depth) - 1);
+                lum = (palette[i][0] * 299u + palette[i][1] * 587u + palette[i][2] * 114u) / 1000;
+                alpha = palette[i][3];
+            } else if(color == 0 || color == 4) {
+                lum = sample(row, (size_t)x * channels, depth);
+                if(color == 4) alpha = sample(row, (size_t)x * channels + 1, depth);
+                if(color == 0 && trns_gray >= 0 && depth <= 8) {
+                    unsigned level = depth == 8 ? row[x] : lum * ((1u << depth) - 1) / 255;
+                    if((int)level == trns_gray) alpha = 0;
+                }
+            } else {
+                size_t k = (size_t)x * channels;
+                lum = (sample(row, k, depth) * 299u + sample(row, k + 1, depth) * 587u + sample(row, k + 2, depth) * 114u) / 1000;
+                if(color == 6) alpha = sample(row, k + 3, depth);
+            }
+            out->ink[(size_t)y * width + x] = alpha >= 128 && lum < 128;
+        }
+    }
+    free(idat);
+    free(raw);
+    return true;
+}
+
+bool png_read(const char* path, PngImage* out, char* err, size_t err_len) {
+    size_t len = 0;
+    memset(out, 0, sizeof(*out));
+    uint8_t* file = read_file(path, &len);
+    if(!file) return fail(err, err_len, "cannot read");
+    bool ok = decode(file, len, out, err, err_len);
+    free(file);
+    return ok;
+}
+
+void png_free(PngImage* image) {
+    free(image->ink);
+    image->ink = NULL;
+}
@@ -0,0 +1,20 @@
+/**
+ * Minimal PNG reader for the host tools: any non-interlaced PNG (gray, RGB, palette, with or
+ * without alpha, 1-16 bits) thresholded to 1 bit, as the Flipper screen shows it.
+ * Dark, opaque pixels are ink; light or transparent ones are not.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint8_t* ink; /* width * height, row-major, 1 = black */
+} PngImage;
+
+/* False with a reason in err on I/O errors, bad data or an unsupported format */
+bool png_read(const char* path, PngImage* out, char* err, size_t err_len);
+void png_free(PngImage* image);
@@ -0,0 +1,108 @@
+/**
+ * Work-stealing thread pool (see pool.h).
+ * Tasks are plain indices, so a deque is just a [lo, hi) range: the owner pops from lo,
+ * thieves take [mid, hi). Tasks are coarse (a shoe of hands), so a mutex per range is cheap.
+ */
+#include "pool.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct {
+    pthread_mutex_t lock;
+    uint64_t lo;
+    uint64_t hi;
+} __attribute__((aligned(64))) PoolRange;
+
+typedef struct {
+    PoolRange* ranges;
+    unsigned threads;
+    PoolTaskFn fn;
+    void* const* contexts;
+} Pool;
+
+typedef struct {
+    Pool* pool;
+    unsigned self;
+} PoolWorker;
+
+static bool pool_take_own(PoolRange* r, uint64_t* task) {
+    bool ok = false;
+    pthread_mutex_lock(&r->lock);
+    if(r->lo < r->hi) {
+        *task = r->lo++;
+        ok = true;
+    }
+    pthread_mutex_unlock(&r->lock);
+    return ok;
+}
+
+/* Steal the upper half of the first non-empty victim; run its first task now, keep the rest */
+static bool pool_steal(Pool* pool, unsigned self, uint64_t* task) {
+    for(unsigned k = 1; k < pool->threads; k++) {
+        PoolRange* victim = &pool->ranges[(self + k) % pool->threads];
+        uint64_t lo = 0, hi = 0;
+        pthread_mutex_lock(&victim->lock);
+        if(victim->lo < victim->hi) {
+            uint64_t mid = victim->lo + (victim->hi - victim->lo) / 2;
+            lo = mid;
+            hi = victim->hi;
+            victim->hi = mid;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if(lo < hi) {
+            PoolRange* own = &pool->ranges[self];
+            pthread_mutex_lock(&own->lock);
+            own->lo = lo + 1;
+            own->hi = hi;
+            pthread_mutex_unlock(&own->lock);
+            *task = lo;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void* pool_worker(void* arg) {
+    PoolWorker* w = arg;
+    Pool* pool = w->pool;
+    void* ctx = pool->contexts[w->self];
+    uint64_t task;
+    for(;;) {
+        if(pool_take_own(&pool->ranges[w->self], &task) || pool_steal(pool, w->self, &task)) {
+            pool->fn(ctx, task);
+        } else {
+            break; /* every range was empty: remaining work is already owned by running workers */
+        }
+    }
+    return NULL;
+}
+
+void pool_run(uint64_t task_count, unsigned threads, PoolTaskFn fn, void* const* contexts) {
+    if(threads == 0) threads = 1;
+    Pool pool = {.threads = threads, .fn = fn, .contexts = contexts};
+    pool.ranges = aligned_alloc(64, sizeof(PoolRange) * threads);
+    PoolWorker* workers = calloc(threads, sizeof(PoolWorker));
+    pthread_t* tids = calloc(threads, sizeof(pthread_t));
+    for(unsigned i = 0; i < threads; i++) {
+        pthread_mutex_init(&pool.ranges[i].lock, NULL);
+        pool.ranges[i].lo = task_count * i / threads;
+        pool.ranges[i].hi = task_count * (i + 1) / threads;
+        workers[i].pool = &pool;
+        workers[i].self = i;
+    }
+    /* Worker 0 runs on the calling thread */
+    for(unsigned i = 1; i < threads; i++) {
+        pthread_create(&tids[i], NULL, pool_worker, &workers[i]);
+    }
+    pool_worker(&workers[0]);
+    for(unsigned i = 1; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    for(unsigned i = 0; i < threads; i++) {
+        pthread_mutex_destroy(&pool.ranges[i].lock);
+    }
+    free(tids);
+    free(workers);
+    free(pool.ranges);
+}
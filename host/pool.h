@@ -0,0 +1,14 @@
+/**
+ * Work-stealing thread pool over an index range of tasks.
+ * Each worker owns a contiguous slice of [0, task_count); an idle worker steals
+ * the upper half of a busy worker's remaining slice.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/* Run one task; ctx is the calling worker's private context */
+typedef void (*PoolTaskFn)(void* ctx, uint64_t task);
+
+/* Run every task in [0, task_count) exactly once on `threads` workers; worker i receives contexts[i] */
+void pool_run(uint64_t task_count, unsigned threads, PoolTaskFn fn, void* const* contexts);
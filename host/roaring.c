@@ -0,0 +1,288 @@
+/**
+ * Roaring-style compressed bitmaps (see roaring.h).
+ */
+#include "roaring.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Arrays are allocated to the power of two at or above their cardinality, so a set read back
+ * from a file can be appended to without remembering its capacity */
+static uint32_t array_capacity(uint32_t card) {
+    uint32_t capacity = 4;
+    while(capacity < card) capacity <<= 1;
+    return capacity;
+}
+
+static void container_free(RoaringContainer* c) {
+    free(c->array);
+    free(c->bitmap);
+}
+
+static RoaringContainer* roaring_push(Roaring* r, uint16_t key) {
+    if(r->count == r->capacity) {
+        r->capacity = r->capacity ? r->capacity * 2 : 4;
+        r->c = realloc(r->c, r->capacity * sizeof(RoaringContainer));
+    }
+    RoaringContainer* c = &r->c[r->count++];
+    memset(c, 0, sizeof(*c));
+    c->key = key;
+    return c;
+}
+
+static bool container_contains(const RoaringContainer* c, uint16_t low) {
+    if(c->bitmap) return (c->bitmap[low >> 6] >> (low & 63)) & 1;
+    uint32_t lo = 0, hi = c->card;
+    while(lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if(c->array[mid] < low) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < c->card && c->array[lo] == low;
+}
+
+static void container_words(const RoaringContainer* c, uint64_t* words) {
+    if(c->bitmap) {
+        memcpy(words, c->bitmap, ROARING_WORDS * sizeof(uint64_t));
+        return;
+    }
+    memset(words, 0, ROARING_WORDS * sizeof(uint64_t));
+    for(uint32_t i = 0; i < c->card; i++) words[c->array[i] >> 6] |= 1ULL << (c->array[i] & 63);
+}
+
+/* Append the set bits of words as a container, in whichever form suits its cardinality */
+static void roaring_push_words(Roaring* r, uint16_t key, const uint64_t* words) {
+    uint32_t card = 0;
+    for(int i = 0; i < ROARING_WORDS; i++) card += (uint32_t)__builtin_popcountll(words[i]);
+    if(!card) return;
+    RoaringContainer* c = roaring_push(r, key);
+    c->card = card;
+    if(card > ROARING_ARRAY_MAX) {
+        c->bitmap = malloc(ROARING_WORDS * sizeof(uint64_t));
+        memcpy(c->bitmap, words, ROARING_WORDS * sizeof(uint64_t));
+        return;
+    }
+    c->array = malloc(array_capacity(card) * sizeof(uint16_t));
+    uint32_t n = 0;
+    for(int i = 0; i < ROARING_WORDS; i++) {
+        for(uint64_t w = words[i]; w; w &= w - 1) c->array[n++] = (uint16_t)(i * 64 + __builtin_ctzll(w));
+    }
+}
+
+/* Array a filtered by membership in b (keep = true) or absence from it */
+static void roaring_push_filtered(Roaring* r, const RoaringContainer* a, const RoaringContainer* b, bool keep) {
+    uint16_t* out = malloc(array_capacity(a->card) * sizeof(uint16_t));
+    uint32_t n = 0;
+    for(uint32_t i = 0; i < a->card; i++) {
+        if(container_contains(b, a->array[i]) == keep) out[n++] = a->array[i];
+    }
+    if(!n) {
+        free(out);
+        return;
+    }
+    RoaringContainer* c = roaring_push(r, a->key);
+    c->card = n;
+    c->array = out;
+}
+
+static void roaring_push_copy(Roaring* r, const RoaringContainer* a) {
+    RoaringContainer* c = roaring_push(r, a->key);
+    c->card = a->card;
+    if(a->bitmap) {
+        c->bitmap = malloc(ROARING_WORDS * sizeof(uint64_t));
+        memcpy(c->bitmap, a->bitmap, ROARING_WORDS * sizeof(uint64_t));
+    } else {
+        c->array = malloc(array_capacity(a->card) * sizeof(uint16_t));
+        memcpy(c->array, a->array, a->card * sizeof(uint16_t));
+    }
+}
+
+void roaring_init(Roaring* r) {
+    memset(r, 0, sizeof(*r));
+}
+
+void roaring_free(Roaring* r) {
+    for(uint32_t i = 0; i < r->count; i++) container_free(&r->c[i]);
+    free(r->c);
+    roaring_init(r);
+}
+
+void roaring_append(Roaring* r, uint32_t id) {
+    uint16_t key = (uint16_t)(id >> 16), low = (uint16_t)id;
+    RoaringContainer* c = r->count ? &r->c[r->count - 1] : NULL;
+    if(!c || c->key != key) c = roaring_push(r, key);
+    if(c->bitmap) {
+        c->bitmap[low >> 6] |= 1ULL << (low & 63);
+        c->card++;
+        return;
+    }
+    if(c->card == ROARING_ARRAY_MAX) {
+        /* Full array: switch to a bitmap */
+        uint64_t* words = calloc(ROARING_WORDS, sizeof(uint64_t));
+        for(uint32_t i = 0; i < c->card; i++) words[c->array[i] >> 6] |= 1ULL << (c->array[i] & 63);
+        words[low >> 6] |= 1ULL << (low & 63);
+        free(c->array);
+        c->array = NULL;
+        c->bitmap = words;
+        c->card++;
+        return;
+    }
+    if(c->card == 0 || c->card == array_capacity(c->card)) {
+        c->array = realloc(c->array, array_capacity(c->card + 1) * sizeof(uint16_t));
+    }
+    c->array[c->card++] = low;
+}
+
+void roaring_range(Roaring* r, uint32_t n) {
+    roaring_init(r);
+    uint64_t* words = malloc(ROARING_WORDS * sizeof(uint64_t));
+    for(uint64_t base = 0; base < n; base += 65536) {
+        uint32_t bits = n - base < 65536 ? (uint32_t)(n - base) : 65536;
+        memset(words, 0, ROARING_WORDS * sizeof(uint64_t));
+        memset(words, 0xFF, bits / 64 * sizeof(uint64_t));
+        if(bits % 64) words[bits / 64] = (1ULL << (bits % 64)) - 1;
+        roaring_push_words(r, (uint16_t)(base >> 16), words);
+    }
+    free(words);
+}
+
+uint64_t roaring_cardinality(const Roaring* r) {
+    uint64_t n = 0;
+    for(uint32_t i = 0; i < r->count; i++) n += r->c[i].card;
+    return n;
+}
+
+size_t roaring_to_array(const Roaring* r, uint32_t* out, size_t max) {
+    size_t n = 0;
+    for(uint32_t i = 0; i < r->count && n < max; i++) {
+        const RoaringContainer* c = &r->c[i];
+        uint32_t high = (uint32_t)c->key << 16;
+        if(c->bitmap) {
+            for(int w = 0; w < ROARING_WORDS && n < max; w++) {
+                for(uint64_t bits = c->bitmap[w]; bits && n < max; bits &= bits - 1) {
+                    out[n++] = high | (uint32_t)(w * 64 + __builtin_ctzll(bits));
+                }
+            }
+        } else {
+            for(uint32_t j = 0; j < c->card && n < max; j++) out[n++] = high | c->array[j];
+        }
+    }
+    return n;
+}
+
+size_t roaring_size(const Roaring* r) {
+    size_t size = r->count * sizeof(RoaringContainer);
+    for(uint32_t i = 0; i < r->count; i++) {
+        size += r->c[i].bitmap ? ROARING_WORDS * sizeof(uint64_t) : r->c[i].card * sizeof(uint16_t);
+    }
+    return size;
+}
+
+void roaring_copy(const Roaring* a, Roaring* out) {
+    roaring_init(out);
+    for(uint32_t i = 0; i < a->count; i++) roaring_push_copy(out, &a->c[i]);
+}
+
+void roaring_and(const Roaring* a, const Roaring* b, Roaring* out) {
+    roaring_init(out);
+    uint64_t words[ROARING_WORDS];
+    uint32_t i = 0, j = 0;
+    while(i < a->count && j < b->count) {
+        const RoaringContainer* ca = &a->c[i];
+        const RoaringContainer* cb = &b->c[j];
+        if(ca->key < cb->key) {
+            i++;
+        } else if(ca->key > cb->key) {
+            j++;
+        } else {
+            if(!ca->bitmap) {
+                roaring_push_filtered(out, ca, cb, true);
+            } else if(!cb->bitmap) {
+                roaring_push_filtered(out, cb, ca, true);
+            } else {
+                for(int w = 0; w < ROARING_WORDS; w++) words[w] = ca->bitmap[w] & cb->bitmap[w];
+                roaring_push_words(out, ca->key, words);
+            }
+            i++;
+            j++;
+        }
+    }
+}
+
+void roaring_or(const Roaring* a, const Roaring* b, Roaring* out) {
+    roaring_init(out);
+    uint64_t wa[ROARING_WORDS], wb[ROARING_WORDS];
+    uint32_t i = 0, j = 0;
+    while(i < a->count || j < b->count) {
+        const RoaringContainer* ca = i < a->count ? &a->c[i] : NULL;
+        const RoaringContainer* cb = j < b->count ? &b->c[j] : NULL;
+        if(!cb || (ca && ca->key < cb->key)) {
+            roaring_push_copy(out, ca);
+            i++;
+        } else if(!ca || cb->key < ca->key) {
+            roaring_push_copy(out, cb);
+            j++;
+        } else {
+            container_words(ca, wa);
+            container_words(cb, wb);
+            for(int w = 0; w < ROARING_WORDS; w++) wa[w] |= wb[w];
+            roaring_push_words(out, ca->key, wa);
+            i++;
+            j++;
+        }
+    }
+}
+
+void roaring_andnot(const Roaring* a, const Roaring* b, Roaring* out) {
+    roaring_init(out);
+    uint64_t wa[ROARING_WORDS], wb[ROARING_WORDS];
+    uint32_t j = 0;
+    for(uint32_t i = 0; i < a->count; i++) {
+        const RoaringContainer* ca = &a->c[i];
+        while(j < b->count && b->c[j].key < ca->key) j++;
+        if(j == b->count || b->c[j].key != ca->key) {
+            roaring_push_copy(out, ca);
+        } else if(!ca->bitmap) {
+            roaring_push_filtered(out, ca, &b->c[j], false);
+        } else {
+            container_words(&b->c[j], wb);
+            for(int w = 0; w < ROARING_WORDS; w++) wa[w] = ca->bitmap[w] & ~wb[w];
+            roaring_push_words(out, ca->key, wa);
+        }
+    }
+}
+
+bool roaring_write(const Roaring* r, FILE* f) {
+    if(fwrite(&r->count, sizeof(r->count), 1, f) != 1) return false;
+    for(uint32_t i = 0; i < r->count; i++) {
+        const RoaringContainer* c = &r->c[i];
+        if(fwrite(&c->key, sizeof(c->key), 1, f) != 1 || fwrite(&c->card, sizeof(c->card), 1, f) != 1) return false;
+        bool ok = c->bitmap ? fwrite(c->bitmap, sizeof(uint64_t), ROARING_WORDS, f) == ROARING_WORDS :
+                              fwrite(c->array, sizeof(uint16_t), c->card, f) == c->card;
+        if(!ok) return false;
+    }
+    return true;
+}
+
+bool roaring_read(Roaring* r, FILE* f) {
+    roaring_init(r);
+    uint32_t count;
+    if(fread(&count, sizeof(count), 1, f) != 1) return false;
+    for(uint32_t i = 0; i < count; i++) {
+        uint16_t key;
+        uint32_t card;
+        if(fread(&key, sizeof(key), 1, f) != 1 || fread(&card, sizeof(card), 1, f) != 1) return false;
+        if(card == 0 || card > 65536 || (r->count && key <= r->c[r->count - 1].key)) return false;
+        RoaringContainer* c = roaring_push(r, key);
+        c->card = card;
+        bool ok;
+        if(card > ROARING_ARRAY_MAX) {
+            c->bitmap = malloc(ROARING_WORDS * sizeof(uint64_t));
+            ok = fread(c->bitmap, sizeof(uint64_t), ROARING_WORDS, f) == ROARING_WORDS;
+        } else {
+            c->array = malloc(array_capacity(card) * sizeof(uint16_t));
+            ok = fread(c->array, sizeof(uint16_t), card, f) == card;
+        }
+        if(!ok) return false;
+    }
+    return true;
+}
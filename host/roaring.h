@@ -0,0 +1,54 @@
+/**
+ * Compressed bitmaps of 32-bit ids, roaring style: ids are grouped by their high 16 bits into
+ * containers, each a sorted array of the low 16 bits while it holds at most
+ * ROARING_ARRAY_MAX of them and a 65536-bit bitmap once it holds more. Sparse sets cost two
+ * bytes an id, dense ones one bit, and set operations work container by container.
+ *
+ * Sets are built by appending ids in increasing order, which is how hand ids arrive.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ROARING_ARRAY_MAX 4096
+#define ROARING_WORDS 1024 /* 64-bit words in a bitmap container */
+
+typedef struct {
+    uint16_t key; /* High 16 bits of every id in the container */
+    uint32_t card; /* 1..65536 */
+    uint16_t* array; /* card <= ROARING_ARRAY_MAX: sorted low bits */
+    uint64_t* bitmap; /* Otherwise: ROARING_WORDS words */
+} RoaringContainer;
+
+typedef struct {
+    RoaringContainer* c; /* By increasing key */
+    uint32_t count;
+    uint32_t capacity;
+} Roaring;
+
+void roaring_init(Roaring* r);
+void roaring_free(Roaring* r);
+/* Add an id larger than every id already in the set */
+void roaring_append(Roaring* r, uint32_t id);
+/* Every id in [0, n) */
+void roaring_range(Roaring* r, uint32_t n);
+
+uint64_t roaring_cardinality(const Roaring* r);
+/* Write up to max ids in increasing order; returns how many */
+size_t roaring_to_array(const Roaring* r, uint32_t* out, size_t max);
+/* Bytes the containers take in memory */
+size_t roaring_size(const Roaring* r);
+
+/* out is initialized here and must not be an input */
+void roaring_copy(const Roaring* a, Roaring* out);
+/* out = a & b, a | b, a & ~b */
+void roaring_and(const Roaring* a, const Roaring* b, Roaring* out);
+void roaring_or(const Roaring* a, const Roaring* b, Roaring* out);
+void roaring_andnot(const Roaring* a, const Roaring* b, Roaring* out);
+
+/* Native byte order; read returns false on a short or malformed set */
+bool roaring_write(const Roaring* r, FILE* f);
+bool roaring_read(Roaring* r, FILE* f);
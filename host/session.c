@@ -0,0 +1,145 @@
+/**
+ * Session recording (see session.h).
+ */
+#include "session.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SESSION_EVENT_BYTES 10
+
+static uint64_t fnv_bytes(uint64_t h, const void* data, size_t len) {
+    const uint8_t* p = data;
+    while(len--) {
+        h ^= *p++;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+static uint64_t fnv_u64(uint64_t h, uint64_t v) {
+    uint8_t b[8];
+    for(int i = 0; i < 8; i++) b[i] = (uint8_t)(v >> (8 * i));
+    return fnv_bytes(h, b, sizeof(b));
+}
+
+static uint64_t fnv_str(uint64_t h, const char* str, size_t max) {
+    size_t len = strnlen(str, max);
+    return fnv_bytes(fnv_u64(h, len), str, len);
+}
+
+static uint64_t fnv_hand(uint64_t h, const uint8_t* hand, uint8_t count) {
+    uint8_t n = count > MAX_HAND ? MAX_HAND : count;
+    return fnv_bytes(fnv_u64(h, count), hand, n);
+}
+
+uint64_t session_state_hash(const BlackjackState* s) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    h = fnv_u64(h, s->rng.kind);
+    for(int i = 0; i < 2; i++) h = fnv_u64(h, i ? s->rng.pcg.inc : s->rng.pcg.state);
+    h = fnv_u64(h, s->rng_seed);
+    h = fnv_u64(h, s->shoe_number);
+    uint8_t deck[DECK_SIZE]; /* Hashed unpacked, as recorded before the shoe was packed */
+    for(int i = 0; i < DECK_SIZE; i++) deck[i] = shoe_card(s, (uint8_t)i);
+    h = fnv_bytes(h, deck, DECK_SIZE);
+    h = fnv_u64(h, s->deck_top);
+    h = fnv_u64(h, s->cut_card);
+    h = fnv_u64(h, s->cut_card_out | s->reshuffle_announced << 1 | s->dealer_hole << 2);
+    h = fnv_hand(h, s->player_hand, s->player_count);
+    h = fnv_hand(h, s->player_hand2, s->player_count2);
+    h = fnv_hand(h, s->dealer_hand, s->dealer_count);
+    h = fnv_u64(h, s->phase);
+    h = fnv_u64(h, s->prev_phase);
+    h = fnv_str(h, s->result_msg, sizeof(s->result_msg));
+    h = fnv_u64(h, s->balance);
+    h = fnv_u64(h, s->current_bet);
+    h = fnv_u64(h, s->bet_hand2);
+    h = fnv_u64(h, s->base_bet);
+    h = fnv_u64(h, s->insurance_bet);
+    h = fnv_u64(
+        h,
+        s->is_blackjack | s->can_double_down << 1 | s->can_split << 2 | s->is_split << 3 | s->is_guest << 4 |
+            s->practice_mode << 5 | s->sound_on << 6 | s->vibro_on << 7 | s->dealer_hits_soft17 << 8 |
+            s->deal_speed << 9);
+    h = fnv_u64(h, s->active_hand);
+    h = fnv_u64(h, s->events);
+    h = fnv_u64(h, s->games_played);
+    h = fnv_u64(h, s->games_won);
+    h = fnv_u64(h, s->games_lost);
+    h = fnv_u64(h, s->games_pushed);
+    h = fnv_u64(h, s->stat_scroll);
+    h = fnv_u64(h, s->help_scroll);
+    h = fnv_u64(h, s->profile_menu_selection);
+    h = fnv_u64(h, s->current_profile_slot);
+    h = fnv_u64(h, s->splash_selection);
+    for(int i = 0; i < MAX_PROFILES; i++) h = fnv_str(h, s->profile_names[i], PROFILE_NAME_LEN);
+    return h;
+}
+
+void session_init(Session* session, uint64_t seed) {
+    memset(session, 0, sizeof(*session));
+    session->seed = seed;
+}
+
+void session_free(Session* session) {
+    free(session->events);
+    memset(session, 0, sizeof(*session));
+}
+
+bool session_append(Session* session, InputKey key, InputType type, uint64_t hash) {
+    if(session->count == session->capacity) {
+        size_t capacity = session->capacity ? session->capacity * 2 : 1024;
+        SessionEvent* events = realloc(session->events, capacity * sizeof(SessionEvent));
+        if(!events) return false;
+        session->events = events;
+        session->capacity = capacity;
+    }
+    SessionEvent* e = &session->events[session->count++];
+    e->key = (uint8_t)key;
+    e->type = (uint8_t)type;
+    e->hash = hash;
+    return true;
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    for(int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for(int i = 7; i >= 0; i--) v = v << 8 | p[i];
+    return v;
+}
+
+bool session_write(const Session* session, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if(!f) return false;
+    uint8_t head[12] = {'B', 'J', 'R', SESSION_VERSION};
+    put_u64(head + 4, session->seed);
+    bool ok = fwrite(head, 1, sizeof(head), f) == sizeof(head);
+    for(size_t i = 0; ok && i < session->count; i++) {
+        uint8_t rec[SESSION_EVENT_BYTES];
+        rec[0] = session->events[i].key;
+        rec[1] = session->events[i].type;
+        put_u64(rec + 2, session->events[i].hash);
+        ok = fwrite(rec, 1, sizeof(rec), f) == sizeof(rec);
+    }
+    return fclose(f) == 0 && ok;
+}
+
+bool session_read(Session* session, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if(!f) return false;
+    uint8_t head[12];
+    bool ok = fread(head, 1, sizeof(head), f) == sizeof(head) && memcmp(head, "BJR", 3) == 0 &&
+              head[3] == SESSION_VERSION;
+    session_init(session, ok ? get_u64(head + 4) : 0);
+    uint8_t rec[SESSION_EVENT_BYTES];
+    size_t n;
+    while(ok && (n = fread(rec, 1, sizeof(rec), f)) > 0) {
+        ok = n == sizeof(rec) && rec[0] < InputKeyMAX && rec[1] < InputTypeMAX &&
+             session_append(session, rec[0], rec[1], get_u64(rec + 2));
+    }
+    fclose(f);
+    if(!ok) session_free(session);
+    return ok;
+}
@@ -0,0 +1,38 @@
+/**
+ * Recorded app sessions for the host harness: the session seed and every InputEvent delivered
+ * to input_callback, each with a hash of the BlackjackState it left behind.
+ *
+ * File layout, little-endian: "BJR" version(1) seed(u64), then per event key(u8) type(u8)
+ * hash(u64). Events run to the end of the file. The hash reads named fields rather than the
+ * struct's bytes, so it is unaffected by padding and by reordering the struct.
+ */
+#pragma once
+
+#include "blackjack_game.h"
+#include <input/input.h>
+#include <stdio.h>
+
+#define SESSION_VERSION 1
+
+typedef struct {
+    uint8_t key; /* InputKey */
+    uint8_t type; /* InputType */
+    uint64_t hash; /* session_state_hash after the event */
+} SessionEvent;
+
+typedef struct {
+    uint64_t seed;
+    size_t count;
+    size_t capacity;
+    SessionEvent* events;
+} Session;
+
+uint64_t session_state_hash(const BlackjackState* s);
+
+void session_init(Session* session, uint64_t seed);
+void session_free(Session* session);
+bool session_append(Session* session, InputKey key, InputType type, uint64_t hash);
+
+/* False on I/O errors, a bad header or a truncated event */
+bool session_write(const Session* session, const char* path);
+bool session_read(Session* session, const char* path);
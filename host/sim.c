@@ -0,0 +1,116 @@
+/**
+ * Shared hand-playing loop for the host tools (see sim.h).
+ */
+#include "sim.h"
+#include "blackjack_strategy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* const sim_strategy_names[SimStrategyCount] = {"basic", "stand", "dealer"};
+
+bool sim_strategy_parse(const char* name, SimStrategy* out) {
+    for(int i = 0; i < SimStrategyCount; i++) {
+        if(strcmp(name, sim_strategy_names[i]) == 0) {
+            *out = (SimStrategy)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool sim_wants_split(const BlackjackState* s, SimStrategy strategy) {
+    if(strategy != SimStrategyBasic) return false;
+    return strategy_lookup(&s->player_totals, 2, s->dealer_hand[1], true, false, true, s->dealer_hits_soft17) ==
+           StrategySplit;
+}
+
+static void sim_player_action(BlackjackState* s, SimStrategy strategy) {
+    const uint8_t* hand = (s->is_split && s->active_hand == 1) ? s->player_hand2 : s->player_hand;
+    uint8_t count = (s->is_split && s->active_hand == 1) ? s->player_count2 : s->player_count;
+    const HandTotals* totals = (s->is_split && s->active_hand == 1) ? &s->player_totals2 : &s->player_totals;
+    switch(strategy) {
+    case SimStrategyStand:
+        game_player_stand(s);
+        return;
+    case SimStrategyDealer:
+        if(hand_totals_value(totals) < 17) game_player_hit(s);
+        else game_player_stand(s);
+        return;
+    case SimStrategyBasic:
+    default: {
+        bool is_pair = (count == 2 && CARD_RANK(hand[0]) == CARD_RANK(hand[1]));
+        StrategyAction action =
+            strategy_lookup(totals, count, s->dealer_hand[1], is_pair, s->can_double_down, s->can_split, s->dealer_hits_soft17);
+        switch(action) {
+        case StrategyDouble:
+            game_player_double_down(s);
+            return;
+        case StrategySplit:
+            game_player_split(s);
+            return;
+        case StrategyHit:
+            game_player_hit(s);
+            return;
+        case StrategyStand:
+        default:
+            game_player_stand(s);
+            return;
+        }
+    }
+    }
+}
+
+int32_t sim_play_hand(BlackjackState* s, SimStrategy strategy, uint16_t bet) {
+    s->balance = SIM_BANKROLL;
+    game_start_betting(s);
+    s->current_bet = bet;
+    game_place_bet(s);
+    while(s->phase != PhaseResult) {
+        switch(s->phase) {
+        case PhaseDeal:
+        case PhaseDealerTurn:
+            game_run(s);
+            break;
+        case PhaseReshuffle:
+            game_continue_deal(s);
+            break;
+        case PhaseInsurancePrompt:
+            resolve_insurance(s, false);
+            break;
+        case PhaseSplitPrompt:
+            if(sim_wants_split(s, strategy)) game_player_split(s);
+            else game_decline_split(s);
+            break;
+        case PhasePlayerTurn:
+            sim_player_action(s, strategy);
+            break;
+        case PhaseShowFinalCards:
+            game_show_result(s);
+            break;
+        default:
+            fprintf(stderr, "sim: unexpected phase %d\n", (int)s->phase);
+            exit(1);
+        }
+    }
+    s->events = 0;
+    return (int32_t)s->balance - SIM_BANKROLL;
+}
+
+void sim_stats_add(SimStats* st, int32_t net) {
+    st->hands++;
+    st->net += net;
+    st->net_sq += (uint64_t)((int64_t)net * net);
+    if(net > 0) st->wins++;
+    else if(net < 0) st->losses++;
+    else st->pushes++;
+}
+
+void sim_stats_merge(SimStats* into, const SimStats* from) {
+    into->hands += from->hands;
+    into->wins += from->wins;
+    into->losses += from->losses;
+    into->pushes += from->pushes;
+    into->net += from->net;
+    into->net_sq += from->net_sq;
+}
@@ -0,0 +1,38 @@
+/**
+ * Shared hand-playing loop for the host tools.
+ * Drives a BlackjackState through the same game_* calls input_callback makes.
+ */
+#pragma once
+
+#include "blackjack_game.h"
+
+/* Bank given to every hand; the 16-bit balance is reset per hand so long runs never overflow it */
+#define SIM_BANKROLL 30000
+
+typedef enum {
+    SimStrategyBasic,  /* strategy_lookup, as shown in Practice mode */
+    SimStrategyStand,  /* never draw */
+    SimStrategyDealer, /* mimic the dealer: hit below 17 */
+    SimStrategyCount,
+} SimStrategy;
+
+/* Integer-only so merging worker results is exact and order-independent */
+typedef struct {
+    uint64_t hands;
+    uint64_t wins;
+    uint64_t losses;
+    uint64_t pushes;
+    int64_t net;     /* dollars won (+) or lost (-) */
+    uint64_t net_sq; /* sum of squared per-hand results in dollars, for the variance */
+} SimStats;
+
+extern const char* const sim_strategy_names[SimStrategyCount];
+
+/* Parse a strategy name; returns false if unknown */
+bool sim_strategy_parse(const char* name, SimStrategy* out);
+
+/* Play one hand from bet to settlement; returns the net result in dollars */
+int32_t sim_play_hand(BlackjackState* s, SimStrategy strategy, uint16_t bet);
+
+void sim_stats_add(SimStats* st, int32_t net);
+void sim_stats_merge(SimStats* into, const SimStats* from);